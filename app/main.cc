@@ -45,17 +45,44 @@ int main(int argc, char **argv)
 
   unsigned int dim = 3;
   unsigned int compositions = 0;
+  const bool profile = find_command_line_option(argv, argv+argc, "--profile");
+  const bool query_hints = find_command_line_option(argv, argv+argc, "--query-hints");
+  const bool write_declarations = find_command_line_option(argv, argv+argc, "--write-declarations");
 
   if (find_command_line_option(argv, argv+argc, "-h") || find_command_line_option(argv, argv+argc, "--help"))
     {
       std::cout << "This program allows to use the world builder library directly with a world builder file and a data file. "
                 "The data file will be filled with intitial conditions from the world as set by the world builder file." << std::endl
                 << "Besides providing two files, where the first is the world builder file and the second is the data file, the available options are: " << std::endl
-                << "-h or --help to get this help screen." << std::endl;
+                << "-h or --help to get this help screen," << std::endl
+                << "--profile to print a table with the number of calls and time spent per feature and model to the error stream," << std::endl
+                << "--query-hints to reuse the results of the previous point for the next one and print the hit rate per feature to the error stream," << std::endl
+                << "--write-declarations followed by only a world builder file to write the declarations of all the parameters as world_buider_declarations.tex "
+                "and world_buider_declarations.schema.json to the directory of the world builder file." << std::endl;
       return 0;
     }
 
-  if (argc == 1)
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i)
+    if (std::string(argv[i]) != "--profile" && std::string(argv[i]) != "--query-hints"
+        && std::string(argv[i]) != "--write-declarations")
+      files.push_back(argv[i]);
+
+  if (write_declarations)
+    {
+      if (files.size() != 1)
+        {
+          std::cout << "Error: --write-declarations requires exactly one world builder file." << std::endl;
+          return 1;
+        }
+
+      std::string output_dir = files[0].substr(0,files[0].find_last_of("/\\") + 1);
+      WorldBuilder::World world(files[0], true, output_dir);
+      std::cout << "The declarations have been written to world_buider_declarations.tex and world_buider_declarations.schema.json." << std::endl;
+      return 0;
+    }
+
+  if (files.size() == 0)
     {
       std::cout << "Error: There where no files passed to the World Builder, use --help for more " << std::endl
                 << "information on how  to use the World Builder app." << std::endl;
@@ -63,21 +90,21 @@ int main(int argc, char **argv)
     }
 
 
-  if (argc == 2)
+  if (files.size() == 1)
     {
       std::cout << "Error:  The World Builder app requires at least two files, a World Builder file " << std::endl
                 << "and a data file to convert." << std::endl;
       return 0;
     }
 
-  if (argc != 3)
+  if (files.size() != 2)
     {
       std::cout << "Only two command line arguments may be given, which should be the world builder file location and the data file location (in that order). " << std::endl;
       return 0;
     }
 
-  wb_file = argv[1];
-  data_file = argv[2];
+  wb_file = files[0];
+  data_file = files[1];
 
   /**
    * Try to start the world builder
@@ -85,8 +112,9 @@ int main(int argc, char **argv)
   std::unique_ptr<WorldBuilder::World> world;
   //try
   {
-    std::string output_dir = wb_file.substr(0,wb_file.find_last_of("/\\") + 1);
-    world = std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file, true, output_dir));
+    world = std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file));
+    world->profiler.set_enabled(profile);
+    world->query_hints.set_enabled(query_hints);
   }
   /*catch (std::exception &e)
     {
@@ -211,5 +239,11 @@ int main(int argc, char **argv)
         return 0;
     }
 
+  if (profile)
+    std::cerr << world->performance_report();
+
+  if (query_hints)
+    std::cerr << world->query_hints.report();
+
   return 0;
 }
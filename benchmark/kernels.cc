@@ -0,0 +1,663 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * This program times the geometric kernels of the World Builder in
+ * isolation, on synthetic inputs whose size and shape are set by a few
+ * parameters. For every kernel and parameter combination it reports the
+ * mean time per call in nanoseconds, together with the standard deviation
+ * and minimum over a number of samples, as JSON. For the distance field it
+ * also reports the error of the interpolated distances compared with the
+ * exact ones.
+ */
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <world_builder/centerline_table.h>
+#include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/coordinate_systems/spherical.h>
+#include <world_builder/distance_field.h>
+#include <world_builder/point.h>
+#include <world_builder/segment_table.h>
+#include <world_builder/spatial_order.h>
+#include <world_builder/utilities.h>
+
+#include <benchmark/main.h>
+#include <benchmark/random.h>
+
+using namespace WorldBuilder;
+using Benchmark::Random;
+
+namespace
+{
+  /**
+   * The number of different inputs each kernel cycles through. It is a power
+   * of two, so that the index can be computed with a mask.
+   */
+  const size_t n_inputs = 1024;
+
+  /**
+   * Collects the timings of the kernels and writes them as JSON.
+   */
+  class Timer
+  {
+    public:
+      Timer(rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer_,
+            const unsigned int n_samples_,
+            const double min_sample_time_,
+            const std::string &filter_)
+        :
+        writer(writer_),
+        n_samples(n_samples_),
+        min_sample_time(min_sample_time_),
+        filter(filter_),
+        sink(0)
+      {}
+
+      /**
+       * Time the kernel, which is called with the index of the input to use
+       * and returns a value which depends on the result of the kernel, to
+       * prevent the compiler from optimizing the call away. The parameters
+       * are a list of name and value pairs describing the input.
+       */
+      template<class Kernel>
+      void
+      run(const std::string &name,
+          const std::vector<std::pair<std::string,std::string> > &parameters,
+          const Kernel &kernel)
+      {
+        std::string label = name;
+        for (auto &parameter : parameters)
+          label += " " + parameter.first + "=" + parameter.second;
+        if (!filter.empty() && label.find(filter) == std::string::npos)
+          return;
+
+        // Find the number of calls per sample needed to reach the minimum
+        // sample time.
+        size_t n_calls = 16;
+        while (time_calls(kernel, n_calls) < min_sample_time && n_calls < (static_cast<size_t>(1) << 40))
+          n_calls *= 2;
+
+        std::vector<double> samples(std::max(n_samples, 1u));
+        for (auto &sample : samples)
+          sample = 1e9 * time_calls(kernel, n_calls) / static_cast<double>(n_calls);
+
+        double mean = 0;
+        for (auto &sample : samples)
+          mean += sample;
+        mean /= static_cast<double>(samples.size());
+
+        double variance = 0;
+        for (auto &sample : samples)
+          variance += (sample - mean) * (sample - mean);
+        variance /= static_cast<double>(samples.size() > 1 ? samples.size() - 1 : 1);
+
+        writer.StartObject();
+        writer.Key("kernel");
+        writer.String(name.c_str());
+        for (auto &parameter : parameters)
+          {
+            writer.Key(parameter.first.c_str());
+            writer.String(parameter.second.c_str());
+          }
+        writer.Key("calls per sample");
+        writer.Uint64(n_calls);
+        writer.Key("ns per call");
+        writer.Double(mean);
+        writer.Key("ns per call standard deviation");
+        writer.Double(std::sqrt(variance));
+        writer.Key("ns per call minimum");
+        writer.Double(*std::min_element(samples.begin(), samples.end()));
+        writer.EndObject();
+
+        std::cerr << label << ": " << mean << " +- " << std::sqrt(variance) << " ns per call" << std::endl;
+      }
+
+      /**
+       * Write a report with the given values, unless it is filtered out. The
+       * parameters are a list of name and value pairs describing the input.
+       */
+      void
+      report(const std::string &name,
+             const std::vector<std::pair<std::string,std::string> > &parameters,
+             const std::vector<std::pair<std::string,double> > &values)
+      {
+        std::string label = name;
+        for (auto &parameter : parameters)
+          label += " " + parameter.first + "=" + parameter.second;
+        if (!filter.empty() && label.find(filter) == std::string::npos)
+          return;
+
+        writer.StartObject();
+        writer.Key("report");
+        writer.String(name.c_str());
+        for (auto &parameter : parameters)
+          {
+            writer.Key(parameter.first.c_str());
+            writer.String(parameter.second.c_str());
+          }
+        std::cerr << label << ":";
+        for (auto &value : values)
+          {
+            writer.Key(value.first.c_str());
+            writer.Double(value.second);
+            std::cerr << " " << value.first << "=" << value.second;
+          }
+        writer.EndObject();
+        std::cerr << std::endl;
+      }
+
+      /**
+       * The accumulated results of all kernel calls. Printing it makes sure
+       * that none of the calls can be optimized away.
+       */
+      double get_sink() const
+      {
+        return sink;
+      }
+
+    private:
+      template<class Kernel>
+      double
+      time_calls(const Kernel &kernel, const size_t n_calls)
+      {
+        double local_sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n_calls; ++i)
+          local_sink += kernel(i & (n_inputs - 1));
+        const auto end = std::chrono::steady_clock::now();
+        sink += local_sink;
+        return std::chrono::duration<double>(end - start).count();
+      }
+
+      rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer;
+      const unsigned int n_samples;
+      const double min_sample_time;
+      const std::string filter;
+      double sink;
+  };
+
+  /**
+   * A star shaped polygon with n_vertices vertices around the center, with
+   * a random radius between 0.5 and 1 times the given radius for every vertex.
+   */
+  std::vector<Point<2> >
+  create_polygon(const size_t n_vertices, const Point<2> &center, const double radius, Random &random)
+  {
+    std::vector<Point<2> > polygon;
+    for (size_t i = 0; i < n_vertices; ++i)
+      {
+        const double angle = 2 * Utilities::const_pi * static_cast<double>(i) / static_cast<double>(n_vertices);
+        const double vertex_radius = random.uniform(0.5, 1.0) * radius;
+        polygon.push_back(Point<2>(center[0] + vertex_radius * std::cos(angle),
+                                   center[1] + vertex_radius * std::sin(angle),
+                                   center.get_coordinate_system()));
+      }
+    return polygon;
+  }
+
+  void
+  benchmark_polygon_contains_point(Timer &timer)
+  {
+    for (auto coordinate_system : {cartesian, spherical})
+      for (size_t n_vertices : {4, 16, 64, 256, 1024})
+        {
+          Random random(n_vertices);
+          const double radius = coordinate_system == cartesian ? 500e3 : 0.2;
+          const Point<2> center(coordinate_system == cartesian ? 500e3 : 0.3,
+                                coordinate_system == cartesian ? 500e3 : 0.2,
+                                coordinate_system);
+          const std::vector<Point<2> > polygon = create_polygon(n_vertices, center, radius, random);
+
+          std::vector<Point<2> > points;
+          for (size_t i = 0; i < n_inputs; ++i)
+            points.push_back(Point<2>(center[0] + random.uniform(-1.2,1.2) * radius,
+                                      center[1] + random.uniform(-1.2,1.2) * radius,
+                                      coordinate_system));
+
+          timer.run("polygon_contains_point",
+          {{"coordinate system", coordinate_system == cartesian ? "cartesian" : "spherical"}, {"vertices", std::to_string(n_vertices)}},
+          [&](const size_t i)
+          {
+            return Utilities::polygon_contains_point(polygon, points[i]) ? 1.0 : 0.0;
+          });
+        }
+  }
+
+  void
+  benchmark_distance_point_from_curved_planes(Timer &timer)
+  {
+    const double dtr = Utilities::const_pi / 180.;
+    const double earth_radius = 6371000.;
+    const double slab_length = 600e3;
+
+    for (auto coordinate_system_type : {cartesian, spherical})
+      {
+        std::unique_ptr<CoordinateSystems::Interface> coordinate_system =
+          CoordinateSystems::Interface::create(coordinate_system_type == cartesian ? "cartesian" : "spherical", nullptr);
+        if (coordinate_system_type == spherical)
+          dynamic_cast<CoordinateSystems::Spherical &>(*coordinate_system).used_depth_method = DepthMethod::angle_at_starting_point_with_surface;
+
+        // In cartesian coordinates the trench runs along the x-axis and the surface is at
+        // z = 1000 km. In spherical coordinates it runs along the equator.
+        const double surface = coordinate_system_type == cartesian ? 1000e3 : earth_radius;
+        const double trench_length = coordinate_system_type == cartesian ? 1000e3 : 1000e3 / earth_radius;
+        const double width = coordinate_system_type == cartesian ? slab_length : slab_length / earth_radius;
+        const Point<2> reference_point(0, -width, coordinate_system_type);
+
+        for (bool curved : {false, true})
+          for (size_t n_sections : {1, 8, 32})
+            for (size_t n_segments : {1, 4, 16})
+              {
+                std::vector<Point<2> > coordinates;
+                std::vector<std::vector<double> > segment_lengths(n_sections + 1);
+                std::vector<std::vector<Point<2> > > segment_angles(n_sections + 1);
+                SegmentTable segment_table;
+                segment_table.reinit(n_sections + 1, n_segments);
+                for (size_t section = 0; section <= n_sections; ++section)
+                  {
+                    coordinates.push_back(Point<2>(trench_length * static_cast<double>(section) / static_cast<double>(n_sections),
+                                                   0, coordinate_system_type));
+                    for (size_t segment = 0; segment < n_segments; ++segment)
+                      {
+                        const double begin_angle = 30. + 40. * static_cast<double>(segment) / static_cast<double>(n_segments);
+                        const double end_angle = curved ? 30. + 40. * static_cast<double>(segment + 1) / static_cast<double>(n_segments) : begin_angle;
+                        segment_lengths[section].push_back(slab_length / static_cast<double>(n_segments));
+                        segment_angles[section].push_back(Point<2>(begin_angle * dtr, end_angle * dtr, cartesian));
+                        segment_table(SegmentTable::length, section, segment) = slab_length / static_cast<double>(n_segments);
+                        segment_table(SegmentTable::angle_top, section, segment) = begin_angle * dtr;
+                        segment_table(SegmentTable::angle_bottom, section, segment) = end_angle * dtr;
+                      }
+                  }
+
+                // The angles are the same at every coordinate, so the table
+                // contains every section with a single sample.
+                CenterlineTable centerline_table;
+                centerline_table.reinit(segment_table, 1);
+
+                Random random(n_sections * 100 + n_segments);
+                std::vector<Point<3> > points;
+                for (size_t i = 0; i < n_inputs; ++i)
+                  {
+                    const double along = random.uniform(0, trench_length);
+                    const double across = random.uniform(-0.2 * width, width);
+                    const double depth = random.uniform(0, slab_length);
+                    if (coordinate_system_type == cartesian)
+                      points.push_back(Point<3>(along, across, surface - depth, cartesian));
+                    else
+                      points.push_back(Utilities::spherical_to_cartesian_coordinates({{surface - depth, along, across}}));
+                  }
+
+                timer.run("distance_point_from_curved_planes",
+                {
+                  {"coordinate system", coordinate_system_type == cartesian ? "cartesian" : "spherical"},
+                  {"segments", curved ? "curved" : "straight"},
+                  {"sections", std::to_string(n_sections)},
+                  {"segments per section", std::to_string(n_segments)}
+                },
+                [&](const size_t i)
+                {
+                  const Utilities::PointDistanceFromCurvedPlanes distance =
+                    Utilities::distance_point_from_curved_planes(points[i], reference_point, coordinates,
+                                                                 segment_lengths, segment_angles, surface,
+                                                                 coordinate_system, false);
+                  return std::isfinite(distance.distance_from_plane) ? distance.distance_from_plane : 0.0;
+                });
+
+                timer.run("distance_point_from_curved_planes centerline table",
+                {
+                  {"coordinate system", coordinate_system_type == cartesian ? "cartesian" : "spherical"},
+                  {"segments", curved ? "curved" : "straight"},
+                  {"sections", std::to_string(n_sections)},
+                  {"segments per section", std::to_string(n_segments)}
+                },
+                [&](const size_t i)
+                {
+                  const Utilities::PointDistanceFromCurvedPlanes distance =
+                    Utilities::distance_point_from_curved_planes(points[i], reference_point, coordinates,
+                                                                 segment_table, surface,
+                                                                 coordinate_system, false,
+                                                                 std::vector<double>(), nullptr, &centerline_table);
+                  return std::isfinite(distance.distance_from_plane) ? distance.distance_from_plane : 0.0;
+                });
+
+                // The points are computed in blocks of eight, and the time is
+                // still reported per point.
+                const size_t block_size = 8;
+                std::vector<double> x(n_inputs), y(n_inputs), z(n_inputs), start_radii(n_inputs, surface);
+                for (size_t i = 0; i < n_inputs; ++i)
+                  {
+                    x[i] = points[i][0];
+                    y[i] = points[i][1];
+                    z[i] = points[i][2];
+                  }
+                std::vector<Utilities::PointDistanceFromCurvedPlanes> distances(n_inputs);
+                timer.run("distance_points_from_curved_planes",
+                {
+                  {"coordinate system", coordinate_system_type == cartesian ? "cartesian" : "spherical"},
+                  {"segments", curved ? "curved" : "straight"},
+                  {"sections", std::to_string(n_sections)},
+                  {"segments per section", std::to_string(n_segments)}
+                },
+                [&](const size_t i)
+                {
+                  if (i % block_size == 0)
+                    Utilities::distance_points_from_curved_planes(std::min(block_size, n_inputs - i),
+                                                                  &x[i], &y[i], &z[i], &start_radii[i],
+                                                                  reference_point, coordinates, segment_table,
+                                                                  coordinate_system, false, std::vector<double>(),
+                                                                  nullptr, &centerline_table, &distances[i]);
+                  return std::isfinite(distances[i].distance_from_plane) ? distances[i].distance_from_plane : 0.0;
+                });
+              }
+      }
+  }
+
+  void
+  benchmark_distance_field(Timer &timer)
+  {
+    const double dtr = Utilities::const_pi / 180.;
+    const double slab_length = 600e3;
+    const double thickness = 100e3;
+    const double surface = 1000e3;
+    const double trench_length = 1000e3;
+    const size_t n_sections = 8;
+    const size_t n_segments = 4;
+    std::unique_ptr<CoordinateSystems::Interface> coordinate_system = CoordinateSystems::Interface::create("cartesian", nullptr);
+
+    // A curved slab below a straight trench along the x-axis, like in the
+    // benchmark of distance_point_from_curved_planes.
+    std::vector<Point<2> > coordinates;
+    SegmentTable segment_table;
+    segment_table.reinit(n_sections + 1, n_segments);
+    for (size_t section = 0; section <= n_sections; ++section)
+      {
+        coordinates.push_back(Point<2>(trench_length * static_cast<double>(section) / static_cast<double>(n_sections),
+                                       0, cartesian));
+        for (size_t segment = 0; segment < n_segments; ++segment)
+          {
+            segment_table(SegmentTable::length, section, segment) = slab_length / static_cast<double>(n_segments);
+            segment_table(SegmentTable::angle_top, section, segment) = (30. + 40. * static_cast<double>(segment) / static_cast<double>(n_segments)) * dtr;
+            segment_table(SegmentTable::angle_bottom, section, segment) = (30. + 40. * static_cast<double>(segment + 1) / static_cast<double>(n_segments)) * dtr;
+          }
+      }
+    const Point<2> reference_point(0, -slab_length, cartesian);
+
+    const auto exact = [&](const std::array<double,3> &point)
+    {
+      return Utilities::distance_point_from_curved_planes(Point<3>(point[0], point[1], surface - point[2], cartesian),
+                                                          reference_point, coordinates, segment_table, surface,
+                                                          coordinate_system, false);
+    };
+
+    Random random(3);
+    std::vector<std::array<double,3> > points;
+    for (size_t i = 0; i < n_inputs; ++i)
+      points.push_back({{random.uniform(0, trench_length), random.uniform(-0.2 * slab_length, slab_length), random.uniform(0, slab_length)}});
+
+    for (double resolution : {20e3, 10e3})
+      {
+        const double tolerance = 100;
+        const std::vector<std::pair<std::string,std::string> > parameters =
+        {
+          {"resolution", std::to_string(static_cast<int>(resolution))},
+          {"tolerance", std::to_string(static_cast<int>(tolerance))}
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        DistanceField distance_field;
+        distance_field.reinit({{-slab_length, -slab_length - thickness, 0}},
+        {{trench_length + slab_length, slab_length + thickness, slab_length + thickness}},
+        resolution, tolerance, thickness + std::sqrt(3.) * resolution, slab_length, exact);
+        const double build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Compare the field with the exact distances of the points within
+        // the thickness of the slab.
+        size_t n_interpolated = 0;
+        size_t n_in_slab = 0;
+        double max_error_from_plane = 0;
+        double max_error_along_plane = 0;
+        double squared_error_from_plane = 0;
+        for (auto &point : points)
+          {
+            Utilities::PointDistanceFromCurvedPlanes interpolated;
+            if (!distance_field.interpolate(point, interpolated))
+              continue;
+            ++n_interpolated;
+
+            const Utilities::PointDistanceFromCurvedPlanes distance = exact(point);
+            if (!(std::fabs(distance.distance_from_plane) <= thickness))
+              continue;
+            ++n_in_slab;
+
+            const double error_from_plane = std::fabs(interpolated.distance_from_plane - distance.distance_from_plane);
+            max_error_from_plane = std::max(max_error_from_plane, error_from_plane);
+            max_error_along_plane = std::max(max_error_along_plane,
+                                             std::fabs(interpolated.distance_along_plane - distance.distance_along_plane));
+            squared_error_from_plane += error_from_plane * error_from_plane;
+          }
+
+        timer.report("distance_field error", parameters,
+        {
+          {"build time", build_time},
+          {"memory", static_cast<double>(distance_field.memory_usage())},
+          {"interpolated cells", static_cast<double>(distance_field.n_interpolated_cells()) / static_cast<double>(distance_field.n_cells())},
+          {"points without exact computation", static_cast<double>(n_interpolated) / static_cast<double>(points.size())},
+          {"max distance from plane error", max_error_from_plane},
+          {"rms distance from plane error", n_in_slab > 0 ? std::sqrt(squared_error_from_plane / static_cast<double>(n_in_slab)) : 0.},
+          {"max distance along plane error", max_error_along_plane}
+        });
+
+        timer.run("distance_field", parameters, [&](const size_t i)
+        {
+          Utilities::PointDistanceFromCurvedPlanes distance;
+          if (!distance_field.interpolate(points[i], distance))
+            distance = exact(points[i]);
+          return std::isfinite(distance.distance_from_plane) ? distance.distance_from_plane : 0.0;
+        });
+      }
+
+    timer.run("distance_field", {{"resolution", "exact"}}, [&](const size_t i)
+    {
+      const Utilities::PointDistanceFromCurvedPlanes distance = exact(points[i]);
+      return std::isfinite(distance.distance_from_plane) ? distance.distance_from_plane : 0.0;
+    });
+  }
+
+  void
+  benchmark_cartesian_to_spherical_coordinates(Timer &timer)
+  {
+    Random random(1);
+    std::vector<Point<3> > points;
+    for (size_t i = 0; i < n_inputs; ++i)
+      points.push_back(Point<3>(random.uniform(-6371e3,6371e3), random.uniform(-6371e3,6371e3),
+                                random.uniform(-6371e3,6371e3), cartesian));
+
+    timer.run("cartesian_to_spherical_coordinates", {}, [&](const size_t i)
+    {
+      return Utilities::cartesian_to_spherical_coordinates(points[i])[2];
+    });
+  }
+
+  void
+  benchmark_interpolation(Timer &timer)
+  {
+    for (bool monotone_spline : {false, true})
+      for (size_t n_points : {4, 64, 1024})
+        {
+          Random random(n_points);
+          std::vector<double> x(n_points), y(n_points);
+          for (size_t i = 0; i < n_points; ++i)
+            {
+              x[i] = static_cast<double>(i);
+              y[i] = random.uniform(-1, 1);
+            }
+
+          Utilities::interpolation interpolation;
+          interpolation.set_points(x, y, monotone_spline);
+
+          std::vector<double> query_points(n_inputs);
+          for (auto &query_point : query_points)
+            query_point = random.uniform(0, static_cast<double>(n_points - 1));
+
+          timer.run("interpolation",
+          {{"type", monotone_spline ? "monotone spline" : "linear"}, {"points", std::to_string(n_points)}},
+          [&](const size_t i)
+          {
+            return interpolation(query_points[i]);
+          });
+        }
+  }
+
+  void
+  benchmark_distance_between_points_at_same_depth(Timer &timer)
+  {
+    std::unique_ptr<CoordinateSystems::Interface> coordinate_system = CoordinateSystems::Interface::create("spherical", nullptr);
+
+    Random random(2);
+    std::vector<Point<3> > points_1, points_2;
+    for (size_t i = 0; i < n_inputs; ++i)
+      {
+        const double radius = random.uniform(5000e3, 6371e3);
+        points_1.push_back(Point<3>(radius, random.uniform(-3,3), random.uniform(-1.5,1.5), spherical));
+        points_2.push_back(Point<3>(radius, random.uniform(-3,3), random.uniform(-1.5,1.5), spherical));
+      }
+
+    timer.run("distance_between_points_at_same_depth", {{"coordinate system", "spherical"}}, [&](const size_t i)
+    {
+      return coordinate_system->distance_between_points_at_same_depth(points_1[i], points_2[i]);
+    });
+  }
+
+  void
+  benchmark_spatial_order(Timer &timer)
+  {
+    for (size_t n_keys : {65536, 1048576})
+      for (unsigned int n_threads : {1u, 0u})
+        {
+          Random random(n_keys);
+          std::vector<std::uint64_t> keys(n_keys);
+          for (auto &key : keys)
+            key = static_cast<std::uint64_t>(random.uniform(0, 9.2e18));
+
+          std::vector<size_t> permutation;
+          timer.run("radix_sort",
+          {{"keys", std::to_string(n_keys)}, {"threads", n_threads == 0 ? "all" : std::to_string(n_threads)}},
+          [&](const size_t)
+          {
+            SpatialOrder::radix_sort(keys, permutation, n_threads);
+            return static_cast<double>(permutation[0]);
+          });
+        }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int n_samples = 10;
+  double min_sample_time = 0.01;
+  std::string filter;
+  std::string output_file;
+
+  if (find_command_line_option(argv, argv+argc, "-h") || find_command_line_option(argv, argv+argc, "--help"))
+    {
+      std::cout << "This program times the geometric kernels of the World Builder on synthetic inputs and reports "
+                "the time per call in nanoseconds as JSON." << std::endl
+                << "The available options are: " << std::endl
+                << "-h or --help to get this help screen," << std::endl
+                << "-s the number of samples per kernel (default 10)," << std::endl
+                << "-t the minimum time of a sample in seconds (default 0.01)," << std::endl
+                << "-f only run the kernels of which the name and parameters contain this string," << std::endl
+                << "-o the file to write the results to (default the screen)." << std::endl;
+      return 0;
+    }
+
+  try
+    {
+      std::vector<std::string> options_vector = get_command_line_options_vector(argc, argv);
+      for (size_t i = 0; i < options_vector.size(); ++i)
+        {
+          const bool has_value = i+1 < options_vector.size();
+          if (options_vector[i] == "-s" && has_value)
+            n_samples = Utilities::string_to_unsigned_int(options_vector[++i]);
+          else if (options_vector[i] == "-t" && has_value)
+            min_sample_time = Utilities::string_to_double(options_vector[++i]);
+          else if (options_vector[i] == "-f" && has_value)
+            filter = options_vector[++i];
+          else if (options_vector[i] == "-o" && has_value)
+            output_file = options_vector[++i];
+          else
+            {
+              std::cerr << "Unknown option " << options_vector[i] << ", use --help for more information." << std::endl;
+              return 1;
+            }
+        }
+    }
+  catch (std::exception &e)
+    {
+      std::cerr << "Could not parse the command line options: " << e.what() << std::endl;
+      return 1;
+    }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("samples");
+  writer.Uint(n_samples);
+  writer.Key("minimum sample time");
+  writer.Double(min_sample_time);
+  writer.Key("kernels");
+  writer.StartArray();
+
+  Timer timer(writer, n_samples, min_sample_time, filter);
+  benchmark_polygon_contains_point(timer);
+  benchmark_distance_point_from_curved_planes(timer);
+  benchmark_distance_field(timer);
+  benchmark_cartesian_to_spherical_coordinates(timer);
+  benchmark_interpolation(timer);
+  benchmark_distance_between_points_at_same_depth(timer);
+  benchmark_spatial_order(timer);
+
+  writer.EndArray();
+  writer.Key("checksum");
+  writer.Double(timer.get_sink());
+  writer.EndObject();
+
+  if (output_file.empty())
+    {
+      std::cout << buffer.GetString() << std::endl;
+    }
+  else
+    {
+      std::ofstream file(output_file.c_str());
+      file << buffer.GetString() << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,649 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * This program benchmarks the World Builder library end to end. For every
+ * world builder file it is given, it measures how long it takes to create
+ * the world, and how many points per second it can evaluate for a few
+ * reproducible point sets, both for temperature and composition, with and
+ * without ordering the random points in space, and with an increasing
+ * number of threads. The results are written as JSON, so that
+ * they can be compared between versions. When a baseline file with earlier
+ * results is given, the throughput of each world is compared with it after
+ * normalizing both for the speed of the machine, and the program fails when
+ * the slowdown is too large. This is used by the performance tests.
+ */
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <world_builder/assert.h>
+#include <world_builder/config.h>
+#include <world_builder/thread_chunks.h>
+#include <world_builder/utilities.h>
+#include <world_builder/world.h>
+
+#include <benchmark/main.h>
+#include <benchmark/random.h>
+
+using namespace WorldBuilder;
+using Benchmark::Random;
+
+namespace
+{
+  /**
+   * The region of the world in which the points are placed. For spherical
+   * worlds, x and y are the longitude and latitude in radians.
+   */
+  struct Domain
+  {
+    bool spherical;
+    double x_min;
+    double x_max;
+    double y_min;
+    double y_max;
+    double max_depth;
+  };
+
+  /**
+   * A set of points with their depth and gravity, stored as separate arrays
+   * so they can directly be passed to the batched World functions.
+   */
+  struct PointSet
+  {
+    std::string name;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> depth;
+    std::vector<double> gravity;
+  };
+
+  const double earth_radius = 6371000.;
+
+  void
+  add_coordinates(const rapidjson::Value &value, Domain &domain, bool &found)
+  {
+    if (value.IsObject())
+      {
+        for (auto member = value.MemberBegin(); member != value.MemberEnd(); ++member)
+          {
+            if (std::string(member->name.GetString()) == "coordinates" && member->value.IsArray())
+              {
+                for (auto &coordinate : member->value.GetArray())
+                  {
+                    if (coordinate.IsArray() && coordinate.Size() == 2 && coordinate[0].IsNumber() && coordinate[1].IsNumber())
+                      {
+                        domain.x_min = std::min(domain.x_min, coordinate[0].GetDouble());
+                        domain.x_max = std::max(domain.x_max, coordinate[0].GetDouble());
+                        domain.y_min = std::min(domain.y_min, coordinate[1].GetDouble());
+                        domain.y_max = std::max(domain.y_max, coordinate[1].GetDouble());
+                        found = true;
+                      }
+                  }
+              }
+            else
+              add_coordinates(member->value, domain, found);
+          }
+      }
+    else if (value.IsArray())
+      {
+        for (auto &element : value.GetArray())
+          add_coordinates(element, domain, found);
+      }
+  }
+
+  /**
+   * Determine the domain to place the points in from the coordinates of the
+   * features in the world builder file, with a margin of ten percent on all
+   * sides.
+   */
+  Domain
+  get_domain(const std::string &wb_file, const double max_depth)
+  {
+    std::ifstream file(wb_file.c_str());
+    WBAssertThrow(file.good(), "Could not open the world builder file " << wb_file << ".");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    rapidjson::Document document;
+    document.Parse<rapidjson::kParseCommentsFlag | rapidjson::kParseNanAndInfFlag>(buffer.str().c_str());
+    WBAssertThrow(!document.HasParseError(), "Could not parse the world builder file " << wb_file << ".");
+
+    Domain domain;
+    domain.spherical = document.HasMember("coordinate system")
+                       && document["coordinate system"].HasMember("model")
+                       && std::string(document["coordinate system"]["model"].GetString()) == "spherical";
+    domain.x_min = std::numeric_limits<double>::max();
+    domain.x_max = -std::numeric_limits<double>::max();
+    domain.y_min = std::numeric_limits<double>::max();
+    domain.y_max = -std::numeric_limits<double>::max();
+    domain.max_depth = max_depth;
+
+    bool found = false;
+    if (document.HasMember("features"))
+      add_coordinates(document["features"], domain, found);
+
+    if (!found)
+      {
+        domain.x_min = domain.spherical ? -10 : 0;
+        domain.x_max = domain.spherical ? 10 : 1000e3;
+        domain.y_min = domain.x_min;
+        domain.y_max = domain.x_max;
+      }
+
+    const double x_margin = std::max(0.1 * (domain.x_max - domain.x_min), domain.spherical ? 1. : 10e3);
+    const double y_margin = std::max(0.1 * (domain.y_max - domain.y_min), domain.spherical ? 1. : 10e3);
+    domain.x_min -= x_margin;
+    domain.x_max += x_margin;
+    domain.y_min -= y_margin;
+    domain.y_max += y_margin;
+
+    if (domain.spherical)
+      {
+        const double to_radians = Utilities::const_pi / 180.;
+        domain.x_min *= to_radians;
+        domain.x_max *= to_radians;
+        domain.y_min = std::max(domain.y_min * to_radians, -0.5 * Utilities::const_pi);
+        domain.y_max = std::min(domain.y_max * to_radians, 0.5 * Utilities::const_pi);
+      }
+
+    return domain;
+  }
+
+  void
+  add_point(const Domain &domain, const double x, const double y, const double depth, PointSet &point_set)
+  {
+    if (domain.spherical)
+      {
+        const std::array<double,3> natural = {{earth_radius - depth, x, y}};
+        const Point<3> cartesian = Utilities::spherical_to_cartesian_coordinates(natural);
+        point_set.x.push_back(cartesian[0]);
+        point_set.y.push_back(cartesian[1]);
+        point_set.z.push_back(cartesian[2]);
+      }
+    else
+      {
+        point_set.x.push_back(x);
+        point_set.y.push_back(y);
+        point_set.z.push_back(domain.max_depth - depth);
+      }
+    point_set.depth.push_back(depth);
+    point_set.gravity.push_back(10);
+  }
+
+  /**
+   * Create the point sets: uniformly random points in the domain, vertical
+   * columns at random locations and a vertical cross section along the
+   * diagonal of the domain. All of them have about n_points points and only
+   * depend on the domain and n_points.
+   */
+  std::vector<PointSet>
+  create_point_sets(const Domain &domain, const size_t n_points)
+  {
+    std::vector<PointSet> point_sets(3);
+
+    Random random(42);
+    point_sets[0].name = "uniform random";
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const double x = random.uniform(domain.x_min, domain.x_max);
+        const double y = random.uniform(domain.y_min, domain.y_max);
+        add_point(domain, x, y, random.uniform(0, domain.max_depth), point_sets[0]);
+      }
+
+    const size_t n_samples = std::max(static_cast<size_t>(std::sqrt(static_cast<double>(n_points))), static_cast<size_t>(2));
+    point_sets[1].name = "vertical columns";
+    for (size_t i = 0; i < n_samples; ++i)
+      {
+        const double x = random.uniform(domain.x_min, domain.x_max);
+        const double y = random.uniform(domain.y_min, domain.y_max);
+        for (size_t j = 0; j < n_samples; ++j)
+          add_point(domain, x, y, domain.max_depth * static_cast<double>(j) / static_cast<double>(n_samples-1), point_sets[1]);
+      }
+
+    point_sets[2].name = "cross section";
+    for (size_t i = 0; i < n_samples; ++i)
+      {
+        const double fraction = static_cast<double>(i) / static_cast<double>(n_samples-1);
+        const double x = domain.x_min + fraction * (domain.x_max - domain.x_min);
+        const double y = domain.y_min + fraction * (domain.y_max - domain.y_min);
+        for (size_t j = 0; j < n_samples; ++j)
+          add_point(domain, x, y, domain.max_depth * static_cast<double>(j) / static_cast<double>(n_samples-1), point_sets[2]);
+      }
+
+    return point_sets;
+  }
+
+  /**
+   * Returns the median time in seconds of calling function n_repeats times.
+   */
+  template<class Function>
+  double
+  median_time(const unsigned int n_repeats, const Function &function)
+  {
+    std::vector<double> times;
+    for (unsigned int repeat = 0; repeat < std::max(n_repeats, 1u); ++repeat)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(end - start).count());
+      }
+    std::sort(times.begin(), times.end());
+    return times[times.size()/2];
+  }
+
+  double
+  temperature_throughput(const World &world, const PointSet &points, const unsigned int n_threads, const unsigned int n_repeats)
+  {
+    std::vector<double> temperatures(points.x.size());
+    const double time = median_time(n_repeats, [&]()
+    {
+      Utilities::run_in_chunks(points.x.size(), n_threads, [&](const unsigned int, const size_t begin, const size_t end)
+      {
+        world.temperatures(end-begin, &points.x[begin], &points.y[begin], &points.z[begin],
+                           &points.depth[begin], &points.gravity[begin], &temperatures[begin]);
+      });
+    });
+    return static_cast<double>(points.x.size()) / time;
+  }
+
+  double
+  composition_throughput(const World &world, const PointSet &points, const unsigned int n_compositions,
+                         const unsigned int n_threads, const unsigned int n_repeats)
+  {
+    std::vector<double> compositions(points.x.size() * n_compositions);
+    const double time = median_time(n_repeats, [&]()
+    {
+      Utilities::run_in_chunks(points.x.size(), n_threads, [&](const unsigned int, const size_t begin, const size_t end)
+      {
+        world.compositions(end-begin, &points.x[begin], &points.y[begin], &points.z[begin],
+                           &points.depth[begin], n_compositions, &compositions[begin*n_compositions]);
+      });
+    });
+    return static_cast<double>(points.x.size()) / time;
+  }
+
+  /**
+   * Returns the median time in seconds of a fixed amount of scalar floating
+   * point work, with a mix of square roots, trigonometric functions and
+   * branches similar to the geometric computations of the World Builder.
+   * Multiplying a throughput with this time gives a number which is, to first
+   * order, independent of the speed of the machine, so that measurements
+   * from different machines can be compared.
+   */
+  double
+  calibration_time(const unsigned int n_repeats)
+  {
+    double sink = 0;
+    const double time = median_time(std::max(n_repeats, 5u), [&]()
+    {
+      double sum = 0;
+      for (unsigned int i = 0; i < 2000000; ++i)
+        {
+          const double x = 1e-6 * static_cast<double>(i);
+          const double y = std::sqrt(x * x + 1.) * std::sin(x) + std::atan2(x, 1. + x);
+          sum += y > 0.5 ? y : std::cos(y);
+        }
+      sink += sum;
+    });
+    WBAssertThrow(std::isfinite(sink), "The calibration loop did not produce a finite result.");
+    return time;
+  }
+
+  /**
+   * Returns the file name without the directory, which is used to match the
+   * worlds in a baseline file with the current worlds.
+   */
+  std::string
+  base_name(const std::string &file)
+  {
+    const size_t position = file.find_last_of("/\\");
+    return position == std::string::npos ? file : file.substr(position + 1);
+  }
+
+  /**
+   * Returns the normalized throughput of a world in the output of this
+   * program: the geometric mean of the temperature and composition points
+   * per second over all point sets, multiplied with the calibration time.
+   */
+  double
+  normalized_throughput(const rapidjson::Value &world, const double calibration)
+  {
+    WBAssertThrow(world.HasMember("point sets") && world["point sets"].IsArray() && world["point sets"].Size() > 0,
+                  "The world " << world["file"].GetString() << " does not contain any point sets.");
+    double log_sum = 0;
+    unsigned int n_values = 0;
+    for (auto &point_set : world["point sets"].GetArray())
+      {
+        log_sum += std::log(point_set["temperature points per second"].GetDouble());
+        log_sum += std::log(point_set["composition points per second"].GetDouble());
+        n_values += 2;
+      }
+    return std::exp(log_sum / n_values) * calibration;
+  }
+
+  /**
+   * Returns the normalized startup speed of a world in the output of this
+   * program: the number of times the world can be created per second,
+   * multiplied with the calibration time.
+   */
+  double
+  normalized_startup_speed(const rapidjson::Value &world, const double calibration)
+  {
+    WBAssertThrow(world.HasMember("startup time") && world["startup time"].GetDouble() > 0,
+                  "The world " << world["file"].GetString() << " does not contain a startup time.");
+    return calibration / world["startup time"].GetDouble();
+  }
+
+  /**
+   * Read a JSON file written by this program.
+   */
+  void
+  read_results(const std::string &file_name, rapidjson::Document &document)
+  {
+    std::ifstream file(file_name.c_str());
+    WBAssertThrow(file.good(), "Could not open the baseline file " << file_name << ".");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    document.Parse(buffer.str().c_str());
+    WBAssertThrow(!document.HasParseError() && document.IsObject() && document.HasMember("worlds")
+                  && document.HasMember("calibration time"),
+                  "The file " << file_name << " is not a valid benchmark result file with a calibration time.");
+  }
+}
+
+int main(int argc, char **argv)
+{
+  size_t n_points = 100000;
+  unsigned int n_compositions = 3;
+  unsigned int n_repeats = 3;
+  unsigned int max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  double max_depth = 660e3;
+  double max_slowdown = 2.;
+  bool startup_only = false;
+  std::string output_file;
+  std::string baseline_file;
+
+  if (find_command_line_option(argv, argv+argc, "-h") || find_command_line_option(argv, argv+argc, "--help"))
+    {
+      std::cout << "This program benchmarks the World Builder library on the given world builder files. For each file "
+                "it reports the startup time and the number of points per second for temperature and composition on "
+                "a set of reproducible point sets, as JSON." << std::endl
+                << "Besides providing one or more world builder files, the available options are: " << std::endl
+                << "-h or --help to get this help screen," << std::endl
+                << "-n the number of points in each point set (default 100000)," << std::endl
+                << "-c the number of compositions to evaluate (default 3)," << std::endl
+                << "-r the number of times each measurement is repeated, the median is reported (default 3)," << std::endl
+                << "-j the maximum number of threads used for the scaling measurement (default all hardware threads)," << std::endl
+                << "-d the maximum depth of the points (default 660e3)," << std::endl
+                << "-o the file to write the results to (default the screen)," << std::endl
+                << "--baseline a file with earlier results of this program to compare the normalized throughput "
+                "of each world with; the program fails when a world is more than the maximum slowdown slower," << std::endl
+                << "--max-slowdown the maximum allowed slowdown factor compared to the baseline (default 2)," << std::endl
+                << "--startup-only to only measure the startup time of each world; the baseline comparison then uses the "
+                "normalized startup speed instead of the throughput." << std::endl;
+      return 0;
+    }
+
+  std::vector<std::string> wb_files;
+  try
+    {
+      std::vector<std::string> options_vector = get_command_line_options_vector(argc, argv);
+      for (size_t i = 0; i < options_vector.size(); ++i)
+        {
+          const bool has_value = i+1 < options_vector.size();
+          if (options_vector[i] == "-n" && has_value)
+            n_points = Utilities::string_to_unsigned_int(options_vector[++i]);
+          else if (options_vector[i] == "-c" && has_value)
+            n_compositions = Utilities::string_to_unsigned_int(options_vector[++i]);
+          else if (options_vector[i] == "-r" && has_value)
+            n_repeats = Utilities::string_to_unsigned_int(options_vector[++i]);
+          else if (options_vector[i] == "-j" && has_value)
+            max_threads = std::max(Utilities::string_to_unsigned_int(options_vector[++i]), 1u);
+          else if (options_vector[i] == "-d" && has_value)
+            max_depth = Utilities::string_to_double(options_vector[++i]);
+          else if (options_vector[i] == "-o" && has_value)
+            output_file = options_vector[++i];
+          else if (options_vector[i] == "--baseline" && has_value)
+            baseline_file = options_vector[++i];
+          else if (options_vector[i] == "--max-slowdown" && has_value)
+            max_slowdown = Utilities::string_to_double(options_vector[++i]);
+          else if (options_vector[i] == "--startup-only")
+            startup_only = true;
+          else
+            wb_files.push_back(options_vector[i]);
+        }
+    }
+  catch (std::exception &e)
+    {
+      std::cerr << "Could not parse the command line options: " << e.what() << std::endl;
+      return 1;
+    }
+
+  if (wb_files.size() == 0)
+    {
+      std::cout << "Error: There where no files passed to the World Builder benchmark, use --help for more " << std::endl
+                << "information on how to use the World Builder benchmark." << std::endl;
+      return 1;
+    }
+
+  rapidjson::Document baseline;
+  if (!baseline_file.empty())
+    {
+      try
+        {
+          read_results(baseline_file, baseline);
+        }
+      catch (std::exception &e)
+        {
+          std::cerr << e.what() << std::endl;
+          return 1;
+        }
+    }
+
+  const double calibration = calibration_time(n_repeats);
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("version");
+  writer.String((Version::MAJOR + "." + Version::MINOR + "." + Version::PATCH + Version::LABEL).c_str());
+  writer.Key("git sha1");
+  writer.String(Version::GIT_SHA1.c_str());
+  writer.Key("hardware threads");
+  writer.Uint(std::thread::hardware_concurrency());
+  writer.Key("points per set");
+  writer.Uint64(n_points);
+  writer.Key("compositions");
+  writer.Uint(n_compositions);
+  writer.Key("repeats");
+  writer.Uint(n_repeats);
+  writer.Key("calibration time");
+  writer.Double(calibration);
+  writer.Key("worlds");
+  writer.StartArray();
+
+  for (auto &wb_file : wb_files)
+    {
+      writer.StartObject();
+      writer.Key("file");
+      writer.String(wb_file.c_str());
+
+      try
+        {
+          std::unique_ptr<World> world;
+          const double startup_time = median_time(n_repeats, [&]()
+          {
+            world.reset(new World(wb_file));
+          });
+
+          if (startup_only)
+            {
+              writer.Key("startup time");
+              writer.Double(startup_time);
+              writer.EndObject();
+              continue;
+            }
+
+          const Domain domain = get_domain(wb_file, max_depth);
+          const std::vector<PointSet> point_sets = create_point_sets(domain, n_points);
+
+          writer.Key("coordinate system");
+          writer.String(domain.spherical ? "spherical" : "cartesian");
+          writer.Key("startup time");
+          writer.Double(startup_time);
+
+          writer.Key("point sets");
+          writer.StartArray();
+          for (auto &point_set : point_sets)
+            {
+              writer.StartObject();
+              writer.Key("name");
+              writer.String(point_set.name.c_str());
+              writer.Key("points");
+              writer.Uint64(point_set.x.size());
+              writer.Key("temperature points per second");
+              writer.Double(temperature_throughput(*world, point_set, 1, n_repeats));
+              writer.Key("composition points per second");
+              writer.Double(composition_throughput(*world, point_set, n_compositions, 1, n_repeats));
+              writer.EndObject();
+            }
+          writer.EndArray();
+
+          // The uniform random points are in no order in space, which is
+          // what the spatial order of the batched functions is for.
+          writer.Key("spatial order");
+          writer.StartArray();
+          for (bool ordered : {false, true})
+            {
+              world->spatial_order.set_enabled(ordered);
+              writer.StartObject();
+              writer.Key("point set");
+              writer.String(point_sets[0].name.c_str());
+              writer.Key("ordered");
+              writer.Bool(ordered);
+              writer.Key("temperature points per second");
+              writer.Double(temperature_throughput(*world, point_sets[0], 1, n_repeats));
+              writer.Key("composition points per second");
+              writer.Double(composition_throughput(*world, point_sets[0], n_compositions, 1, n_repeats));
+              writer.EndObject();
+            }
+          world->spatial_order.set_enabled(false);
+          writer.EndArray();
+
+          writer.Key("thread scaling");
+          writer.StartArray();
+          for (unsigned int n_threads = 1; ; n_threads = std::min(2 * n_threads, max_threads))
+            {
+              writer.StartObject();
+              writer.Key("threads");
+              writer.Uint(n_threads);
+              writer.Key("temperature points per second");
+              writer.Double(temperature_throughput(*world, point_sets[0], n_threads, n_repeats));
+              writer.EndObject();
+              if (n_threads == max_threads)
+                break;
+            }
+          writer.EndArray();
+        }
+      catch (std::exception &e)
+        {
+          writer.Key("error");
+          writer.String(e.what());
+        }
+
+      writer.EndObject();
+    }
+
+  writer.EndArray();
+  writer.EndObject();
+
+  if (output_file.empty())
+    {
+      std::cout << buffer.GetString() << std::endl;
+    }
+  else
+    {
+      std::ofstream file(output_file.c_str());
+      file << buffer.GetString() << std::endl;
+    }
+
+  if (baseline_file.empty())
+    return 0;
+
+  // Compare the normalized throughput of every world with the baseline. The
+  // worlds are matched by file name, so that the baseline does not depend on
+  // where the files are located.
+  rapidjson::Document results;
+  results.Parse(buffer.GetString());
+  const double baseline_calibration = baseline["calibration time"].GetDouble();
+  bool failed = false;
+  for (auto &world : results["worlds"].GetArray())
+    {
+      const std::string name = base_name(world["file"].GetString());
+      if (world.HasMember("error"))
+        {
+          std::cerr << name << ": failed with the error: " << world["error"].GetString() << std::endl;
+          failed = true;
+          continue;
+        }
+
+      const rapidjson::Value *baseline_world = nullptr;
+      for (auto &candidate : baseline["worlds"].GetArray())
+        if (base_name(candidate["file"].GetString()) == name && !candidate.HasMember("error"))
+          baseline_world = &candidate;
+
+      if (baseline_world == nullptr)
+        {
+          std::cerr << name << ": not present in the baseline " << baseline_file << ", skipping." << std::endl;
+          continue;
+        }
+
+      const double current_throughput = startup_only
+                                        ? normalized_startup_speed(world, calibration)
+                                        : normalized_throughput(world, calibration);
+      const double baseline_throughput = startup_only
+                                         ? normalized_startup_speed(*baseline_world, baseline_calibration)
+                                         : normalized_throughput(*baseline_world, baseline_calibration);
+      const double slowdown = baseline_throughput / current_throughput;
+      const bool too_slow = slowdown > max_slowdown;
+      failed = failed || too_slow;
+      std::cerr << name << (startup_only ? ": normalized startup speed " : ": normalized throughput ") << current_throughput << ", baseline " << baseline_throughput
+                << ", slowdown " << slowdown << (too_slow ? " exceeds " : " is within ") << "the maximum of "
+                << max_slowdown << "." << std::endl;
+    }
+
+  return failed ? 1 : 0;
+}
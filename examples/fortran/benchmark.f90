@@ -0,0 +1,63 @@
+program benchmark
+use WorldBuilder
+
+IMPLICIT NONE
+
+  ! This program compares calling the World Builder once per point with calling it
+  ! once per block of points. It evaluates the temperature on a regular grid of
+  ! n x n x n points, ordered as a mantle convection code would loop over its elements.
+  INTEGER, PARAMETER :: n = 64
+  REAL*8, PARAMETER :: extent = 1000e3
+  REAL*8 :: xs(n*n*n), ys(n*n*n), zs(n*n*n), depths(n*n*n), gravities(n*n*n)
+  REAL*8 :: temperatures_point(n*n*n), temperatures_block(n*n*n)
+  INTEGER :: i, j, k, index
+  INTEGER*8 :: clock_start, clock_end, clock_rate
+  REAL*8 :: time_point, time_block
+  character(len=256) :: file_name = "../../tests/data/subducting_plate_different_angles_cartesian.wb"//C_NULL_CHAR
+  logical(1) :: has_output_dir = .false.
+  character(len=256) :: output_dir = ""//C_NULL_CHAR
+
+  IF (COMMAND_ARGUMENT_COUNT() >= 1) THEN
+    CALL GET_COMMAND_ARGUMENT(1, file_name)
+    file_name = trim(file_name)//C_NULL_CHAR
+  END IF
+
+  CALL create_world(cworld, file_name, has_output_dir, output_dir)
+
+  ! Set up the grid. The depth is measured from the top of the box.
+  index = 0
+  DO k = 1, n
+    DO j = 1, n
+      DO i = 1, n
+        index = index + 1
+        xs(index) = (i-1) * extent / (n-1)
+        ys(index) = (j-1) * extent / (n-1)
+        zs(index) = (k-1) * extent / (n-1)
+        depths(index) = extent - zs(index)
+        gravities(index) = 10
+      END DO
+    END DO
+  END DO
+
+  ! One call per point.
+  CALL SYSTEM_CLOCK(clock_start, clock_rate)
+  DO index = 1, n*n*n
+    CALL temperature_3d(cworld,xs(index),ys(index),zs(index),depths(index),gravities(index), &
+                        temperatures_point(index))
+  END DO
+  CALL SYSTEM_CLOCK(clock_end)
+  time_point = REAL(clock_end - clock_start, 8) / clock_rate
+
+  ! One call for the whole block.
+  CALL SYSTEM_CLOCK(clock_start, clock_rate)
+  CALL temperatures_3d(cworld,xs,ys,zs,depths,gravities,temperatures_block)
+  CALL SYSTEM_CLOCK(clock_end)
+  time_block = REAL(clock_end - clock_start, 8) / clock_rate
+
+  write(*, *) 'number of points       = ', n*n*n
+  write(*, *) 'per-point calls    (s) = ', time_point
+  write(*, *) 'per-block call     (s) = ', time_block
+  write(*, *) 'maximum difference     = ', MAXVAL(ABS(temperatures_point - temperatures_block))
+
+  CALL release_world(cworld)
+END program
@@ -11,3 +11,38 @@ print ("2d composition:")
 print ("composition in Python = ", world_builder.composition_2d(120.0e3,500.0e3,0,3));
 print ("3d composition:")
 print ("composition in Python = ", world_builder.composition_3d(120.0e3,500.0e3,.0e3,0e3,3));
+
+# Throughput comparison between calling the World Builder once per point and
+# calling it once for a whole NumPy array of points. The batched calls work on
+# the NumPy arrays in place and release the GIL while they run.
+import time
+import numpy as np
+
+n = 50
+x, y, z = np.meshgrid(np.linspace(0, 1000e3, n), np.linspace(0, 1000e3, n), np.linspace(0, 1000e3, n), indexing='ij')
+depth = 1000e3 - z
+gravity = np.full(x.shape, 10.0)
+
+start = time.perf_counter()
+temperatures_point = np.empty(x.shape)
+for index in np.ndindex(x.shape):
+  temperatures_point[index] = world_builder.temperature_3d(x[index],y[index],z[index],depth[index],gravity[index])
+time_point = time.perf_counter() - start
+
+start = time.perf_counter()
+temperatures_block = world_builder.temperatures_3d(x,y,z,depth,gravity)
+time_block = time.perf_counter() - start
+
+start = time.perf_counter()
+temperatures_threads = world_builder.temperatures_3d(x,y,z,depth,gravity,n_threads=0)
+time_threads = time.perf_counter() - start
+
+compositions = world_builder.compositions_3d(x,y,z,depth,4)
+
+print ("number of points = ", x.size)
+print ("per-point calls:           ", x.size/time_point, " points per second")
+print ("batched call:              ", x.size/time_block, " points per second")
+print ("batched call, all threads: ", x.size/time_threads, " points per second")
+print ("maximum difference = ", np.max(np.abs(temperatures_point - temperatures_block)),
+       np.max(np.abs(temperatures_point - temperatures_threads)))
+print ("composition 3 range = ", compositions[...,3].min(), compositions[...,3].max())
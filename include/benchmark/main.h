@@ -0,0 +1,50 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _benchmark_main_h
+#define _benchmark_main_h
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * The command line options of the benchmark programs, without the name of
+ * the program.
+ */
+inline
+std::vector<std::string> get_command_line_options_vector(int argc, char **argv)
+{
+  std::vector<std::string> vector;
+  for (int i=1; i < argc; ++i)
+    vector.push_back(argv[i]);
+
+  return vector;
+}
+
+/**
+ * Whether the given option is one of the command line options.
+ */
+inline
+bool find_command_line_option(char **begin, char **end, const std::string &option)
+{
+  return std::find(begin, end, option) != end;
+}
+
+#endif
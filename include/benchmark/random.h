@@ -0,0 +1,58 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _benchmark_random_h
+#define _benchmark_random_h
+
+#include <cstdint>
+
+namespace Benchmark
+{
+  /**
+   * A small random number generator with a fixed algorithm, so that the
+   * benchmark inputs are the same on every platform and with every standard
+   * library. This is the splitmix64 generator.
+   */
+  class Random
+  {
+    public:
+      explicit Random(const uint64_t seed)
+        :
+        state(seed)
+      {}
+
+      /**
+       * Returns a uniformly distributed number in [min,max).
+       */
+      double uniform(const double min, const double max)
+      {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+        return min + (max - min) * static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0);
+      }
+
+    private:
+      uint64_t state;
+  };
+}
+
+#endif
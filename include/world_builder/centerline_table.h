@@ -0,0 +1,178 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_centerline_table_h
+#define _world_builder_centerline_table_h
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <world_builder/segment_table.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class tabulates the centerline of the slab below every section of
+   * a slab or fault, so that distance_point_from_curved_planes() does not
+   * have to compute the sines and cosines of the angles of every segment
+   * for every point.
+   *
+   * The angles and lengths of the segments are interpolated linearly between
+   * the two coordinates of a section, so they are cheap to compute for any
+   * fraction along the section. The end point of a segment and the center
+   * of its circle then follow from the direction of the segment at its top
+   * and the rotation of the direction along the segment, which are the
+   * parts which require trigonometric functions. The table stores the
+   * cosine and sine of both for every segment at a number of fractions
+   * along every section, which are interpolated and normalized for the
+   * fraction of a point.
+   *
+   * When the angles of all the segments are the same at both coordinates
+   * of a section, the centerline does not depend on the fraction, and the
+   * section is stored with one sample. The end points and centers computed
+   * from the table differ from the ones computed from the angles in the last
+   * digits, and the interpolation of the other sections introduces a small
+   * error in the directions. So the table is only built when a number of
+   * fractions is given, and the default results stay the same.
+   */
+  class CenterlineTable
+  {
+    public:
+      /**
+       * The direction of a segment at its top and the rotation of the
+       * direction along the segment, with the angles measured as in
+       * distance_point_from_curved_planes().
+       */
+      struct Directions
+      {
+        double cos_angle_top;
+        double sin_angle_top;
+        double cos_angle_difference;
+        double sin_angle_difference;
+      };
+
+      /**
+       * The samples around a fraction of a section, and the weight of the
+       * upper one. The lower sample is a null pointer when the section is
+       * not stored.
+       */
+      struct Sample
+      {
+        const Directions *lower;
+        const Directions *upper;
+        double weight;
+      };
+
+      /**
+       * Constructor for an empty table, which is not used.
+       */
+      CenterlineTable();
+
+      /**
+       * Build the table for the sections between the coordinates of the
+       * given segment table, where the number of fractions is the number
+       * of intervals in which a section with changing angles is divided.
+       * When it is zero, the table is not built.
+       */
+      void reinit(const SegmentTable &segment_table, const unsigned int n_fractions);
+
+      /**
+       * Remove the table, so that it is no longer used.
+       */
+      void clear();
+
+      /**
+       * Whether the table has been built.
+       */
+      bool is_initialized() const
+      {
+        return initialized;
+      }
+
+      /**
+       * Returns the samples of a section between its coordinate and the
+       * next one for a fraction between zero and one.
+       */
+      Sample sample(const std::size_t section, const double fraction) const
+      {
+        const std::size_t begin = first_sample[section];
+        const std::size_t n_samples = first_sample[section + 1] - begin;
+        if (n_samples == 0)
+          return {nullptr, nullptr, 0};
+        if (n_samples == 1)
+          return {&samples[begin * number_of_segments], &samples[begin * number_of_segments], 0};
+
+        const double position = fraction * static_cast<double>(n_samples - 1);
+        std::size_t lower = position > 0 ? static_cast<std::size_t>(position) : 0;
+        lower = lower < n_samples - 2 ? lower : n_samples - 2;
+        return {&samples[(begin + lower) * number_of_segments],
+                &samples[(begin + lower + 1) * number_of_segments],
+                position - static_cast<double>(lower)
+               };
+      }
+
+      /**
+       * Returns the directions of a segment for the given samples.
+       */
+      Directions directions(const Sample &sample, const std::size_t segment) const
+      {
+        const Directions &lower = sample.lower[segment];
+        const Directions &upper = sample.upper[segment];
+        const double weight = sample.weight;
+        Directions result;
+        result.cos_angle_top = lower.cos_angle_top + weight * (upper.cos_angle_top - lower.cos_angle_top);
+        result.sin_angle_top = lower.sin_angle_top + weight * (upper.sin_angle_top - lower.sin_angle_top);
+        result.cos_angle_difference = lower.cos_angle_difference + weight * (upper.cos_angle_difference - lower.cos_angle_difference);
+        result.sin_angle_difference = lower.sin_angle_difference + weight * (upper.sin_angle_difference - lower.sin_angle_difference);
+        if (weight > 0)
+          {
+            const double norm_top = std::sqrt(result.cos_angle_top * result.cos_angle_top
+                                              + result.sin_angle_top * result.sin_angle_top);
+            const double norm_difference = std::sqrt(result.cos_angle_difference * result.cos_angle_difference
+                                                     + result.sin_angle_difference * result.sin_angle_difference);
+            result.cos_angle_top /= norm_top;
+            result.sin_angle_top /= norm_top;
+            result.cos_angle_difference /= norm_difference;
+            result.sin_angle_difference /= norm_difference;
+          }
+        return result;
+      }
+
+      /**
+       * Returns the memory used by the table in bytes.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      bool initialized;
+
+      std::size_t number_of_segments;
+
+      /**
+       * The index of the first sample of every section, with one extra
+       * entry for the end of the last section. Every sample contains the
+       * directions of all the segments.
+       */
+      std::vector<std::size_t> first_sample;
+      std::vector<Directions> samples;
+  };
+}
+
+#endif
@@ -99,6 +99,11 @@ namespace WorldBuilder
          */
         double distance_between_points_at_same_depth(const Point<3> &point_1, const Point<3> &point_2) const override final;
 
+        /**
+         * Save the coordinate system to or load it from a snapshot.
+         */
+        void serialize(Snapshot &snapshot) override final;
+
 
       private:
 
@@ -118,12 +118,32 @@ namespace WorldBuilder
          */
         static std::unique_ptr<Interface> create(const std::string &name, WorldBuilder::World *world);
 
+        /**
+         * Returns the name of the plugin, which is used to create the
+         * coordinate system again when it is loaded from a snapshot.
+         */
+        const std::string &get_plugin_name() const
+        {
+          return plugin_name;
+        }
+
+        /**
+         * Save the coordinate system to or load it from a snapshot.
+         */
+        virtual
+        void serialize(Snapshot &snapshot) = 0;
+
       protected:
         /**
          * A pointer to the world class to retrieve variables.
          */
         WorldBuilder::World *world;
 
+        /**
+         * The name of the plugin, which is set by create().
+         */
+        std::string plugin_name;
+
 
 
       private:
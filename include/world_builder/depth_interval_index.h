@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_depth_interval_index_h
+#define _world_builder_depth_interval_index_h
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace WorldBuilder
+{
+  /**
+   * This class stores for a list of entries, such as the features of the
+   * world or the models of a feature, the closed depth range in which every
+   * entry can change a value, and returns for a given depth the entries
+   * whose range contains it, in their original order.
+   *
+   * The bounds of all ranges split the depth axis into intervals, and the
+   * active entries are stored for every bound and for every interval
+   * between two bounds, so that a query is a binary search over the bounds.
+   */
+  class DepthIntervalIndex
+  {
+    public:
+      /**
+       * Constructor. The index is empty.
+       */
+      DepthIntervalIndex();
+
+      /**
+       * Build the index for entries with the given depth ranges, as pairs of
+       * the minimum and maximum depth. The bounds may be infinite.
+       */
+      void build(const std::vector<std::pair<double,double> > &ranges);
+
+      /**
+       * Returns the indices of the entries whose depth range contains the
+       * given depth, in increasing order.
+       */
+      const std::vector<unsigned int> &active(const double depth) const;
+
+      /**
+       * Returns the indices of all entries, in increasing order.
+       */
+      const std::vector<unsigned int> &all() const
+      {
+        return all_entries;
+      }
+
+      /**
+       * Returns the memory used by the index in bytes, without the size of
+       * the object itself.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      /**
+       * The sorted, unique bounds of the depth ranges.
+       */
+      std::vector<double> bounds;
+
+      /**
+       * The active entries of the interval below bound i at position 2i, of
+       * bound i at position 2i+1, and of the interval above the last bound
+       * at the end.
+       */
+      std::vector<std::vector<unsigned int> > active_entries;
+
+      /**
+       * The indices of all entries.
+       */
+      std::vector<unsigned int> all_entries;
+  };
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_distance_field_h
+#define _world_builder_distance_field_h
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <world_builder/utilities.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class stores the result of distance_point_from_curved_planes on a
+   * uniform grid in a narrow band around a slab or fault, so that it can be
+   * interpolated instead of computed for every point.
+   *
+   * The distances, fractions and average angle are sampled at the nodes of
+   * the grid when the field is built. Only the nodes which are within the
+   * band width of the plane are stored. A cell is interpolated with
+   * trilinear interpolation when all its nodes are stored, all of them are
+   * in the same section and segment, and the interpolated value at the
+   * center of the cell differs less than the tolerance from the exact value
+   * there. All other cells, which includes the cells which contain a
+   * section or segment boundary, are not interpolated, and the exact
+   * function has to be used for them. Cells of which all the nodes and the
+   * center have a finite distance along the plane, and are further from the
+   * plane than the band width, are outside the slab, and return no distance.
+   * A node or center which is not next to any section may lie next to a
+   * part of the slab which is inside the cell, so its cell is not marked as
+   * outside.
+   */
+  class DistanceField
+  {
+    public:
+      /**
+       * The function which is sampled. It is given the point in the
+       * coordinates of the grid.
+       */
+      typedef std::function<Utilities::PointDistanceFromCurvedPlanes(const std::array<double,3> &)> Function;
+
+      /**
+       * Constructor for an empty field, which does not interpolate any
+       * point.
+       */
+      DistanceField();
+
+      /**
+       * Sample the function on a grid with the given cell size between the
+       * lower and upper corner. Nodes of which the distance from the plane
+       * is larger than the band width are not stored, so the band width has
+       * to be larger than the largest distance from the plane for which
+       * the distance is used, plus the diagonal of a cell. The errors of the
+       * fractions and the average angle are multiplied by the length scale,
+       * so that they can be compared with the tolerance in the same unit as
+       * the distances.
+       */
+      void reinit(const std::array<double,3> &lower_corner,
+                  const std::array<double,3> &upper_corner,
+                  const double cell_size,
+                  const double tolerance,
+                  const double band_width,
+                  const double length_scale,
+                  const Function &function);
+
+      /**
+       * Remove the field, so that it does not interpolate any point.
+       */
+      void clear();
+
+      /**
+       * Whether the field has been built.
+       */
+      bool is_initialized() const
+      {
+        return initialized;
+      }
+
+      /**
+       * Interpolate the distance at the given point and return true, or
+       * return false when the point is not in a cell which can be
+       * interpolated. For points in a cell outside the band, the distance
+       * is set to infinity.
+       */
+      bool interpolate(const std::array<double,3> &point,
+                       Utilities::PointDistanceFromCurvedPlanes &distance) const;
+
+      /**
+       * The number of cells of the grid, and the number of cells which are
+       * interpolated.
+       */
+      std::size_t n_cells() const;
+      std::size_t n_interpolated_cells() const;
+
+      /**
+       * Returns the memory used by the field in bytes.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      /**
+       * The values stored at a node.
+       */
+      struct Node
+      {
+        double distance_from_plane;
+        double distance_along_plane;
+        double section_fraction;
+        double segment_fraction;
+        double average_angle;
+        std::size_t section;
+        std::size_t segment;
+      };
+
+      /**
+       * The state of a cell: whether the exact function has to be used, the
+       * cell is interpolated, or the cell is outside the band.
+       */
+      enum CellState
+      {
+        exact_cell = 0,
+        interpolated_cell,
+        outside_cell
+      };
+
+      /**
+       * Whether all the nodes of a cell are far_node.
+       */
+      bool cell_outside_band(const std::size_t cell_x,
+                             const std::size_t cell_y,
+                             const std::size_t cell_z) const;
+
+      /**
+       * Interpolate the values of the nodes of a cell at the given local
+       * coordinates in the cell. Returns false if not all the nodes are
+       * stored or if they are not in the same section and segment.
+       */
+      bool interpolate_cell(const std::size_t cell_x,
+                            const std::size_t cell_y,
+                            const std::size_t cell_z,
+                            const double local[3],
+                            Utilities::PointDistanceFromCurvedPlanes &distance) const;
+
+      bool initialized;
+
+      /**
+       * The lower corner of the grid, the size of a cell and the number of
+       * nodes in every direction.
+       */
+      double origin[3];
+      double cell_size;
+      std::size_t n_nodes[3];
+
+      /**
+       * The index of every node of the grid in the stored nodes. A node
+       * which is not stored is far_node if it has a finite distance along
+       * the plane and is further from the plane than the band width, and
+       * invalid_node otherwise.
+       */
+      std::vector<unsigned int> node_index;
+      std::vector<Node> nodes;
+      static const unsigned int invalid_node = static_cast<unsigned int>(-1);
+      static const unsigned int far_node = static_cast<unsigned int>(-2);
+
+      /**
+       * The CellState of every cell.
+       */
+      std::vector<unsigned char> cell_states;
+      std::size_t number_of_interpolated_cells;
+  };
+}
+
+#endif
@@ -20,6 +20,7 @@
 #ifndef _world_feature_features_continental_plate_h
 #define _world_feature_features_continental_plate_h
 
+#include <world_builder/depth_interval_index.h>
 #include <world_builder/features/interface.h>
 #include <world_builder/world.h>
 
@@ -84,9 +85,52 @@ namespace WorldBuilder
                            const unsigned int composition_number,
                            double value) const override final;
 
+        /**
+         * Returns whether a temperature model of this feature replaces the
+         * temperature at the given point.
+         */
+        bool replaces_temperature(const Point<3> &position,
+                                  const double depth) const override final;
+
+        /**
+         * Returns whether a composition model of this feature replaces the
+         * given composition at the given point.
+         */
+        bool replaces_composition(const Point<3> &position,
+                                  const double depth,
+                                  const unsigned int composition_number) const override final;
+
+        /**
+         * Returns the minimum and maximum depth of this feature.
+         */
+        std::pair<double,double> depth_range() const override final;
+
+        /**
+         * Add the memory used by this feature to the given list of components.
+         */
+        void memory_usage(std::vector<std::pair<std::string,std::size_t> > &components) const override final;
+
+        /**
+         * Save the feature, including its models, to or load it from a
+         * snapshot.
+         */
+        void serialize(Snapshot &snapshot) override final;
+
 
 
       private:
+        /**
+         * Returns whether the surface point above the given point is inside
+         * the polygon of this feature.
+         */
+        bool contains_surface_point(const Point<3> &position) const;
+
+        /**
+         * Build the depth interval indices over the temperature and
+         * composition models, once the models have been created.
+         */
+        void build_model_indices();
+
         /**
          * A vector containing all the pointers to the temperature models. This vector is
          * responsible for the features and has ownership over them. Therefore
@@ -103,6 +147,13 @@ namespace WorldBuilder
          */
         std::vector<std::unique_ptr<Features::ContinentalPlateModels::Composition::Interface> > composition_models;
 
+        /**
+         * The models which can change the temperature or composition at a
+         * given depth, so that the other models are not called.
+         */
+        DepthIntervalIndex temperature_model_index;
+        DepthIntervalIndex composition_model_index;
+
         double min_depth;
         double max_depth;
 
@@ -26,6 +26,7 @@
 #include <world_builder/world.h>
 #include <world_builder/parameters.h>
 #include <world_builder/point.h>
+#include <world_builder/utilities.h>
 
 
 namespace WorldBuilder
@@ -84,7 +85,7 @@ namespace WorldBuilder
                                    double temperature,
                                    const double feature_min_depth,
                                    const double feature_max_depth,
-                                   const std::map<std::string,double> &distance_from_planes) const = 0;
+                                   const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const = 0;
             /**
              * A function to register a new type. This is part of the automatic
              * registration of the object factory.
@@ -103,11 +104,33 @@ namespace WorldBuilder
             /**
              * Returns the name of the plugin
              */
-            std::string get_name() const
+            const std::string &get_name() const
             {
               return name;
             };
 
+            /**
+             * Returns the memory used by this model in bytes, including the
+             * memory it has allocated on the heap.
+             */
+            virtual
+            std::size_t memory_usage() const;
+
+            /**
+             * Returns the name of the plugin, which is used to create the
+             * model again when it is loaded from a snapshot.
+             */
+            const std::string &get_plugin_name() const
+            {
+              return name;
+            }
+
+            /**
+             * Save the model to or load it from a snapshot.
+             */
+            virtual
+            void serialize(Snapshot &snapshot) = 0;
+
           protected:
             /**
              * A pointer to the world class to retrieve variables.
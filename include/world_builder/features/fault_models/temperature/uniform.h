@@ -74,9 +74,19 @@ namespace WorldBuilder
                                    double temperature,
                                    const double feature_min_depth,
                                    const double feature_max_depth,
-                                   const std::map<std::string,double> &distance_from_planes) const override final;
+                                   const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const override final;
 
 
+            /**
+             * Returns the memory used by this model in bytes.
+             */
+            std::size_t memory_usage() const override final;
+
+            /**
+             * Save the model to or load it from a snapshot.
+             */
+            void serialize(Snapshot &snapshot) override final;
+
           private:
             // uniform temperature submodule parameters
             double min_depth;
@@ -21,11 +21,13 @@
 #define _world_builder_features_interface_h
 
 #include <map>
+#include <set>
 #include <vector>
 
 #include <world_builder/world.h>
 #include <world_builder/parameters.h>
 #include <world_builder/point.h>
+#include <world_builder/utilities.h>
 
 using namespace std;
 
@@ -104,6 +106,70 @@ namespace WorldBuilder
                            const unsigned int composition_number,
                            double value) const = 0;
 
+        /**
+         * Computes the temperature for n_points Cartesian points, given as
+         * separate coordinate arrays, and replaces the given temperatures
+         * with the results, like calling temperature() for every point. The
+         * default implementation does exactly that, but features can
+         * process the points together.
+         */
+        virtual
+        void temperatures(const size_t n_points,
+                          const double *x,
+                          const double *y,
+                          const double *z,
+                          const double *depths,
+                          const double *gravity_norms,
+                          double *temperatures) const;
+
+        /**
+         * Computes the requested composition for n_points Cartesian points,
+         * and replaces the given values with the results, like calling
+         * composition() for every point. The default implementation does
+         * exactly that, but features can process the points together.
+         */
+        virtual
+        void compositions(const size_t n_points,
+                          const double *x,
+                          const double *y,
+                          const double *z,
+                          const double *depths,
+                          const unsigned int composition_number,
+                          double *values) const;
+
+        /**
+         * Returns whether temperature() certainly returns a value at the
+         * given point which does not depend on the temperature it is given,
+         * because one of the models of this feature replaces it. The world
+         * uses this to skip the features before it. The default
+         * implementation returns false, which is always safe.
+         */
+        virtual
+        bool replaces_temperature(const Point<3> &position,
+                                  const double depth) const;
+
+        /**
+         * Returns whether composition() certainly returns a value for the
+         * given composition at the given point which does not depend on the
+         * value it is given. The default implementation returns false, which
+         * is always safe.
+         */
+        virtual
+        bool replaces_composition(const Point<3> &position,
+                                  const double depth,
+                                  const unsigned int composition_number) const;
+
+        /**
+         * Returns the minimum and maximum depth between which temperature()
+         * and composition() can change the values they are given. Outside
+         * of this range the feature returns the given values. The world
+         * uses this to only call the features which can change the values at
+         * a depth. The default implementation returns an infinite range,
+         * which is always safe.
+         */
+        virtual
+        std::pair<double,double> depth_range() const;
+
 
         /**
          * A function to register a new type. This is part of the automatic
@@ -113,7 +179,7 @@ namespace WorldBuilder
                                  void ( *)(Parameters &, const std::string &, const std::vector<std::string> &required_entries),
                                  ObjectFactory *factory);
 
-        const std::string get_name() const
+        const std::string &get_name() const
         {
           return name;
         };
@@ -125,7 +191,102 @@ namespace WorldBuilder
          */
         static std::unique_ptr<Interface> create(const std::string &name, WorldBuilder::World *world);
 
+        /**
+         * Add the memory used by this feature to the given list of
+         * components, as a name and a number of bytes. Models which are
+         * shared, for example between segments, are counted only once.
+         */
+        virtual
+        void memory_usage(std::vector<std::pair<std::string,std::size_t> > &components) const = 0;
+
+        /**
+         * Release the data which is only needed while the feature is being
+         * parsed. The default implementation does nothing.
+         */
+        virtual
+        void release_parse_data();
+
+        /**
+         * Returns the name of the plugin, which is used to create the feature
+         * again when it is loaded from a snapshot.
+         */
+        const std::string &get_plugin_name() const
+        {
+          return plugin_name;
+        }
+
+        /**
+         * Save the feature, including its models, to or load it from a
+         * snapshot. When loading, the feature and its models are also
+         * registered in the profiler.
+         */
+        virtual
+        void serialize(Snapshot &snapshot) = 0;
+
       protected:
+        /**
+         * Add the memory used by the feature object itself, including the
+         * strings of this class, and by its coordinates to the given list of
+         * components. The size of the object is passed by the derived class.
+         */
+        void
+        interface_memory_usage(std::vector<std::pair<std::string,std::size_t> > &components,
+                               const std::size_t object_size) const;
+
+        /**
+         * Save the members of this class to or load them from a snapshot.
+         */
+        void
+        serialize_interface(Snapshot &snapshot);
+
+        /**
+         * Returns the memory used by the given vector of model pointers and
+         * by the models it points to in bytes. Models which are already in
+         * counted_models are skipped, and new models are added to it.
+         */
+        template<class ModelPointers>
+        static
+        std::size_t
+        models_memory_usage(const ModelPointers &models,
+                            std::set<const void *> &counted_models)
+        {
+          std::size_t bytes = WorldBuilder::Utilities::memory_usage(models);
+          for (auto &model : models)
+            if (counted_models.insert(model.get()).second)
+              bytes += model->memory_usage();
+          return bytes;
+        }
+
+        /**
+         * Register this feature with the profiler and the query hints of the
+         * world. This should be called once in parse_entries, before the
+         * models are registered.
+         */
+        void
+        add_to_profiler();
+
+        /**
+         * Register the given models of this feature with the profiler of the
+         * world.
+         */
+        template<class ModelPointers>
+        void
+        add_models_to_profiler(const ModelPointers &models)
+        {
+          for (auto &model : models)
+            world->profiler.add_model(profiler_entry, model.get(), model->get_name());
+        }
+
+        /**
+         * The entry number of this feature in the profiler of the world.
+         */
+        unsigned int profiler_entry;
+
+        /**
+         * The entry number of this feature in the query hints of the world.
+         */
+        unsigned int query_hint_entry;
+
         /**
          * A pointer to the world class to retrieve variables.
          */
@@ -169,6 +330,10 @@ namespace WorldBuilder
          */
         std::string composition_submodule_name;
 
+        /**
+         * The name of the plugin, which is set by create().
+         */
+        std::string plugin_name;
 
       private:
         static std::map<std::string, ObjectFactory *> &get_factory_map()
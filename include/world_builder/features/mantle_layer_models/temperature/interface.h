@@ -20,6 +20,7 @@
 #ifndef _world_builder_features_mantle_layer_temperature_interface_h
 #define _world_builder_features_mantle_layer_temperature_interface_h
 
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -84,6 +85,24 @@ namespace WorldBuilder
                                    double temperature,
                                    const double feature_min_depth,
                                    const double feature_max_depth) const = 0;
+
+            /**
+             * Returns whether this model replaces the temperature at the given
+             * depth with a value which does not depend on the temperature it is
+             * given. The default implementation returns false, which is always
+             * safe.
+             */
+            virtual
+            bool replaces_temperature(const double depth) const;
+
+            /**
+             * Returns the minimum and maximum depth between which this model
+             * can change the temperature. Outside of this range it returns the
+             * temperature it is given. The default implementation returns an
+             * infinite range, which is always safe.
+             */
+            virtual
+            std::pair<double,double> depth_range() const;
             /**
              * A function to register a new type. This is part of the automatic
              * registration of the object factory.
@@ -102,11 +121,33 @@ namespace WorldBuilder
             /**
              * Returns the name of the plugin
              */
-            std::string get_name() const
+            const std::string &get_name() const
             {
               return name;
             };
 
+            /**
+             * Returns the memory used by this model in bytes, including the
+             * memory it has allocated on the heap.
+             */
+            virtual
+            std::size_t memory_usage() const;
+
+            /**
+             * Returns the name of the plugin, which is used to create the
+             * model again when it is loaded from a snapshot.
+             */
+            const std::string &get_plugin_name() const
+            {
+              return name;
+            }
+
+            /**
+             * Save the model to or load it from a snapshot.
+             */
+            virtual
+            void serialize(Snapshot &snapshot) = 0;
+
           protected:
             /**
              * A pointer to the world class to retrieve variables.
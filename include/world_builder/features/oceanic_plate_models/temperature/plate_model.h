@@ -75,6 +75,26 @@ namespace WorldBuilder
                                    const double feature_min_depth,
                                    const double feature_max_depth) const override final;
 
+            /**
+             * Returns whether this model replaces the temperature at the given depth.
+             */
+            bool replaces_temperature(const double depth) const override final;
+
+            /**
+             * Returns the minimum and maximum depth of this model.
+             */
+            std::pair<double,double> depth_range() const override final;
+
+
+            /**
+             * Returns the memory used by this model in bytes.
+             */
+            std::size_t memory_usage() const override final;
+
+            /**
+             * Save the model to or load it from a snapshot.
+             */
+            void serialize(Snapshot &snapshot) override final;
 
           private:
             // plate model temperature submodule parameters
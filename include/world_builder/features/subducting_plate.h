@@ -20,8 +20,13 @@
 #ifndef _world_feature_features_subducting_plate_h
 #define _world_feature_features_subducting_plate_h
 
+#include <world_builder/centerline_table.h>
+#include <world_builder/distance_field.h>
 #include <world_builder/features/interface.h>
 #include <world_builder/world.h>
+#include <world_builder/section_index.h>
+#include <world_builder/segment_table.h>
+#include <world_builder/slab_envelope.h>
 #include <world_builder/types/segment.h>
 
 #include <world_builder/features/subducting_plate_models/temperature/interface.h>
@@ -87,6 +92,55 @@ namespace WorldBuilder
                            const unsigned int composition_number,
                            double composition_value) const override final;
 
+        /**
+         * Computes the temperatures of a number of points, like temperature()
+         * does for one point. The distances of the points which are not
+         * interpolated from the distance field are computed together.
+         */
+        void temperatures(const size_t n_points,
+                          const double *x,
+                          const double *y,
+                          const double *z,
+                          const double *depths,
+                          const double *gravity_norms,
+                          double *temperatures) const override final;
+
+        /**
+         * Computes a composition of a number of points, like composition()
+         * does for one point.
+         */
+        void compositions(const size_t n_points,
+                          const double *x,
+                          const double *y,
+                          const double *z,
+                          const double *depths,
+                          const unsigned int composition_number,
+                          double *values) const override final;
+
+        /**
+         * Returns the minimum and maximum depth of this feature, which is
+         * also limited by the total length and thickness of the segments.
+         */
+        std::pair<double,double> depth_range() const override final;
+
+        /**
+         * Add the memory used by this feature to the given list of components.
+         */
+        void memory_usage(std::vector<std::pair<std::string,std::size_t> > &components) const override final;
+
+        /**
+         * Save the feature, including its models, to or load it from a
+         * snapshot.
+         */
+        void serialize(Snapshot &snapshot) override final;
+
+        /**
+         * Release the default segments and models, which are only used
+         * while parsing, since the segments of every section have their
+         * own copies of them.
+         */
+        void release_parse_data() override final;
+
 
 
       private:
@@ -136,14 +190,109 @@ namespace WorldBuilder
          */
         Point<2> reference_point;
 
-        std::vector<std::vector<double> > slab_segment_lengths;
-        std::vector<std::vector<Point<2> > > slab_segment_thickness;
-        std::vector<std::vector<Point<2> > > slab_segment_top_truncation;
-        std::vector<std::vector<Point<2> > > slab_segment_angles;
-        std::vector<double> total_slab_length;
+        /**
+         * The lengths, thicknesses, top truncations and angles of the
+         * segments of every section, and the total length of every section,
+         * which are filled from the segment_vector.
+         */
+        SegmentTable segment_table;
+
+        /**
+         * The models of the segments of every section, which are filled from
+         * the segment_vector.
+         */
+        SegmentModelTable<Features::SubductingPlateModels::Temperature::Interface> temperature_model_table;
+        SegmentModelTable<Features::SubductingPlateModels::Composition::Interface> composition_model_table;
+
         double maximum_total_slab_length;
         double maximum_slab_thickness;
 
+        /**
+         * The sections of the coordinates which can contain a point. This
+         * is only built for cartesian coordinate systems.
+         */
+        SectionIndex section_index;
+
+        /**
+         * A conservative envelope of the points which can be in the
+         * feature. This is only built for spherical coordinate systems.
+         */
+        SlabEnvelope slab_envelope;
+
+        /**
+         * Fill the segment_table and the model tables from the
+         * segment_vector, compute the maximum total length and thickness,
+         * and build the centerline_table, the section_index or the
+         * slab_envelope, and the distance_field.
+         */
+        void fill_segment_tables();
+
+        /**
+         * The number of fractions at which the centerline_table stores the
+         * sections with changing angles, and the table itself.
+         */
+        unsigned int centerline_table_fractions;
+        CenterlineTable centerline_table;
+
+        /**
+         * The cell size and tolerance of the optional distance field, and
+         * the field itself, which is only built when the cell size is larger
+         * than zero and the coordinate system is cartesian.
+         */
+        double distance_field_resolution;
+        double distance_field_tolerance;
+        DistanceField distance_field;
+
+        /**
+         * Returns the distance of the position to the planes of the feature,
+         * interpolated from the distance field if possible, and computed
+         * otherwise.
+         */
+        WorldBuilder::Utilities::PointDistanceFromCurvedPlanes
+        compute_distance_from_planes(const Point<3> &position, const double starting_radius) const;
+
+        /**
+         * Whether the position may be in the feature, based on the
+         * section_index or the slab_envelope. When this returns false, the
+         * position is certainly not in the feature.
+         */
+        bool may_contain(const Point<3> &position,
+                         const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                         const double starting_radius) const;
+
+        /**
+         * Calls the given function with the index and the distance to the
+         * planes of every point which may be in the feature. The distances
+         * which are not interpolated from the distance field are computed
+         * in blocks, so the points are not visited in order.
+         */
+        template<class Function>
+        void for_each_distance_from_planes(const size_t n_points,
+                                           const double *x,
+                                           const double *y,
+                                           const double *z,
+                                           const double *depths,
+                                           const Function &function) const;
+
+        /**
+         * Applies the temperature and composition models of the segment in
+         * which the closest point on the planes lies, when the position is
+         * inside the slab.
+         */
+        double apply_temperature_models(const Point<3> &position,
+                                        const double depth,
+                                        const double gravity_norm,
+                                        double temperature,
+                                        WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes,
+                                        Profiler::Scope &scope) const;
+
+        double apply_composition_models(const Point<3> &position,
+                                        const double depth,
+                                        const unsigned int composition_number,
+                                        double composition,
+                                        WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes,
+                                        Profiler::Scope &scope) const;
+
     };
   }
 }
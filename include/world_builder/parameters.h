@@ -89,10 +89,33 @@ namespace WorldBuilder
       ~Parameters();
 
       /**
-       * Todo
+       * Read the world builder file and validate it against the declarations.
+       * When has_output_dir is true, the declarations are also written to
+       * output_dir, see write_declarations().
+       *
+       * The schema which is compiled from the declarations is shared by all
+       * worlds in the process, and a file is not validated again when a file
+       * with the same content has already been validated successfully
+       * against the same declarations.
        */
       void initialize(std::string &filename, bool has_output_dir = false, std::string output_dir = "");
 
+      /**
+       * Write the declarations as a LaTeX file and as a json schema to
+       * world_buider_declarations.tex and world_buider_declarations.schema.json
+       * in the given directory.
+       */
+      void write_declarations(const std::string &output_dir) const;
+
+      /**
+       * Release the json documents with the declarations and the parameters,
+       * and the other state which is only needed while the world is being
+       * parsed, like the parse-only state of the features. The features and
+       * the coordinate system are kept, so the world can still be evaluated,
+       * but no parameters can be retrieved anymore afterwards.
+       */
+      void release_parse_data();
+
       /**
        * Todo
        */
@@ -249,7 +272,53 @@ namespace WorldBuilder
        */
       //std::string get_full_path_without_arrays() const;
 
+      /**
+       * Returns the memory used by the caches of the json pointer lookups in
+       * bytes.
+       */
+      std::size_t lookup_cache_memory_usage() const;
+
     private:
+      /**
+       * Returns the value at the given json pointer in the parameters, or
+       * NULL if there is no value. The same pointers are looked up many times
+       * while the features are parsed, so every pointer is only parsed and
+       * resolved once, after which the result is cached.
+       */
+      const rapidjson::Value *get_parameter_value(const std::string &json_pointer) const;
+
+      /**
+       * Returns the value at the given json pointer in the declarations, or
+       * NULL if there is no value. The result is cached like in
+       * get_parameter_value().
+       */
+      const rapidjson::Value *get_declaration_value(const std::string &json_pointer) const;
+
+      /**
+       * Clear the caches of the json pointer lookups. This has to be called
+       * whenever the parameters or declarations are changed, since changing a
+       * json document may move its values.
+       */
+      void clear_lookup_caches();
+
+      /**
+       * The current path in json pointer format, which is updated by
+       * enter_subsection() and leave_subsection(), so that it does not have
+       * to be built from the path for every lookup.
+       */
+      std::string full_json_path;
+
+      /**
+       * The caches of get_parameter_value() and get_declaration_value().
+       */
+      mutable std::unordered_map<std::string, const rapidjson::Value *> parameter_value_cache;
+      mutable std::unordered_map<std::string, const rapidjson::Value *> declaration_value_cache;
+
+      /**
+       * A cache of get_full_json_schema_path(), with the schema path for json
+       * paths of which the schema path has already been determined.
+       */
+      mutable std::unordered_map<std::string, std::string> schema_path_cache;
 
 
       /**
@@ -0,0 +1,261 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_profiler_h
+#define _world_builder_profiler_h
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <world_builder/thread_slots.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class collects performance counters for every feature and for every
+   * temperature and composition model of a world: the number of calls, the
+   * number of calls which were rejected early (for example because the point
+   * is outside of the polygon of a plate), the number of calls which hit the
+   * feature or changed the value for a model, and the total time spent.
+   *
+   * The features and models are registered while the world is created. The
+   * counters are only collected when the profiler is enabled. Every thread
+   * collects its own counters, which are only merged when a report is
+   * requested, so the counters do not need to be synchronized between
+   * threads. Note that a report should not be requested while other threads
+   * are evaluating the world.
+   */
+  class Profiler
+  {
+    public:
+      /**
+       * Which quantity is being computed.
+       */
+      enum Quantity
+      {
+        temperature = 0,
+        composition = 1
+      };
+
+      /**
+       * The counters collected for one entry and quantity.
+       */
+      struct Counters
+      {
+        Counters();
+
+        /**
+         * Add the counters of another thread to these counters.
+         */
+        void merge(const Counters &other);
+
+        unsigned long long calls;
+        unsigned long long early_rejects;
+        unsigned long long hits;
+        double time;
+      };
+
+      /**
+       * Measures the time between its creation and destruction and adds it,
+       * together with one call, to the counters of the current thread for the
+       * given entry. When the profiler is disabled, this does nothing.
+       */
+      class Scope
+      {
+        public:
+          Scope(const Profiler &profiler, const unsigned int entry, const Quantity quantity);
+
+          /**
+           * Constructor for a model, which is looked up by its address. The
+           * lookup is only done when the profiler is enabled.
+           */
+          Scope(const Profiler &profiler, const void *model, const Quantity quantity);
+
+          ~Scope();
+
+          /**
+           * Record that this call was rejected early.
+           */
+          void early_reject();
+
+          /**
+           * Record that this call hit the feature or changed the value.
+           */
+          void hit();
+
+          /**
+           * Record a hit when the value was changed by a model.
+           */
+          void hit_if_changed(const double old_value, const double new_value);
+
+        private:
+          Counters *counters;
+          std::chrono::steady_clock::time_point start;
+      };
+
+      /**
+       * Constructor. The profiler is disabled by default.
+       */
+      Profiler();
+
+      /**
+       * Destructor
+       */
+      ~Profiler();
+
+      /**
+       * Enable or disable the collection of the counters. This may be done
+       * while other threads are querying the world, which then start or stop
+       * collecting with their next query.
+       */
+      void set_enabled(const bool enabled);
+
+      /**
+       * Whether the counters are collected.
+       */
+      bool is_enabled() const
+      {
+        return enabled.load(std::memory_order_relaxed);
+      }
+
+      /**
+       * Register a feature with the given name and return its entry number.
+       */
+      unsigned int add_feature(const std::string &name);
+
+      /**
+       * Register a model of the feature with the given entry number. The
+       * model is identified by its address, so that models which are shared
+       * between for example the segments of a slab, are counted together.
+       */
+      void add_model(const unsigned int feature, const void *model, const std::string &name);
+
+      /**
+       * Return the entry number of a registered model.
+       */
+      unsigned int get_model_entry(const void *model) const;
+
+      /**
+       * Reset all the counters to zero.
+       */
+      void reset();
+
+      /**
+       * Return the counters of all threads merged together, for the given
+       * entry and quantity.
+       */
+      Counters get_counters(const unsigned int entry, const Quantity quantity) const;
+
+      /**
+       * Return a table with the merged counters of all the features and
+       * models. The time of a feature includes the time of its models.
+       */
+      std::string report() const;
+
+    private:
+      /**
+       * Return the counters of the current thread for the given entry and
+       * quantity.
+       */
+      Counters &get_thread_counters(const unsigned int entry, const Quantity quantity) const;
+
+      /**
+       * Whether the counters are collected. It is read by every query, so
+       * it is atomic, and it does not order any other memory accesses.
+       */
+      std::atomic<bool> enabled;
+
+      /**
+       * The names of the features and models, where the model name is empty
+       * for a feature.
+       */
+      std::vector<std::pair<std::string,std::string> > entries;
+
+      /**
+       * The entry numbers of the registered models.
+       */
+      std::map<const void *, unsigned int> model_entries;
+
+      /**
+       * The counters of every thread which uses this profiler.
+       */
+      ThreadSlots<Counters> thread_counters;
+  };
+
+
+  inline
+  Profiler::Scope::Scope(const Profiler &profiler, const unsigned int entry, const Quantity quantity)
+    :
+    counters(profiler.is_enabled() ? &profiler.get_thread_counters(entry, quantity) : nullptr)
+  {
+    if (counters != nullptr)
+      {
+        ++counters->calls;
+        start = std::chrono::steady_clock::now();
+      }
+  }
+
+  inline
+  Profiler::Scope::Scope(const Profiler &profiler, const void *model, const Quantity quantity)
+    :
+    counters(profiler.is_enabled() ? &profiler.get_thread_counters(profiler.get_model_entry(model), quantity) : nullptr)
+  {
+    if (counters != nullptr)
+      {
+        ++counters->calls;
+        start = std::chrono::steady_clock::now();
+      }
+  }
+
+  inline
+  Profiler::Scope::~Scope()
+  {
+    if (counters != nullptr)
+      counters->time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  inline
+  void
+  Profiler::Scope::early_reject()
+  {
+    if (counters != nullptr)
+      ++counters->early_rejects;
+  }
+
+  inline
+  void
+  Profiler::Scope::hit()
+  {
+    if (counters != nullptr)
+      ++counters->hits;
+  }
+
+  inline
+  void
+  Profiler::Scope::hit_if_changed(const double old_value, const double new_value)
+  {
+    if (counters != nullptr && (old_value < new_value || old_value > new_value))
+      ++counters->hits;
+  }
+}
+
+#endif
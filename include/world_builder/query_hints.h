@@ -0,0 +1,178 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_query_hints_h
+#define _world_builder_query_hints_h
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <world_builder/thread_slots.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class stores, for every feature and every thread, what was found
+   * for the previous point which was queried. Host codes and the visualizer
+   * usually query points in mesh order, so the next point is often close to
+   * the previous one, and the stored results can be reused for it.
+   *
+   * A hint stores the surface position of the previous point and a distance
+   * around it within which the reused part of the result can not change.
+   * For the polygon of a plate, this is the distance to the boundary of the
+   * polygon. For the trench of a slab or fault, it is the distance to the
+   * ends of the sections, which determines which sections the point lies
+   * next to. Points outside of this distance are searched in full, and the
+   * hint is replaced, so the results are the same with and without hints.
+   *
+   * The hints are only used when they are enabled. Every thread has its own
+   * hints, so they do not need to be synchronized between threads. Like for
+   * the profiler, a report should not be requested while other threads are
+   * evaluating the world.
+   */
+  class QueryHints
+  {
+    public:
+      /**
+       * Whether the previous point was inside the polygon of a feature.
+       */
+      struct PolygonHint
+      {
+        PolygonHint();
+
+        bool valid;
+        std::array<double,2> point;
+        double safe_distance;
+        bool inside;
+
+        unsigned long long lookups;
+        unsigned long long hits;
+      };
+
+      /**
+       * The sections of a trench next to which the previous point lies,
+       * in increasing order, and the candidate sections of the section
+       * index which they were selected from, if an index was used.
+       */
+      struct SectionHint
+      {
+        SectionHint();
+
+        bool valid;
+        std::array<double,2> point;
+        double safe_distance;
+        const unsigned int *candidate_sections;
+        std::vector<unsigned int> sections;
+
+        unsigned long long lookups;
+        unsigned long long hits;
+      };
+
+      /**
+       * The hints of one feature for one thread.
+       */
+      struct FeatureHints
+      {
+        PolygonHint polygon;
+        SectionHint section;
+      };
+
+      /**
+       * Constructor. The hints are disabled by default.
+       */
+      QueryHints();
+
+      /**
+       * Enable or disable the hints.
+       */
+      void set_enabled(const bool enabled);
+
+      /**
+       * Whether the hints are used.
+       */
+      bool is_enabled() const
+      {
+        return enabled;
+      }
+
+      /**
+       * Register a feature with the given name and return its entry number.
+       */
+      unsigned int add_feature(const std::string &name);
+
+      /**
+       * Return the polygon hint of the current thread for the given entry,
+       * or a null pointer when the hints are disabled.
+       */
+      PolygonHint *get_polygon(const unsigned int entry) const
+      {
+        return enabled ? &get_thread_hints(entry).polygon : nullptr;
+      }
+
+      /**
+       * Return the section hint of the current thread for the given entry,
+       * or a null pointer when the hints are disabled.
+       */
+      SectionHint *get_section(const unsigned int entry) const
+      {
+        return enabled ? &get_thread_hints(entry).section : nullptr;
+      }
+
+      /**
+       * Return the number of lookups and hits of the given entry, summed
+       * over all threads and over the polygon and section hints.
+       */
+      std::pair<unsigned long long,unsigned long long> get_counters(const unsigned int entry) const;
+
+      /**
+       * Forget the hints and reset the counters of all threads.
+       */
+      void reset();
+
+      /**
+       * Return a table with the number of lookups and hits and the hit rate
+       * of every feature.
+       */
+      std::string report() const;
+
+    private:
+      /**
+       * Return the hints of the current thread for the given entry.
+       */
+      FeatureHints &get_thread_hints(const unsigned int entry) const;
+
+      /**
+       * Whether the hints are used.
+       */
+      bool enabled;
+
+      /**
+       * The names of the features.
+       */
+      std::vector<std::string> names;
+
+      /**
+       * The hints of every thread which uses this object.
+       */
+      ThreadSlots<FeatureHints> thread_hints;
+  };
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_section_index_h
+#define _world_builder_section_index_h
+
+#include <cstddef>
+#include <vector>
+
+#include <world_builder/point.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class finds the sections of the surface trace of a slab or fault
+   * which can contain a point, so that the distance of the point to the
+   * slab does not have to be computed for every section of a long trench.
+   *
+   * A section is the line between two consecutive points of the trace. The
+   * slab below a section can only reach points which are within the given
+   * reach of the line, measured perpendicular to it, and which lie between
+   * the two lines through the end points perpendicular to the section.
+   * This strip is inserted into every cell of a uniform grid which it
+   * touches, and a query returns the sections of the cell of the point, in
+   * increasing order.
+   *
+   * The index works in the natural coordinates of a cartesian coordinate
+   * system, in which the horizontal distance to the trace is a lower bound
+   * of the distance to the slab.
+   */
+  class SectionIndex
+  {
+    public:
+      /**
+       * The sections which can contain a point, which can be used in a
+       * range based for loop.
+       */
+      class Range
+      {
+        public:
+          Range(const unsigned int *begin_, const unsigned int *end_)
+            :
+            range_begin(begin_),
+            range_end(end_)
+          {}
+
+          const unsigned int *begin() const
+          {
+            return range_begin;
+          }
+
+          const unsigned int *end() const
+          {
+            return range_end;
+          }
+
+          std::size_t size() const
+          {
+            return static_cast<std::size_t>(range_end - range_begin);
+          }
+
+        private:
+          const unsigned int *range_begin;
+          const unsigned int *range_end;
+      };
+
+      /**
+       * Constructor for an empty index, which is not used.
+       */
+      SectionIndex();
+
+      /**
+       * Build the index for the sections between the given points, where
+       * the slab below every section can reach points up to the given
+       * horizontal distance from it.
+       */
+      void reinit(const std::vector<Point<2> > &point_list, const double reach);
+
+      /**
+       * Remove the index, so that it is no longer used.
+       */
+      void clear();
+
+      /**
+       * Whether the index has been built.
+       */
+      bool is_initialized() const
+      {
+        return initialized;
+      }
+
+      /**
+       * Returns the sections which can contain the given point, in
+       * increasing order.
+       */
+      Range sections(const Point<2> &point) const;
+
+      /**
+       * Returns the memory used by the index in bytes.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      bool initialized;
+
+      /**
+       * The lower left corner of the grid, the size of a cell and the
+       * number of cells in both directions.
+       */
+      double origin[2];
+      double cell_size;
+      std::size_t n_cells[2];
+
+      /**
+       * The index in cell_sections of the first section of every cell, with
+       * one extra entry for the end of the last cell.
+       */
+      std::vector<std::size_t> cell_offsets;
+      std::vector<unsigned int> cell_sections;
+  };
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_segment_table_h
+#define _world_builder_segment_table_h
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace WorldBuilder
+{
+  /**
+   * This class stores the lengths, thicknesses, top truncations and angles
+   * of the segments of every section of a slab or fault in one contiguous
+   * block of memory, so that a query does not have to follow the pointers
+   * of nested vectors.
+   *
+   * The table is stored as a structure of arrays: every field has a row per
+   * section, which contains the value of that field for every segment of the
+   * section. Every row starts at a cache line boundary. All the sections
+   * must have the same number of segments, which is required by the
+   * features.
+   */
+  class SegmentTable
+  {
+    public:
+      /**
+       * The fields which are stored for every segment. The thickness, top
+       * truncation and angle are given at the top and the bottom of the
+       * segment. The angles are in radians.
+       */
+      enum Field
+      {
+        length = 0,
+        thickness_top,
+        thickness_bottom,
+        top_truncation_top,
+        top_truncation_bottom,
+        angle_top,
+        angle_bottom,
+        n_fields
+      };
+
+      /**
+       * Constructor for an empty table.
+       */
+      SegmentTable();
+
+      /**
+       * Resize the table to the given number of sections and segments per
+       * section. All the values are set to zero.
+       */
+      void reinit(const std::size_t n_sections, const std::size_t n_segments);
+
+      /**
+       * The number of sections in the table.
+       */
+      std::size_t n_sections() const
+      {
+        return number_of_sections;
+      }
+
+      /**
+       * The number of segments of every section.
+       */
+      std::size_t n_segments() const
+      {
+        return number_of_segments;
+      }
+
+      /**
+       * Access the value of a field of a segment of a section.
+       */
+      double &operator()(const Field field, const std::size_t section, const std::size_t segment)
+      {
+        return data[(field * number_of_sections + section) * row_stride + segment];
+      }
+
+      /**
+       * Access the value of a field of a segment of a section.
+       */
+      double operator()(const Field field, const std::size_t section, const std::size_t segment) const
+      {
+        return data[(field * number_of_sections + section) * row_stride + segment];
+      }
+
+      /**
+       * Access the sum of the lengths of the segments of a section.
+       */
+      double &total_length(const std::size_t section)
+      {
+        return data[n_fields * number_of_sections * row_stride + section];
+      }
+
+      /**
+       * Access the sum of the lengths of the segments of a section.
+       */
+      double total_length(const std::size_t section) const
+      {
+        return data[n_fields * number_of_sections * row_stride + section];
+      }
+
+      /**
+       * Returns the memory used by the table in bytes.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      std::size_t number_of_sections;
+      std::size_t number_of_segments;
+
+      /**
+       * The number of values between the start of two rows, which is the
+       * number of segments rounded up to a whole cache line.
+       */
+      std::size_t row_stride;
+
+      /**
+       * The allocated memory, and the start of the table in it, which is
+       * aligned to a cache line.
+       */
+      std::unique_ptr<double[]> storage;
+      std::size_t storage_size;
+      double *data;
+  };
+
+
+  /**
+   * This class stores the models of every segment of every section of a
+   * slab or fault as one flat array of pointers, so that the models of a
+   * segment can be called without following the pointers of the nested
+   * vectors of segments and the shared pointers of the models. The models
+   * are owned elsewhere, so the table has to be filled again when the
+   * models change.
+   */
+  template<class Model>
+  class SegmentModelTable
+  {
+    public:
+      /**
+       * The models of one segment, which can be used in a range based for
+       * loop.
+       */
+      class Range
+      {
+        public:
+          Range(const Model *const *begin_, const Model *const *end_)
+            :
+            range_begin(begin_),
+            range_end(end_)
+          {}
+
+          const Model *const *begin() const
+          {
+            return range_begin;
+          }
+
+          const Model *const *end() const
+          {
+            return range_end;
+          }
+
+        private:
+          const Model *const *range_begin;
+          const Model *const *range_end;
+      };
+
+      /**
+       * Constructor for an empty table.
+       */
+      SegmentModelTable()
+        :
+        number_of_segments(0),
+        offsets(1, 0)
+      {}
+
+      /**
+       * Remove all the models and set the number of segments of every
+       * section.
+       */
+      void reinit(const std::size_t n_segments)
+      {
+        number_of_segments = n_segments;
+        models.clear();
+        offsets.assign(1, 0);
+      }
+
+      /**
+       * Add the models of the next segment. The segments are added section
+       * by section.
+       */
+      void add_segment(const std::vector<std::shared_ptr<Model> > &segment_models)
+      {
+        for (auto &model : segment_models)
+          models.push_back(model.get());
+        offsets.push_back(models.size());
+      }
+
+      /**
+       * The models of a segment of a section.
+       */
+      Range operator()(const std::size_t section, const std::size_t segment) const
+      {
+        const std::size_t index = section * number_of_segments + segment;
+        return Range(models.data() + offsets[index], models.data() + offsets[index + 1]);
+      }
+
+      /**
+       * Returns the memory used by the table in bytes.
+       */
+      std::size_t memory_usage() const
+      {
+        return models.capacity() * sizeof(const Model *) + offsets.capacity() * sizeof(std::size_t);
+      }
+
+    private:
+      std::size_t number_of_segments;
+
+      std::vector<const Model *> models;
+
+      /**
+       * The index of the first model of every segment in the models, with
+       * one extra entry for the end of the last segment.
+       */
+      std::vector<std::size_t> offsets;
+  };
+}
+
+#endif
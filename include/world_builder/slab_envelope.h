@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_slab_envelope_h
+#define _world_builder_slab_envelope_h
+
+#include <cstddef>
+#include <vector>
+
+#include <world_builder/point.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This class is a conservative envelope of the points which can be in a
+   * slab or fault in a spherical coordinate system, so that most points
+   * which are far away from it can be rejected before the distance to the
+   * slab is computed. In a cartesian coordinate system the SectionIndex is
+   * used for this.
+   *
+   * A point in the slab is at most the reach (the total length of the
+   * segments plus the thickness) away from a point on the surface trace at
+   * the surface radius, measured in the plane in which the slab is
+   * computed. Since the point is not above the surface, the angle between
+   * the point and that point on the trace is at most arccos(1 - reach /
+   * surface radius). Every section of the trace is covered by a cap on the
+   * unit sphere around its center, and the point has to be within that
+   * angle of one of these caps.
+   */
+  class SlabEnvelope
+  {
+    public:
+      /**
+       * Constructor for an empty envelope, which contains all points.
+       */
+      SlabEnvelope();
+
+      /**
+       * Build the envelope for the sections between the given points, which
+       * are given in natural spherical coordinates (longitude and latitude
+       * in radians), where points in the slab can be up to the given
+       * distance away from the trace.
+       */
+      void reinit(const std::vector<Point<2> > &point_list, const double reach);
+
+      /**
+       * Remove the envelope, so that it contains all points.
+       */
+      void clear();
+
+      /**
+       * Whether the envelope has been built.
+       */
+      bool is_initialized() const
+      {
+        return initialized;
+      }
+
+      /**
+       * Whether the given cartesian position may be in the slab, when the
+       * surface above it is at the given radius. The position may not be
+       * above the surface.
+       */
+      bool may_contain(const Point<3> &position, const double surface_radius) const;
+
+      /**
+       * Returns the memory used by the envelope in bytes.
+       */
+      std::size_t memory_usage() const;
+
+    private:
+      /**
+       * A cap on the unit sphere, given by its center and the cosine and
+       * sine of its angular radius.
+       */
+      struct Cap
+      {
+        double center[3];
+        double cos_radius;
+        double sin_radius;
+      };
+
+      bool initialized;
+      double reach;
+
+      /**
+       * A cap which contains the caps of all the sections, and the caps of
+       * the sections.
+       */
+      Cap bounding_cap;
+      std::vector<Cap> caps;
+  };
+}
+
+#endif
@@ -0,0 +1,374 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_snapshot_h
+#define _world_builder_snapshot_h
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <world_builder/assert.h>
+#include <world_builder/point.h>
+
+namespace WorldBuilder
+{
+  class World;
+
+  /**
+   * This class stores a fully parsed world in a binary snapshot, and loads a
+   * world from such a snapshot, so that the parsing and validation of the
+   * world builder file and the parsing of the features do not have to be
+   * repeated every time a world is created.
+   *
+   * The same serialize() functions of the world, the features and the models
+   * are used to save and to load a snapshot. They call the snapshot with
+   * their members, which are written to the snapshot when saving, and read
+   * from it when loading. A snapshot is loaded by mapping the file into
+   * memory where this is supported.
+   *
+   * A snapshot is only valid for the version of the World Builder which has
+   * written it, because the members of the classes may change between
+   * versions.
+   */
+  class Snapshot
+  {
+    public:
+      /**
+       * The version of the snapshot format, which is increased when the
+       * format changes in an incompatible way.
+       */
+      static const std::uint32_t format_version = 4;
+
+      /**
+       * Constructor for saving a world to a snapshot.
+       */
+      Snapshot(World *world);
+
+      /**
+       * Constructor for loading a world from the snapshot in the given file.
+       * The header of the file is checked.
+       */
+      Snapshot(World *world, const std::string &filename);
+
+      /**
+       * Destructor, which unmaps the file when loading.
+       */
+      ~Snapshot();
+
+      /**
+       * Whether the given file is a snapshot. This only checks the first
+       * bytes of the file, so that a world builder file can be told apart
+       * from a snapshot.
+       */
+      static bool is_snapshot(const std::string &filename);
+
+      /**
+       * Whether the snapshot is being loaded. Otherwise it is being saved.
+       */
+      bool is_loading() const
+      {
+        return loading;
+      }
+
+      /**
+       * Write the saved snapshot to the given file.
+       */
+      void write(const std::string &filename) const;
+
+      /**
+       * Check that the whole snapshot has been read when loading.
+       */
+      void finish() const;
+
+      /**
+       * Save or load a value which can be copied byte for byte, like a
+       * number or an enum.
+       */
+      template<class T>
+      typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+      operator()(T &value);
+
+      /**
+       * Save or load an object which has a serialize(Snapshot &) function.
+       */
+      template<class T>
+      typename std::enable_if<!std::is_trivially_copyable<T>::value>::type
+      operator()(T &object);
+
+      /**
+       * Save or load a string.
+       */
+      void operator()(std::string &string);
+
+      /**
+       * Save or load a point.
+       */
+      template<int dim>
+      void operator()(Point<dim> &point);
+
+      /**
+       * Save or load a vector. Vectors of values which can be copied byte
+       * for byte are saved as one block.
+       */
+      template<class T>
+      void operator()(std::vector<T> &vector);
+
+      /**
+       * Save or load a plugin object, like a feature or a model, by the name
+       * of its plugin and its members. When loading, the object is created
+       * with the create() function of its interface class.
+       */
+      template<class T>
+      void operator()(std::unique_ptr<T> &object);
+
+      /**
+       * Save or load a plugin object which may be shared between several
+       * owners, like the models of the segments of a slab. An object which
+       * is shared is saved only once, and it is shared again when loading.
+       */
+      template<class T>
+      void operator()(std::shared_ptr<T> &object);
+
+      /**
+       * Save or load several values at once.
+       */
+      template<class T, class ... Rest>
+      void operator()(T &first, Rest &... rest);
+
+    private:
+      /**
+       * Append the given bytes to the snapshot.
+       */
+      void write_bytes(const void *bytes, const std::size_t n);
+
+      /**
+       * Copy the next bytes of the snapshot to the given memory.
+       */
+      void read_bytes(void *bytes, const std::size_t n);
+
+      /**
+       * Save or load the size of a container. When loading, the size is
+       * checked against the number of bytes left in the snapshot, given the
+       * minimum number of bytes an element takes in the snapshot, so that a
+       * corrupt snapshot is reported before the container is allocated.
+       */
+      std::size_t container_size(const std::size_t size, const std::size_t element_size);
+
+      /**
+       * Save or load a vector of values which can be copied byte for byte.
+       */
+      template<class T>
+      void vector(std::vector<T> &vector, std::true_type);
+
+      /**
+       * Save or load a vector of other objects.
+       */
+      template<class T>
+      void vector(std::vector<T> &vector, std::false_type);
+
+      /**
+       * Create an object which is read from a snapshot when loading a vector.
+       */
+      template<class T>
+      struct EmptyObject
+      {
+        static T create()
+        {
+          return T();
+        }
+      };
+
+      template<int dim>
+      struct EmptyObject<Point<dim> >
+      {
+        static Point<dim> create()
+        {
+          return Point<dim>(cartesian);
+        }
+      };
+
+      World *world;
+
+      bool loading;
+
+      /**
+       * The snapshot while it is saved.
+       */
+      std::vector<char> buffer;
+
+      /**
+       * The snapshot while it is loaded, which is either mapped into memory
+       * or read into loaded_file.
+       */
+      const char *data;
+      std::size_t data_size;
+      std::size_t position;
+      void *mapped_data;
+      std::vector<char> loaded_file;
+
+      /**
+       * The shared objects which have been saved, with their number.
+       */
+      std::map<const void *, std::uint32_t> saved_shared_objects;
+
+      /**
+       * The shared objects which have been loaded, by their number.
+       */
+      std::vector<std::shared_ptr<void> > loaded_shared_objects;
+  };
+
+
+  template<class T>
+  typename std::enable_if<std::is_trivially_copyable<T>::value>::type
+  Snapshot::operator()(T &value)
+  {
+    if (loading)
+      read_bytes(&value, sizeof(T));
+    else
+      write_bytes(&value, sizeof(T));
+  }
+
+  template<class T>
+  typename std::enable_if<!std::is_trivially_copyable<T>::value>::type
+  Snapshot::operator()(T &object)
+  {
+    object.serialize(*this);
+  }
+
+  template<int dim>
+  void
+  Snapshot::operator()(Point<dim> &point)
+  {
+    std::array<double,dim> coordinates = point.get_array();
+    CoordinateSystem coordinate_system = point.get_coordinate_system();
+    (*this)(coordinates);
+    (*this)(coordinate_system);
+    if (loading)
+      point = Point<dim>(coordinates, coordinate_system);
+  }
+
+  template<class T>
+  void
+  Snapshot::operator()(std::vector<T> &vector)
+  {
+    this->vector(vector, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+  }
+
+  template<class T>
+  void
+  Snapshot::vector(std::vector<T> &vector, std::true_type)
+  {
+    const std::size_t n = container_size(vector.size(), sizeof(T));
+    if (loading)
+      {
+        vector.resize(n);
+        read_bytes(vector.data(), n * sizeof(T));
+      }
+    else
+      write_bytes(vector.data(), n * sizeof(T));
+  }
+
+  template<class T>
+  void
+  Snapshot::vector(std::vector<T> &vector, std::false_type)
+  {
+    // Every object takes at least one byte in the snapshot.
+    const std::size_t n = container_size(vector.size(), 1);
+    if (loading)
+      {
+        vector.clear();
+        vector.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+          {
+            vector.push_back(EmptyObject<T>::create());
+            (*this)(vector.back());
+          }
+      }
+    else
+      for (auto &element : vector)
+        (*this)(element);
+  }
+
+  template<class T>
+  void
+  Snapshot::operator()(std::unique_ptr<T> &object)
+  {
+    std::string plugin_name = loading ? "" : object->get_plugin_name();
+    (*this)(plugin_name);
+    if (loading)
+      object = T::create(plugin_name, world);
+    object->serialize(*this);
+  }
+
+  template<class T>
+  void
+  Snapshot::operator()(std::shared_ptr<T> &object)
+  {
+    if (loading)
+      {
+        std::uint32_t number = 0;
+        (*this)(number);
+        if (number < loaded_shared_objects.size())
+          {
+            object = std::static_pointer_cast<T>(loaded_shared_objects[number]);
+            return;
+          }
+
+        WBAssertThrow(number == loaded_shared_objects.size(), "The snapshot is corrupt: shared object " << number
+                      << " is loaded before shared object " << loaded_shared_objects.size() << ".");
+        std::unique_ptr<T> new_object;
+        (*this)(new_object);
+        object = std::move(new_object);
+        loaded_shared_objects.push_back(object);
+      }
+    else
+      {
+        auto saved_object = saved_shared_objects.find(object.get());
+        if (saved_object != saved_shared_objects.end())
+          {
+            (*this)(saved_object->second);
+            return;
+          }
+
+        std::uint32_t number = static_cast<std::uint32_t>(saved_shared_objects.size());
+        saved_shared_objects[object.get()] = number;
+        (*this)(number);
+
+        std::string plugin_name = object->get_plugin_name();
+        (*this)(plugin_name);
+        object->serialize(*this);
+      }
+  }
+
+  template<class T, class ... Rest>
+  void
+  Snapshot::operator()(T &first, Rest &... rest)
+  {
+    (*this)(first);
+    (*this)(rest...);
+  }
+}
+
+#endif
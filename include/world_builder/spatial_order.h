@@ -0,0 +1,121 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_spatial_order_h
+#define _world_builder_spatial_order_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WorldBuilder
+{
+  namespace CoordinateSystems
+  {
+    class Interface;
+  }
+
+  /**
+   * This class determines an order of a set of points along a Z-order
+   * (Morton) curve through their natural coordinates, in which points which
+   * are close to each other in space are mostly close to each other in the
+   * order. When the points of a batched query arrive in an arbitrary order,
+   * for example from a redistributed unstructured mesh, evaluating them in
+   * this order lets the features reuse what they found for the previous
+   * points and keeps their memory accesses local.
+   *
+   * The natural coordinates of the points are scaled to the bounding box of
+   * the points and quantized to 21 bits each, which are interleaved into a
+   * 63 bit key. The keys are sorted with a stable radix sort, which can use
+   * several threads for large sets of points. The order is only used when
+   * it is enabled.
+   */
+  class SpatialOrder
+  {
+    public:
+      /**
+       * Constructor. The order is disabled by default and sorts with one
+       * thread.
+       */
+      SpatialOrder();
+
+      /**
+       * Enable or disable the order.
+       */
+      void set_enabled(const bool enabled);
+
+      /**
+       * Whether the order is used.
+       */
+      bool is_enabled() const
+      {
+        return enabled;
+      }
+
+      /**
+       * Set the maximum number of threads used for sorting the keys. If it
+       * is zero, the number of hardware threads is used. Small sets of
+       * points are always sorted with one thread.
+       */
+      void set_n_threads(const unsigned int n_threads);
+
+      /**
+       * Fill permutation with the indices of the n_points given cartesian
+       * points, ordered along the Z-order curve through their natural
+       * coordinates in the given coordinate system. Points with the same key
+       * keep their original order.
+       */
+      void compute_permutation(const size_t n_points,
+                               const double *x,
+                               const double *y,
+                               const double *z,
+                               const CoordinateSystems::Interface &coordinate_system,
+                               std::vector<size_t> &permutation) const;
+
+      /**
+       * Returns the Morton key of a point with the given quantized
+       * coordinates, of which only the lowest 21 bits are used. Bit i of x,
+       * y and z becomes bit 3i, 3i+1 and 3i+2 of the key.
+       */
+      static std::uint64_t morton_key(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z);
+
+      /**
+       * Fill permutation with the indices of the keys in increasing order of
+       * the keys, using at most n_threads threads. Equal keys keep their
+       * original order, so the result does not depend on the number of
+       * threads.
+       */
+      static void radix_sort(const std::vector<std::uint64_t> &keys,
+                             std::vector<size_t> &permutation,
+                             unsigned int n_threads);
+
+    private:
+      /**
+       * Whether the order is used.
+       */
+      bool enabled;
+
+      /**
+       * The maximum number of threads used for sorting the keys.
+       */
+      unsigned int n_threads;
+  };
+}
+
+#endif
@@ -0,0 +1,81 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_thread_chunks_h
+#define _world_builder_thread_chunks_h
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace WorldBuilder
+{
+  namespace Utilities
+  {
+    /**
+     * Splits the range [0,n) in n_threads contiguous chunks and calls
+     * function(thread,begin,end) for each chunk on its own thread, or
+     * directly when there is only one chunk. Chunks at the end of the range
+     * may be empty, so that every thread number is used once. The first
+     * exception thrown by any of the threads is rethrown on the calling
+     * thread after all threads are joined.
+     */
+    template<class Function>
+    void
+    run_in_chunks(const std::size_t n, const unsigned int n_threads, const Function &function)
+    {
+      if (n_threads <= 1)
+        {
+          function(0, 0, n);
+          return;
+        }
+
+      std::vector<std::thread> threads;
+      std::vector<std::exception_ptr> exceptions(n_threads);
+      const std::size_t chunk_size = (n + n_threads - 1) / n_threads;
+      for (unsigned int thread = 0; thread < n_threads; ++thread)
+        {
+          const std::size_t begin = std::min(thread * chunk_size, n);
+          const std::size_t end = std::min(begin + chunk_size, n);
+          threads.emplace_back([&function, &exceptions, thread, begin, end]()
+          {
+            try
+              {
+                function(thread, begin, end);
+              }
+            catch (...)
+              {
+                exceptions[thread] = std::current_exception();
+              }
+          });
+        }
+
+      for (auto &thread : threads)
+        thread.join();
+
+      for (auto &exception : exceptions)
+        if (exception)
+          std::rethrow_exception(exception);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,231 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_thread_slots_h
+#define _world_builder_thread_slots_h
+
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace WorldBuilder
+{
+  /**
+   * This class gives every thread which uses an object, like the profiler or
+   * the query hints, its own slot with a vector of values, so that the
+   * values do not need to be synchronized between threads.
+   *
+   * The slot of a thread is found through thread local storage. When a
+   * thread exits, its slots are returned to the objects which still exist,
+   * and given to the next thread which starts using the object. The values
+   * in a slot are kept when it is returned. So the number of slots of an
+   * object is the largest number of threads which have used it at the same
+   * time, even when a new thread is started for every call.
+   */
+  template<class T>
+  class ThreadSlots
+  {
+    public:
+      /**
+       * Constructor.
+       */
+      ThreadSlots();
+
+      /**
+       * Return the slot of the current thread. If the thread does not have a
+       * slot yet, it gets a returned slot, or a new slot with the given
+       * number of values.
+       */
+      std::vector<T> &get(const std::size_t n_values) const;
+
+      /**
+       * Return the number of slots which have been created.
+       */
+      std::size_t n_slots() const;
+
+      /**
+       * Call the given function for every slot, including the slots which
+       * have been returned. This should not be done while other threads are
+       * using the slots.
+       */
+      template<class Function>
+      void for_each(Function function) const;
+
+    private:
+      /**
+       * The slots of an object. They are shared with the threads which use
+       * them, so that a thread which exits can tell whether the object still
+       * exists.
+       */
+      struct Pool
+      {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<std::vector<T> > > slots;
+        std::vector<std::vector<T> *> returned_slots;
+      };
+
+      /**
+       * The slots which the current thread has taken from the objects it has
+       * used. They are returned when the thread exits.
+       */
+      struct ThreadOwner
+      {
+        ThreadOwner();
+
+        ~ThreadOwner();
+
+        struct Entry
+        {
+          std::weak_ptr<Pool> pool;
+          std::vector<T> *slot;
+        };
+
+        std::unordered_map<unsigned long long, Entry> entries;
+
+        /**
+         * A cache of the last lookup in entries, since a thread almost
+         * always uses the same object many times in a row.
+         */
+        unsigned long long last_id;
+        std::vector<T> *last_slot;
+      };
+
+      /**
+       * Return the owner of the slots of the current thread.
+       */
+      static ThreadOwner &thread_owner();
+
+      /**
+       * The source of the unique numbers of the objects.
+       */
+      static std::atomic<unsigned long long> next_id;
+
+      /**
+       * A number which is unique for every object, used to find its slot in
+       * the thread local storage.
+       */
+      const unsigned long long id;
+
+      const std::shared_ptr<Pool> pool;
+  };
+
+
+  template<class T>
+  std::atomic<unsigned long long> ThreadSlots<T>::next_id(0);
+
+  template<class T>
+  ThreadSlots<T>::ThreadSlots()
+    :
+    id(next_id++),
+    pool(new Pool())
+  {}
+
+  template<class T>
+  ThreadSlots<T>::ThreadOwner::ThreadOwner()
+    :
+    last_id(std::numeric_limits<unsigned long long>::max()),
+    last_slot(nullptr)
+  {}
+
+  template<class T>
+  ThreadSlots<T>::ThreadOwner::~ThreadOwner()
+  {
+    for (auto &entry : entries)
+      {
+        const std::shared_ptr<Pool> entry_pool = entry.second.pool.lock();
+        if (entry_pool)
+          {
+            std::lock_guard<std::mutex> lock(entry_pool->mutex);
+            entry_pool->returned_slots.push_back(entry.second.slot);
+          }
+      }
+  }
+
+  template<class T>
+  typename ThreadSlots<T>::ThreadOwner &
+  ThreadSlots<T>::thread_owner()
+  {
+    static thread_local ThreadOwner owner;
+    return owner;
+  }
+
+  template<class T>
+  std::vector<T> &
+  ThreadSlots<T>::get(const std::size_t n_values) const
+  {
+    ThreadOwner &owner = thread_owner();
+    if (owner.last_id != id)
+      {
+        auto it = owner.entries.find(id);
+        if (it == owner.entries.end())
+          {
+            // This thread has not used this object before, so take a slot.
+            std::vector<T> *slot = nullptr;
+            {
+              std::lock_guard<std::mutex> lock(pool->mutex);
+              if (pool->returned_slots.size() > 0)
+                {
+                  slot = pool->returned_slots.back();
+                  pool->returned_slots.pop_back();
+                }
+              else
+                {
+                  pool->slots.emplace_back(new std::vector<T>(n_values));
+                  slot = pool->slots.back().get();
+                }
+            }
+
+            // Forget the objects which no longer exist.
+            for (auto entry = owner.entries.begin(); entry != owner.entries.end();)
+              entry = entry->second.pool.expired() ? owner.entries.erase(entry) : std::next(entry);
+
+            typename ThreadOwner::Entry entry = {pool, slot};
+            it = owner.entries.insert(std::make_pair(id, entry)).first;
+          }
+        owner.last_id = id;
+        owner.last_slot = it->second.slot;
+      }
+
+    return *owner.last_slot;
+  }
+
+  template<class T>
+  std::size_t
+  ThreadSlots<T>::n_slots() const
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    return pool->slots.size();
+  }
+
+  template<class T>
+  template<class Function>
+  void
+  ThreadSlots<T>::for_each(Function function) const
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    for (auto &slot : pool->slots)
+      function(*slot);
+  }
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_trace_h
+#define _world_builder_trace_h
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WorldBuilder
+{
+  /**
+   * This class records how long the phases of for example the startup of a
+   * world take, as spans with a begin and end time, and writes them to a file
+   * in the Chrome trace event format. This file can be opened in for example
+   * chrome://tracing or https://ui.perfetto.dev to see how the time is split
+   * between the phases.
+   *
+   * The trace is disabled by default, in which case creating a span only
+   * costs a check whether the trace is enabled.
+   */
+  class Trace
+  {
+    public:
+      /**
+       * A span which begins when it is created and ends when it is
+       * destroyed.
+       */
+      class Scope
+      {
+        public:
+          /**
+           * Begin a span with the given name and category in the given trace.
+           */
+          Scope(Trace &trace, const std::string &name, const std::string &category);
+
+          /**
+           * End the span and add it to the trace, unless it was already
+           * ended.
+           */
+          ~Scope();
+
+          /**
+           * End the span before the scope ends and add it to the trace.
+           */
+          void end();
+
+          /**
+           * Add an argument to the span, which is shown when the span is
+           * selected in the trace viewer.
+           */
+          void add_argument(const std::string &key, const std::string &value);
+
+        private:
+          Trace *trace;
+          std::string name;
+          std::string category;
+          std::vector<std::pair<std::string,std::string> > arguments;
+          std::chrono::steady_clock::time_point start;
+      };
+
+      /**
+       * Constructor. The trace is disabled by default.
+       */
+      Trace();
+
+      /**
+       * Destructor
+       */
+      ~Trace();
+
+      /**
+       * Enable the trace, which will be written to the given file by write().
+       */
+      void enable(const std::string &file_name);
+
+      /**
+       * Whether spans are recorded.
+       */
+      bool is_enabled() const
+      {
+        return enabled;
+      }
+
+      /**
+       * Write all the spans recorded so far to the file given to enable().
+       */
+      void write() const;
+
+      /**
+       * Return the spans recorded so far in the Chrome trace event format.
+       */
+      std::string to_json() const;
+
+    private:
+      /**
+       * A span as it is stored in the trace, with the times in microseconds
+       * since the creation of the trace.
+       */
+      struct Span
+      {
+        std::string name;
+        std::string category;
+        std::vector<std::pair<std::string,std::string> > arguments;
+        double begin;
+        double duration;
+        unsigned int thread;
+      };
+
+      /**
+       * Add a finished span. This is thread safe.
+       */
+      void add_span(const std::string &name,
+                    const std::string &category,
+                    const std::vector<std::pair<std::string,std::string> > &arguments,
+                    const std::chrono::steady_clock::time_point &begin,
+                    const std::chrono::steady_clock::time_point &end);
+
+      bool enabled;
+
+      std::string file_name;
+
+      /**
+       * The time the trace was created, which is used as time zero.
+       */
+      const std::chrono::steady_clock::time_point creation_time;
+
+      std::vector<Span> spans;
+
+      /**
+       * A small number for every thread which recorded a span, since the
+       * thread ids themselves are not numbers.
+       */
+      std::map<std::thread::id, unsigned int> thread_numbers;
+
+      mutable std::mutex mutex;
+  };
+}
+
+#endif
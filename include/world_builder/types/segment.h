@@ -27,6 +27,8 @@
 
 namespace WorldBuilder
 {
+  class Snapshot;
+
   namespace Types
   {
 
@@ -114,6 +116,12 @@ namespace WorldBuilder
                 const std::vector<std::shared_ptr<A> > &temperature_systems,
                 const std::vector<std::shared_ptr<B> > &composition_systems);
 
+        /**
+         * A constructor for an empty segment, which is filled by loading it
+         * from a snapshot.
+         */
+        Segment();
+
         /**
          * Copy constructor
          */
@@ -131,6 +139,12 @@ namespace WorldBuilder
                           const std::string &name,
                           const std::string &documentation) const override final;
 
+        /**
+         * Save the segment, including its models, to or load it from a
+         * snapshot.
+         */
+        void serialize(Snapshot &snapshot);
+
 
         double value_length;
         double default_length;
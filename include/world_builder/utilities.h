@@ -22,10 +22,15 @@
 
 #include <vector>
 #include <map>
+#include <string>
 
 #include <world_builder/point.h>
 #include <world_builder/coordinate_system.h>
 #include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/centerline_table.h>
+#include <world_builder/query_hints.h>
+#include <world_builder/section_index.h>
+#include <world_builder/segment_table.h>
 
 
 namespace WorldBuilder
@@ -61,6 +66,18 @@ namespace WorldBuilder
     polygon_contains_point_implementation(const std::vector<Point<2> > &point_list,
                                           const Point<2> &point);
 
+    /**
+     * Computes if the point falls within the polygon, like the function
+     * above, but reuses the result for the previous point when the point
+     * lies within the safe distance of the given hint, and otherwise updates
+     * the hint. When the hint is a null pointer, the function above is
+     * called.
+     */
+    bool
+    polygon_contains_point(const std::vector<Point<2> > &point_list,
+                           const Point<2> &point,
+                           QueryHints::PolygonHint *hint);
+
     /**
      * Given a 2d point and a list of points which form a polygon, compute the smallest
      * distance of the point to the polygon. The sign is negative for points outside of
@@ -201,6 +218,62 @@ namespace WorldBuilder
      */
     Point<3> cross_product(const Point<3> &a, const Point<3> &b);
 
+    /**
+     * The distance of a point to a curved plane and where the closest point
+     * on the plane is, as computed by distance_point_from_curved_planes().
+     * This is a plain struct, so that it can be computed and passed on to
+     * the models of a feature without allocating memory.
+     */
+    struct PointDistanceFromCurvedPlanes
+    {
+      /**
+       * Constructor. All distances are infinite and all fractions zero.
+       */
+      PointDistanceFromCurvedPlanes();
+
+      /**
+       * The distance of the point to the plane. It is positive below the
+       * plane and negative above it, unless only positive distances were
+       * requested.
+       */
+      double distance_from_plane;
+
+      /**
+       * The distance along the plane from the surface to the closest point
+       * on the plane.
+       */
+      double distance_along_plane;
+
+      /**
+       * How far the closest point is between the current and the next
+       * section, in terms of the user provided coordinates.
+       */
+      double section_fraction;
+
+      /**
+       * How far the closest point is along the current segment.
+       */
+      double segment_fraction;
+
+      /**
+       * The section and the segment in which the closest point lies.
+       */
+      size_t section;
+      size_t segment;
+
+      /**
+       * The average angle of the plane from the surface to the closest point.
+       */
+      double average_angle;
+
+      /**
+       * The local thickness of the plane. This is not computed by
+       * distance_point_from_curved_planes(), but filled in by the feature
+       * before the models are called.
+       */
+      double local_thickness;
+    };
+
     /**
      * Computes the distance of a point to a curved plane.
      * TODO: add more info on how this works/is implemented.
@@ -236,15 +309,69 @@ namespace WorldBuilder
      * the original number. Note that no whole numbers may be skiped. So for a list of 4 points,
      * {0,0.5,1,2} is allowed, but {0,2,3,4} is not.
      */
-    std::map<std::string,double> distance_point_from_curved_planes(const Point<3> &point,
-                                                                   const Point<2> &reference_point,
-                                                                   const std::vector<Point<2> > &point_list,
-                                                                   const std::vector<std::vector<double> > &plane_segment_lengths,
-                                                                   const std::vector<std::vector<Point<2> > > &plane_segment_angles,
-                                                                   const double start_depth,
-                                                                   const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
-                                                                   const bool only_positive,
-                                                                   std::vector<double> global_x_list = {});
+    PointDistanceFromCurvedPlanes distance_point_from_curved_planes(const Point<3> &point,
+                                                                    const Point<2> &reference_point,
+                                                                    const std::vector<Point<2> > &point_list,
+                                                                    const std::vector<std::vector<double> > &plane_segment_lengths,
+                                                                    const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                                                                    const double start_depth,
+                                                                    const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                                                    const bool only_positive,
+                                                                    const std::vector<double> &global_x_list = std::vector<double>());
+
+    /**
+     * Computes the distance of a point to a curved plane, like the function
+     * above, but with the segment lengths and angles of every section given
+     * as a SegmentTable, which is faster than nested vectors.
+     * \param section_index If this is given and initialized, only the
+     * sections of the point_list which this index returns for the point are
+     * searched. Sections which it leaves out can not contain the point, so
+     * the distance is only exact for points within the reach of the index.
+     * \param centerline_table If this is given and initialized, the
+     * directions of the segments of the sections which it contains are
+     * interpolated from it instead of computed. It is not used for the
+     * depth method angle_at_begin_segment_with_surface.
+     * \param section_hint If this is given, the sections next to which the
+     * previous point lay are searched when the point lies within the safe
+     * distance of the hint, and the hint is updated otherwise.
+     */
+    PointDistanceFromCurvedPlanes distance_point_from_curved_planes(const Point<3> &point,
+                                                                    const Point<2> &reference_point,
+                                                                    const std::vector<Point<2> > &point_list,
+                                                                    const SegmentTable &segment_table,
+                                                                    const double start_depth,
+                                                                    const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                                                    const bool only_positive,
+                                                                    const std::vector<double> &global_x_list = std::vector<double>(),
+                                                                    const SectionIndex *section_index = nullptr,
+                                                                    const CenterlineTable *centerline_table = nullptr,
+                                                                    QueryHints::SectionHint *section_hint = nullptr);
+
+    /**
+     * Computes the distance of a number of points to a curved plane, like
+     * the function above, and stores them in the given distances. The points
+     * are given by their cartesian coordinates and every point has its own
+     * start radius. In a cartesian coordinate system, the points are
+     * processed in blocks, for which the parts of the computation which
+     * only depend on the section and segment are done once, and the parts
+     * which depend on the point are done in arrays over the points of the
+     * block. The results are the same as for the function above. In other
+     * coordinate systems, the function above is called for every point.
+     */
+    void distance_points_from_curved_planes(const size_t n_points,
+                                            const double *x,
+                                            const double *y,
+                                            const double *z,
+                                            const double *start_radii,
+                                            const Point<2> &reference_point,
+                                            const std::vector<Point<2> > &point_list,
+                                            const SegmentTable &segment_table,
+                                            const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                            const bool only_positive,
+                                            const std::vector<double> &global_x_list,
+                                            const SectionIndex *section_index,
+                                            const CenterlineTable *centerline_table,
+                                            PointDistanceFromCurvedPlanes *distances);
 
     /**
      * Class for linear and monotone spline interpolation
@@ -300,6 +427,43 @@ namespace WorldBuilder
      */
     std::array<std::array<double,3>,3>
     euler_angles_to_rotation_matrix(double phi1, double theta, double phi2);
+
+    /**
+     * Returns the number of bytes an object allocates on the heap, not
+     * counting the object itself. This is the fallback for objects which
+     * do not allocate any memory, like numbers and points.
+     */
+    template<class T>
+    inline
+    std::size_t memory_usage(const T &)
+    {
+      return 0;
+    }
+
+    /**
+     * Returns the number of bytes a string allocates on the heap. Short
+     * strings may be stored inside the string object itself, which is
+     * ignored here, so this is an upper bound.
+     */
+    inline
+    std::size_t memory_usage(const std::string &string)
+    {
+      return string.capacity() + 1;
+    }
+
+    /**
+     * Returns the number of bytes a vector allocates on the heap, including
+     * the memory allocated by its elements, for example for nested vectors.
+     */
+    template<class T>
+    inline
+    std::size_t memory_usage(const std::vector<T> &vector)
+    {
+      std::size_t bytes = vector.capacity() * sizeof(T);
+      for (auto &element : vector)
+        bytes += memory_usage(element);
+      return bytes;
+    }
   }
 }
 
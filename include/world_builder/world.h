@@ -20,13 +20,18 @@
 #ifndef _world_builder_world_h
 #define _world_builder_world_h
 
+#include <world_builder/depth_interval_index.h>
 #include <world_builder/parameters.h>
+#include <world_builder/profiler.h>
+#include <world_builder/query_hints.h>
+#include <world_builder/spatial_order.h>
+#include <world_builder/trace.h>
 
 
 
 namespace WorldBuilder
 {
-
+  class Snapshot;
 
   namespace Features
   {
@@ -39,8 +44,28 @@ namespace WorldBuilder
       /**
        * Constructor. This constructor requires a atring with the location of
        * the world builder file to initialize the world..
+       *
+       * When a trace file is given, or when the environment variable
+       * WB_TRACE_FILE is set, the time spent in the phases of the startup
+       * (parsing, validation and the parsing of every feature) is written to
+       * that file in the Chrome trace event format.
+       *
+       * When compact is true, or when the environment variable WB_COMPACT is
+       * set to a value other than 0, the json documents and the other data
+       * which is only needed while parsing are released at the end of the
+       * constructor (see Parameters::release_parse_data()). This saves
+       * memory when many worlds are loaded, for example by every process of
+       * a parallel program, but the parameters can not be retrieved from
+       * the world anymore.
+       *
+       * The file may also be a snapshot written by write_snapshot(), in which
+       * case the parsed world is loaded from it directly, without parsing
+       * and validating the world builder file again. The parameters of such
+       * a world are empty, as in compact mode, and has_output_dir, output_dir
+       * and compact are ignored.
        */
-      World(std::string filename, bool has_output_dir = false, std::string output_dir = "");
+      World(std::string filename, bool has_output_dir = false, std::string output_dir = "", std::string trace_file = "",
+            bool compact = false);
 
       /**
        * Destructor
@@ -82,6 +107,92 @@ namespace WorldBuilder
        */
       double composition(const std::array<double, 3> &point, const double depth, const unsigned int composition_number) const;
 
+      /**
+       * Computes the temperature for n_points 2d Cartesian points, given as
+       * separate x and z arrays, together with the depth and gravity norm
+       * at each point. The results are written into the caller provided
+       * temperatures array, which must be able to hold n_points values.
+       */
+      void temperatures(const size_t n_points,
+                        const double *x,
+                        const double *z,
+                        const double *depth,
+                        const double *gravity_norm,
+                        double *temperatures) const;
+
+      /**
+       * Computes the temperature for n_points 3d Cartesian points, given as
+       * separate x, y and z arrays, together with the depth and gravity norm
+       * at each point. The results are written into the caller provided
+       * temperatures array, which must be able to hold n_points values.
+       */
+      void temperatures(const size_t n_points,
+                        const double *x,
+                        const double *y,
+                        const double *z,
+                        const double *depth,
+                        const double *gravity_norm,
+                        double *temperatures) const;
+
+      /**
+       * Computes the compositions 0 to n_compositions-1 for n_points 2d
+       * Cartesian points. The value of composition c at point i is written
+       * to compositions[i*n_compositions+c], so the caller provided array
+       * must be able to hold n_points*n_compositions values.
+       */
+      void compositions(const size_t n_points,
+                        const double *x,
+                        const double *z,
+                        const double *depth,
+                        const unsigned int n_compositions,
+                        double *compositions) const;
+
+      /**
+       * Computes the compositions 0 to n_compositions-1 for n_points 3d
+       * Cartesian points. The value of composition c at point i is written
+       * to compositions[i*n_compositions+c], so the caller provided array
+       * must be able to hold n_points*n_compositions values.
+       */
+      void compositions(const size_t n_points,
+                        const double *x,
+                        const double *y,
+                        const double *z,
+                        const double *depth,
+                        const unsigned int n_compositions,
+                        double *compositions) const;
+
+      /**
+       * Returns a table with the number of calls, early rejects, hits and
+       * the time spent for every feature and every temperature and
+       * composition model, summed over all threads. The counters are only
+       * collected while the profiler is enabled, which can be done with
+       * profiler.set_enabled(true).
+       */
+      std::string performance_report() const;
+
+      /**
+       * Returns the memory kept by this world in bytes, split in components
+       * like the two json documents of the parameters and the coordinates,
+       * segments and models of every feature. Every component is returned
+       * as a name and a number of bytes.
+       */
+      std::vector<std::pair<std::string,std::size_t> > memory_usage() const;
+
+      /**
+       * Returns a table with the memory used by every component returned by
+       * memory_usage() and the total, followed by the high-water marks of the
+       * allocators of the json documents.
+       */
+      std::string memory_report() const;
+
+      /**
+       * Write the parsed world to a binary snapshot in the given file, which
+       * can be loaded much faster than the world builder file by passing it
+       * to the constructor. The snapshot can only be loaded by the same
+       * version of the World Builder, on a machine with the same byte order.
+       */
+      void write_snapshot(const std::string &filename) const;
+
 
 
       /**
@@ -90,6 +201,49 @@ namespace WorldBuilder
        */
       Parameters parameters;
 
+      /**
+       * The profiler, which collects the performance counters of the
+       * features and models of this world.
+       */
+      Profiler profiler;
+
+      /**
+       * The hints which let a query reuse what was found for the previous
+       * point of the same thread. They can be enabled with
+       * query_hints.set_enabled(true).
+       */
+      QueryHints query_hints;
+
+      /**
+       * The order in which the batched functions evaluate the points. When
+       * it is enabled with spatial_order.set_enabled(true), the points are
+       * evaluated along a space filling curve instead of in the given order,
+       * which is faster when the points are not ordered in space. The
+       * results are returned in the given order.
+       */
+      SpatialOrder spatial_order;
+
+      /**
+       * Whether the temperature and composition functions first search the
+       * features from the last to the first for the last feature which
+       * replaces the value at a point, and then only evaluate the features
+       * from that one on, since the features before it can not change the
+       * result. The results are the same as without it. This is faster when
+       * a late feature, like a plate with a uniform temperature, covers
+       * most points, and slower when few points are covered, since the
+       * search is then done for nothing. Features which can not tell
+       * whether they replace a value, like the slabs and faults, are never
+       * skipped. It is disabled by default, and is not used while the
+       * profiler is enabled, so that the profiler counts every feature.
+       */
+      bool reverse_evaluation;
+
+      /**
+       * The trace, which records how long the phases of the startup of this
+       * world take when it is enabled.
+       */
+      Trace trace;
+
       /**
        * Todo
        */
@@ -142,6 +296,74 @@ namespace WorldBuilder
 
 
     private:
+      /**
+       * Converts a 2d point in the cross section into a 3d Cartesian point.
+       */
+      std::array<double,3> cross_section_to_cartesian(const std::array<double,2> &point) const;
+
+      /**
+       * Returns the indices of the features which can change the values at
+       * the given depth, in their original order. While the profiler is
+       * enabled, all features are returned, so that it counts every
+       * feature.
+       */
+      const std::vector<unsigned int> &active_features(const double depth) const;
+
+      /**
+       * Returns the index of the first feature which has to be evaluated
+       * for the temperature at the given point, which is the last feature
+       * which replaces the temperature there, or zero if there is none.
+       */
+      size_t first_temperature_feature(const Point<3> &point, const double depth) const;
+
+      /**
+       * Returns the index of the first feature which has to be evaluated
+       * for the given composition at the given point.
+       */
+      size_t first_composition_feature(const Point<3> &point, const double depth,
+                                       const unsigned int composition_number) const;
+
+      /**
+       * Converts n_points 2d points in the cross section into 3d Cartesian
+       * points.
+       */
+      void cross_section_to_cartesian(const size_t n_points,
+                                      const double *x,
+                                      const double *z,
+                                      double *x_3d,
+                                      double *y_3d,
+                                      double *z_3d) const;
+
+      /**
+       * Computes the temperatures of 3d Cartesian points like temperatures(),
+       * but always in the given order.
+       */
+      void temperatures_in_given_order(const size_t n_points,
+                                       const double *x,
+                                       const double *y,
+                                       const double *z,
+                                       const double *depth,
+                                       const double *gravity_norm,
+                                       double *temperatures) const;
+
+      /**
+       * Computes the compositions of 3d Cartesian points like compositions(),
+       * but always in the given order.
+       */
+      void compositions_in_given_order(const size_t n_points,
+                                       const double *x,
+                                       const double *y,
+                                       const double *z,
+                                       const double *depth,
+                                       const unsigned int n_compositions,
+                                       double *compositions) const;
+
+      /**
+       * Save the parsed world, including the coordinate system and the
+       * features, to or load it from a snapshot.
+       */
+      void serialize(Snapshot &snapshot);
+
       /**
        * The minimum dimension. If cross section data is provided, it is set
        * to 2, which means the 2d function of temperature and composition can
@@ -150,6 +372,13 @@ namespace WorldBuilder
        */
       unsigned int dim;
 
+      /**
+       * The depth ranges of the features, built once the features have
+       * been created, so that a query only calls the features which can
+       * change the values at its depth.
+       */
+      DepthIntervalIndex feature_index;
+
 
 
 
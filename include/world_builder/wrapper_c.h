@@ -20,6 +20,8 @@
 #ifndef _world_builder_wrapper_c_h
 #define _world_builder_wrapper_c_h
 
+#include <stddef.h>
+
 extern "C" {
   /**
    * This function creates an object of the world builder and returns a pointer
@@ -52,6 +54,34 @@ extern "C" {
    */
   void composition_3d(void *ptr_ptr_world, double x, double y, double z, double depth, unsigned int composition_number, double *composition);
 
+  /**
+   * This function computes the temperature at n points given arrays of x, z, depth
+   * and gravity, and writes the results into the provided temperatures array of
+   * length n.
+   */
+  void temperatures_2d(void *ptr_ptr_world, size_t n, const double *x, const double *z, const double *depth, const double *gravity, double *temperatures);
+
+  /**
+   * This function computes the temperature at n points given arrays of x, y, z, depth
+   * and gravity, and writes the results into the provided temperatures array of
+   * length n.
+   */
+  void temperatures_3d(void *ptr_ptr_world, size_t n, const double *x, const double *y, const double *z, const double *depth, const double *gravity, double *temperatures);
+
+  /**
+   * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+   * x, z and depth. The value of composition c at point i is written to
+   * compositions[i*n_comp+c], so the provided array should have length n*n_comp.
+   */
+  void compositions_2d(void *ptr_ptr_world, size_t n, const double *x, const double *z, const double *depth, unsigned int n_comp, double *compositions);
+
+  /**
+   * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+   * x, y, z and depth. The value of composition c at point i is written to
+   * compositions[i*n_comp+c], so the provided array should have length n*n_comp.
+   */
+  void compositions_3d(void *ptr_ptr_world, size_t n, const double *x, const double *y, const double *z, const double *depth, unsigned int n_comp, double *compositions);
+
   /**
    * The destructor for the world builder class. Call this function when done with the
    * world builder.
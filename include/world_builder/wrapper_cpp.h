@@ -20,6 +20,7 @@
 #ifndef _world_builder_wrapper_cpp_h
 #define _world_builder_wrapper_cpp_h
 
+#include <cstddef>
 #include <string>
 
 namespace wrapper_cpp
@@ -67,6 +68,42 @@ namespace wrapper_cpp
        */
       double composition_3d(double x, double y, double z, double depth, unsigned int composition_number);
 
+      /**
+       * This function computes the temperature at n points given arrays of x, z, depth
+       * and gravity, and writes the results into the provided temperatures array of
+       * length n. The points are split over n_threads threads. If n_threads is zero,
+       * the number of hardware threads is used.
+       */
+      void temperatures_2d(size_t n, const double *x, const double *z, const double *depth, const double *gravity,
+                           double *temperatures, unsigned int n_threads = 1);
+
+      /**
+       * This function computes the temperature at n points given arrays of x, y, z, depth
+       * and gravity, and writes the results into the provided temperatures array of
+       * length n. The points are split over n_threads threads. If n_threads is zero,
+       * the number of hardware threads is used.
+       */
+      void temperatures_3d(size_t n, const double *x, const double *y, const double *z, const double *depth, const double *gravity,
+                           double *temperatures, unsigned int n_threads = 1);
+
+      /**
+       * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+       * x, z and depth. The value of composition c at point i is written to
+       * compositions[i*n_comp+c]. The points are split over n_threads threads. If n_threads
+       * is zero, the number of hardware threads is used.
+       */
+      void compositions_2d(size_t n, const double *x, const double *z, const double *depth, unsigned int n_comp,
+                           double *compositions, unsigned int n_threads = 1);
+
+      /**
+       * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+       * x, y, z and depth. The value of composition c at point i is written to
+       * compositions[i*n_comp+c]. The points are split over n_threads threads. If n_threads
+       * is zero, the number of hardware threads is used.
+       */
+      void compositions_3d(size_t n, const double *x, const double *y, const double *z, const double *depth, unsigned int n_comp,
+                           double *compositions, unsigned int n_threads = 1);
+
 
     private:
       void *ptr_ptr_world;
@@ -0,0 +1,112 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <world_builder/centerline_table.h>
+#include <world_builder/utilities.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * Computes the directions of a segment from its angles.
+     */
+    CenterlineTable::Directions
+    compute_directions(const double angle_top, const double angle_bottom)
+    {
+      // The direction at the top is computed from the angle with the
+      // horizontal, as distance_point_from_curved_planes() has always done for
+      // straight segments, so that the end points of those do not change.
+      const double angle_with_horizontal = 0.5 * Utilities::const_pi - angle_top;
+      CenterlineTable::Directions directions;
+      directions.cos_angle_top = std::sin(angle_with_horizontal);
+      directions.sin_angle_top = std::cos(angle_with_horizontal);
+      directions.cos_angle_difference = std::cos(angle_top - angle_bottom);
+      directions.sin_angle_difference = std::sin(angle_top - angle_bottom);
+      return directions;
+    }
+  }
+
+  CenterlineTable::CenterlineTable()
+    :
+    initialized(false),
+    number_of_segments(0)
+  {}
+
+  void
+  CenterlineTable::clear()
+  {
+    initialized = false;
+    number_of_segments = 0;
+    first_sample.clear();
+    first_sample.shrink_to_fit();
+    samples.clear();
+    samples.shrink_to_fit();
+  }
+
+  void
+  CenterlineTable::reinit(const SegmentTable &segment_table, const unsigned int n_fractions)
+  {
+    clear();
+    const std::size_t n_sections = segment_table.n_sections();
+    if (n_sections < 2 || n_fractions == 0)
+      return;
+
+    number_of_segments = segment_table.n_segments();
+    first_sample.assign(n_sections, 0);
+    for (std::size_t section = 0; section + 1 < n_sections; ++section)
+      {
+        bool constant_angles = true;
+        for (std::size_t segment = 0; segment < number_of_segments; ++segment)
+          if (std::fabs(segment_table(SegmentTable::angle_top, section + 1, segment)
+                        - segment_table(SegmentTable::angle_top, section, segment)) > 0
+              || std::fabs(segment_table(SegmentTable::angle_bottom, section + 1, segment)
+                           - segment_table(SegmentTable::angle_bottom, section, segment)) > 0)
+            constant_angles = false;
+
+        const std::size_t n_samples = constant_angles ? 1 : n_fractions + 1;
+        first_sample[section + 1] = first_sample[section] + n_samples;
+
+        // The angles are interpolated in the same way as in
+        // distance_point_from_curved_planes().
+        for (std::size_t sample = 0; sample < n_samples; ++sample)
+          {
+            const double fraction = n_samples > 1 ? static_cast<double>(sample) / static_cast<double>(n_samples - 1) : 0;
+            for (std::size_t segment = 0; segment < number_of_segments; ++segment)
+              {
+                const double angle_top = segment_table(SegmentTable::angle_top, section, segment)
+                                         + fraction * (segment_table(SegmentTable::angle_top, section + 1, segment)
+                                                       - segment_table(SegmentTable::angle_top, section, segment));
+                const double angle_bottom = segment_table(SegmentTable::angle_bottom, section, segment)
+                                            + fraction * (segment_table(SegmentTable::angle_bottom, section + 1, segment)
+                                                          - segment_table(SegmentTable::angle_bottom, section, segment));
+                samples.push_back(compute_directions(angle_top, angle_bottom));
+              }
+          }
+      }
+
+    initialized = true;
+  }
+
+  std::size_t
+  CenterlineTable::memory_usage() const
+  {
+    return first_sample.capacity() * sizeof(std::size_t) + samples.capacity() * sizeof(Directions);
+  }
+}
@@ -83,6 +83,10 @@ namespace WorldBuilder
       return point_at_depth.norm();
     }
 
+    void
+    Cartesian::serialize(Snapshot & /*snapshot*/)
+    {}
+
     /**
      * Register plugin
      */
@@ -95,7 +95,9 @@ namespace WorldBuilder
       // Using at() because the [] will just insert values
       // which is undesirable in this case. An exception is
       // thrown when the name is not present.
-      return get_factory_map().at(lower_case_name)->create(world);
+      std::unique_ptr<Interface> object = get_factory_map().at(lower_case_name)->create(world);
+      object->plugin_name = lower_case_name;
+      return object;
     }
   }
 }
@@ -19,6 +19,7 @@
 
 #include <world_builder/assert.h>
 #include <world_builder/coordinate_systems/spherical.h>
+#include <world_builder/snapshot.h>
 #include <world_builder/types/string.h>
 #include <world_builder/types/object.h>
 
@@ -128,6 +129,12 @@ namespace WorldBuilder
       return radius * std::atan2(top, bottom);
     }
 
+    void
+    Spherical::serialize(Snapshot &snapshot)
+    {
+      snapshot(used_depth_method);
+    }
+
     /**
      * Register plugin
      */
@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <world_builder/assert.h>
+#include <world_builder/depth_interval_index.h>
+
+namespace WorldBuilder
+{
+  DepthIntervalIndex::DepthIntervalIndex()
+    :
+    active_entries(1)
+  {}
+
+  void
+  DepthIntervalIndex::build(const std::vector<std::pair<double,double> > &ranges)
+  {
+    bounds.clear();
+    all_entries.clear();
+    for (unsigned int entry = 0; entry < ranges.size(); ++entry)
+      {
+        WBAssertThrow(!std::isnan(ranges[entry].first) && !std::isnan(ranges[entry].second),
+                      "The depth range of entry " << entry << " of a depth interval index is not a number.");
+        if (std::isfinite(ranges[entry].first))
+          bounds.push_back(ranges[entry].first);
+        if (std::isfinite(ranges[entry].second))
+          bounds.push_back(ranges[entry].second);
+        all_entries.push_back(entry);
+      }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end(), [](const double a, const double b)
+    {
+      return !(a < b) && !(b < a);
+    }), bounds.end());
+
+    // An entry is active in an interval between two bounds when its range
+    // contains both bounds, since no bound lies in between.
+    active_entries.assign(2 * bounds.size() + 1, std::vector<unsigned int>());
+    for (size_t slot = 0; slot < active_entries.size(); ++slot)
+      {
+        const size_t bound = slot / 2;
+        double lower, upper;
+        if (slot % 2 == 1)
+          {
+            lower = bounds[bound];
+            upper = bounds[bound];
+          }
+        else
+          {
+            lower = bound == 0 ? -INFINITY : bounds[bound - 1];
+            upper = bound == bounds.size() ? INFINITY : bounds[bound];
+          }
+        for (unsigned int entry = 0; entry < ranges.size(); ++entry)
+          if (ranges[entry].first <= lower && ranges[entry].second >= upper)
+            active_entries[slot].push_back(entry);
+      }
+  }
+
+  const std::vector<unsigned int> &
+  DepthIntervalIndex::active(const double depth) const
+  {
+    const size_t bound = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), depth) - bounds.begin());
+    if (bound < bounds.size() && !(depth < bounds[bound]))
+      return active_entries[2 * bound + 1];
+    return active_entries[2 * bound];
+  }
+
+  std::size_t
+  DepthIntervalIndex::memory_usage() const
+  {
+    std::size_t bytes = bounds.capacity() * sizeof(double)
+                        + active_entries.capacity() * sizeof(std::vector<unsigned int>)
+                        + all_entries.capacity() * sizeof(unsigned int);
+    for (auto &entries : active_entries)
+      bytes += entries.capacity() * sizeof(unsigned int);
+    return bytes;
+  }
+}
@@ -0,0 +1,265 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <world_builder/assert.h>
+#include <world_builder/distance_field.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The maximum number of nodes of the grid.
+     */
+    const double maximum_n_nodes = 134217728;
+  }
+
+  const unsigned int DistanceField::invalid_node;
+  const unsigned int DistanceField::far_node;
+
+  DistanceField::DistanceField()
+    :
+    initialized(false),
+    cell_size(0),
+    number_of_interpolated_cells(0)
+  {
+    origin[0] = origin[1] = origin[2] = 0;
+    n_nodes[0] = n_nodes[1] = n_nodes[2] = 0;
+  }
+
+  void
+  DistanceField::clear()
+  {
+    initialized = false;
+    n_nodes[0] = n_nodes[1] = n_nodes[2] = 0;
+    number_of_interpolated_cells = 0;
+    node_index.clear();
+    node_index.shrink_to_fit();
+    nodes.clear();
+    nodes.shrink_to_fit();
+    cell_states.clear();
+    cell_states.shrink_to_fit();
+  }
+
+  void
+  DistanceField::reinit(const std::array<double,3> &lower_corner,
+                        const std::array<double,3> &upper_corner,
+                        const double cell_size_,
+                        const double tolerance,
+                        const double band_width,
+                        const double length_scale,
+                        const Function &function)
+  {
+    clear();
+    WBAssertThrow(cell_size_ > 0, "The cell size of a distance field has to be larger than zero, but it is " << cell_size_ << ".");
+
+    cell_size = cell_size_;
+    double total_n_nodes = 1;
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        origin[d] = lower_corner[d];
+        const double n_cells_d = std::ceil(std::max(upper_corner[d] - lower_corner[d], 0.0) / cell_size);
+        total_n_nodes *= n_cells_d + 2;
+        WBAssertThrow(total_n_nodes <= maximum_n_nodes,
+                      "The distance field would have more than " << maximum_n_nodes << " nodes. "
+                      "Please increase the distance field resolution.");
+        n_nodes[d] = static_cast<std::size_t>(n_cells_d) + 2;
+      }
+
+    // Sample the function at every node, and store the nodes in the band.
+    node_index.assign(n_nodes[0] * n_nodes[1] * n_nodes[2], invalid_node);
+    for (std::size_t k = 0; k < n_nodes[2]; ++k)
+      for (std::size_t j = 0; j < n_nodes[1]; ++j)
+        for (std::size_t i = 0; i < n_nodes[0]; ++i)
+          {
+            const Utilities::PointDistanceFromCurvedPlanes distance =
+              function({{origin[0] + static_cast<double>(i) * cell_size,
+                         origin[1] + static_cast<double>(j) * cell_size,
+                         origin[2] + static_cast<double>(k) * cell_size
+                        }});
+            if (std::fabs(distance.distance_from_plane) <= band_width && std::isfinite(distance.distance_along_plane))
+              {
+                Node node;
+                node.distance_from_plane = distance.distance_from_plane;
+                node.distance_along_plane = distance.distance_along_plane;
+                node.section_fraction = distance.section_fraction;
+                node.segment_fraction = distance.segment_fraction;
+                node.average_angle = distance.average_angle;
+                node.section = distance.section;
+                node.segment = distance.segment;
+                node_index[(k * n_nodes[1] + j) * n_nodes[0] + i] = static_cast<unsigned int>(nodes.size());
+                nodes.push_back(node);
+              }
+            else if (std::isfinite(distance.distance_along_plane))
+              node_index[(k * n_nodes[1] + j) * n_nodes[0] + i] = far_node;
+          }
+    nodes.shrink_to_fit();
+
+    // Check the interpolation at the center of every cell which can be
+    // interpolated, and whether the center of the cells of which all nodes
+    // are far from the plane is also far from it.
+    const double center[3] = {0.5, 0.5, 0.5};
+    cell_states.assign((n_nodes[0] - 1) * (n_nodes[1] - 1) * (n_nodes[2] - 1), exact_cell);
+    for (std::size_t k = 0; k + 1 < n_nodes[2]; ++k)
+      for (std::size_t j = 0; j + 1 < n_nodes[1]; ++j)
+        for (std::size_t i = 0; i + 1 < n_nodes[0]; ++i)
+          {
+            const std::size_t cell = (k * (n_nodes[1] - 1) + j) * (n_nodes[0] - 1) + i;
+            Utilities::PointDistanceFromCurvedPlanes interpolated;
+            const bool can_interpolate = interpolate_cell(i, j, k, center, interpolated);
+            if (!can_interpolate && !cell_outside_band(i, j, k))
+              continue;
+
+            const Utilities::PointDistanceFromCurvedPlanes exact =
+              function({{origin[0] + (static_cast<double>(i) + 0.5) * cell_size,
+                         origin[1] + (static_cast<double>(j) + 0.5) * cell_size,
+                         origin[2] + (static_cast<double>(k) + 0.5) * cell_size
+                        }});
+            if (!can_interpolate)
+              {
+                if (std::fabs(exact.distance_from_plane) > band_width && std::isfinite(exact.distance_along_plane))
+                  cell_states[cell] = outside_cell;
+                continue;
+              }
+
+            if (exact.section != interpolated.section || exact.segment != interpolated.segment)
+              continue;
+
+            const double error = std::max(std::max(std::fabs(exact.distance_from_plane - interpolated.distance_from_plane),
+                                                   std::fabs(exact.distance_along_plane - interpolated.distance_along_plane)),
+                                          length_scale * std::max(std::max(std::fabs(exact.section_fraction - interpolated.section_fraction),
+                                                                           std::fabs(exact.segment_fraction - interpolated.segment_fraction)),
+                                                                  std::fabs(exact.average_angle - interpolated.average_angle)));
+            if (error <= tolerance)
+              {
+                cell_states[cell] = interpolated_cell;
+                ++number_of_interpolated_cells;
+              }
+          }
+
+    initialized = true;
+  }
+
+  bool
+  DistanceField::cell_outside_band(const std::size_t cell_x,
+                                   const std::size_t cell_y,
+                                   const std::size_t cell_z) const
+  {
+    for (unsigned int corner = 0; corner < 8; ++corner)
+      if (node_index[((cell_z + (corner >> 2)) * n_nodes[1] + cell_y + ((corner >> 1) & 1)) * n_nodes[0]
+                     + cell_x + (corner & 1)] != far_node)
+        return false;
+    return true;
+  }
+
+  bool
+  DistanceField::interpolate_cell(const std::size_t cell_x,
+                                  const std::size_t cell_y,
+                                  const std::size_t cell_z,
+                                  const double local[3],
+                                  Utilities::PointDistanceFromCurvedPlanes &distance) const
+  {
+    const Node *corners[8];
+    for (unsigned int corner = 0; corner < 8; ++corner)
+      {
+        const unsigned int index = node_index[((cell_z + (corner >> 2)) * n_nodes[1] + cell_y + ((corner >> 1) & 1)) * n_nodes[0]
+                                             + cell_x + (corner & 1)];
+        if (index == invalid_node || index == far_node)
+          return false;
+        corners[corner] = &nodes[index];
+        if (corners[corner]->section != corners[0]->section || corners[corner]->segment != corners[0]->segment)
+          return false;
+      }
+
+    distance.distance_from_plane = 0;
+    distance.distance_along_plane = 0;
+    distance.section_fraction = 0;
+    distance.segment_fraction = 0;
+    distance.average_angle = 0;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+      {
+        const double weight = ((corner & 1) ? local[0] : 1 - local[0])
+                              * (((corner >> 1) & 1) ? local[1] : 1 - local[1])
+                              * ((corner >> 2) ? local[2] : 1 - local[2]);
+        distance.distance_from_plane += weight * corners[corner]->distance_from_plane;
+        distance.distance_along_plane += weight * corners[corner]->distance_along_plane;
+        distance.section_fraction += weight * corners[corner]->section_fraction;
+        distance.segment_fraction += weight * corners[corner]->segment_fraction;
+        distance.average_angle += weight * corners[corner]->average_angle;
+      }
+    distance.section = corners[0]->section;
+    distance.segment = corners[0]->segment;
+    return true;
+  }
+
+  bool
+  DistanceField::interpolate(const std::array<double,3> &point,
+                             Utilities::PointDistanceFromCurvedPlanes &distance) const
+  {
+    if (!initialized)
+      return false;
+
+    std::size_t cell[3];
+    double local[3];
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        const double x = (point[d] - origin[d]) / cell_size;
+        if (!(x >= 0 && x < static_cast<double>(n_nodes[d] - 1)))
+          return false;
+        cell[d] = static_cast<std::size_t>(x);
+        local[d] = x - static_cast<double>(cell[d]);
+      }
+
+    switch (cell_states[(cell[2] * (n_nodes[1] - 1) + cell[1]) * (n_nodes[0] - 1) + cell[0]])
+      {
+        case interpolated_cell:
+          return interpolate_cell(cell[0], cell[1], cell[2], local, distance);
+
+        case outside_cell:
+          distance = Utilities::PointDistanceFromCurvedPlanes();
+          return true;
+
+        default:
+          return false;
+      }
+  }
+
+  std::size_t
+  DistanceField::n_cells() const
+  {
+    return cell_states.size();
+  }
+
+  std::size_t
+  DistanceField::n_interpolated_cells() const
+  {
+    return number_of_interpolated_cells;
+  }
+
+  std::size_t
+  DistanceField::memory_usage() const
+  {
+    return node_index.capacity() * sizeof(unsigned int)
+           + nodes.capacity() * sizeof(Node)
+           + cell_states.capacity() * sizeof(unsigned char);
+  }
+}
@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -155,6 +156,31 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        bool
+        Adiabatic::replaces_temperature(const double depth) const
+        {
+          return operation == Utilities::Operations::REPLACE && depth <= max_depth && depth >= min_depth;
+        }
+
+        std::pair<double,double>
+        Adiabatic::depth_range() const
+        {
+          return std::make_pair(min_depth, max_depth);
+        }
+
+        std::size_t
+        Adiabatic::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Adiabatic::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, potential_mantle_temperature,
+                   thermal_expansion_coefficient, specific_heat, operation);
+        }
+
         WB_REGISTER_FEATURE_CONTINENTAL_PLATE_TEMPERATURE_MODEL(Adiabatic, adiabatic)
       }
     }
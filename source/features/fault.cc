@@ -20,6 +20,7 @@
 #include <world_builder/features/fault.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
+#include <world_builder/snapshot.h>
 #include <world_builder/nan.h>
 #include <world_builder/parameters.h>
 
@@ -43,7 +44,10 @@ namespace WorldBuilder
   {
     Fault::Fault(WorldBuilder::World *world_)
       :
-      reference_point(0,0,cartesian)
+      reference_point(0,0,cartesian),
+      centerline_table_fractions(0),
+      distance_field_resolution(0),
+      distance_field_tolerance(0)
     {
       this->world = world_;
       this->name = "fault";
@@ -86,6 +90,23 @@ namespace WorldBuilder
         {
           // This only happens if we are not in sections
           prm.declare_entry("sections", Types::Array(Types::PluginSystem("",Features::Fault::declare_entries, {"coordinate"}, false)),"A list of feature properties for a coordinate.");
+
+          prm.declare_entry("centerline table fractions", Types::UnsignedInt(0),
+                            "The number of intervals between two coordinates at which the directions of the "
+                            "segments are tabulated when the world is created, and interpolated for every point. "
+                            "Between coordinates at which all the segments have the same angles, the directions "
+                            "are tabulated once, because they do not change. The results differ from the computed "
+                            "directions in the last digits. When this is zero, no table is built and the "
+                            "directions are computed for every point.");
+          prm.declare_entry("distance field resolution", Types::Double(0),
+                            "When larger than zero, the distances to the planes of this feature are sampled on a grid "
+                            "with this cell size in meters in a narrow band around the feature when the world is created, "
+                            "and interpolated instead of computed for every point. Cells which contain a section or "
+                            "segment boundary, or in which the interpolation error is larger than the distance field "
+                            "tolerance, are still computed exactly. This is only used in cartesian coordinate systems.");
+          prm.declare_entry("distance field tolerance", Types::Double(100),
+                            "The maximum interpolation error in meters of the distance field at the center of a cell "
+                            "for the cell to be interpolated.");
         }
       else
         {
@@ -109,6 +130,9 @@ namespace WorldBuilder
 
       starting_depth = prm.get<double>("min depth");
       maximum_depth = prm.get<double>("max depth");
+      centerline_table_fractions = prm.get<unsigned int>("centerline table fractions");
+      distance_field_resolution = prm.get<double>("distance field resolution");
+      distance_field_tolerance = prm.get<double>("distance field tolerance");
 
       const size_t n_sections = this->original_number_of_coordinates;
 
@@ -257,36 +281,174 @@ namespace WorldBuilder
       prm.leave_subsection();
 
 
+      fill_segment_tables();
+
+      add_to_profiler();
+      for (auto &section : segment_vector)
+        for (auto &segment : section)
+          {
+            add_models_to_profiler(segment.temperature_systems);
+            add_models_to_profiler(segment.composition_systems);
+          }
+    }
+
+
+    void
+    Fault::fill_segment_tables()
+    {
+      // All the sections have the same number of segments, which is checked
+      // while parsing.
+      const size_t n_sections = segment_vector.size();
+      const size_t n_segments = n_sections > 0 ? segment_vector[0].size() : 0;
+      segment_table.reinit(n_sections, n_segments);
+      temperature_model_table.reinit(n_segments);
+      composition_model_table.reinit(n_segments);
+
       maximum_slab_thickness = 0;
       maximum_total_slab_length = 0;
-      total_slab_length.resize(original_number_of_coordinates);
-      slab_segment_lengths.resize(original_number_of_coordinates);
-      slab_segment_thickness.resize(original_number_of_coordinates);
-      slab_segment_top_truncation.resize(original_number_of_coordinates);
-      slab_segment_angles.resize(original_number_of_coordinates);
-
-      for (unsigned int i = 0; i < segment_vector.size(); ++i)
+      double maximum_distance_from_plane = 0;
+      for (size_t i = 0; i < n_sections; ++i)
         {
           double local_total_slab_length = 0;
-          slab_segment_lengths[i].resize(segment_vector[i].size());
-          slab_segment_thickness[i].resize(segment_vector[i].size(), Point<2>(invalid));
-          slab_segment_top_truncation[i].resize(segment_vector[i].size(), Point<2>(invalid));
-          slab_segment_angles[i].resize(segment_vector[i].size(), Point<2>(invalid));
-
-          for (unsigned int j = 0; j < segment_vector[i].size(); ++j)
+          for (size_t j = 0; j < n_segments; ++j)
             {
-              slab_segment_lengths[i][j] = segment_vector[i][j].value_length;
-              local_total_slab_length += segment_vector[i][j].value_length;
-
-              slab_segment_thickness[i][j] = segment_vector[i][j].value_thickness;
-              slab_segment_top_truncation[i][j] = segment_vector[i][j].value_top_truncation;
-
-              slab_segment_angles[i][j] = segment_vector[i][j].value_angle * (const_pi/180);
+              const auto &segment = segment_vector[i][j];
+              segment_table(SegmentTable::length, i, j) = segment.value_length;
+              segment_table(SegmentTable::thickness_top, i, j) = segment.value_thickness[0];
+              segment_table(SegmentTable::thickness_bottom, i, j) = segment.value_thickness[1];
+              segment_table(SegmentTable::top_truncation_top, i, j) = segment.value_top_truncation[0];
+              segment_table(SegmentTable::top_truncation_bottom, i, j) = segment.value_top_truncation[1];
+              segment_table(SegmentTable::angle_top, i, j) = segment.value_angle[0] * (const_pi/180);
+              segment_table(SegmentTable::angle_bottom, i, j) = segment.value_angle[1] * (const_pi/180);
+              local_total_slab_length += segment.value_length;
+              maximum_distance_from_plane = std::max(maximum_distance_from_plane,
+                                                     std::max(std::max(std::fabs(segment.value_thickness[0]),
+                                                                       std::fabs(segment.value_thickness[1])),
+                                                              std::max(std::fabs(segment.value_top_truncation[0]),
+                                                                       std::fabs(segment.value_top_truncation[1]))));
+
+              temperature_model_table.add_segment(segment.temperature_systems);
+              composition_model_table.add_segment(segment.composition_systems);
             }
           maximum_slab_thickness = std::max(maximum_slab_thickness, local_total_slab_length);
-          total_slab_length[i] = local_total_slab_length;
+          segment_table.total_length(i) = local_total_slab_length;
           maximum_total_slab_length = std::max(maximum_total_slab_length, local_total_slab_length);
         }
+
+      // A segment can not be further from the surface trace of its section
+      // than its length along the plane, so a point which is further away
+      // from the trace than the total length plus the thickness can not be
+      // in the slab. In a cartesian coordinate system this is a horizontal
+      // distance, which the section index uses to only search the sections
+      // close to a point. In spherical coordinates the natural coordinates
+      // are angles, which do not give such a simple bound, so all the
+      // sections are searched, but the distance still bounds the angle to
+      // the trace, which the slab envelope uses.
+      double maximum_length = 0;
+      for (size_t i = 0; i < n_sections; ++i)
+        {
+          double absolute_length = 0;
+          for (size_t j = 0; j < n_segments; ++j)
+            absolute_length += std::fabs(segment_table(SegmentTable::length, i, j));
+          maximum_length = std::max(maximum_length, absolute_length);
+        }
+      double reach = maximum_length + maximum_distance_from_plane;
+      reach += 1e-6 * std::max(reach, 1.0);
+
+      // The angle which the depth method angle_at_begin_segment_with_surface
+      // adds to the segments depends on the radius, so the table is not
+      // used for it.
+      centerline_table.clear();
+      if (world->parameters.coordinate_system->depth_method() != DepthMethod::angle_at_begin_segment_with_surface)
+        centerline_table.reinit(segment_table, centerline_table_fractions);
+
+      section_index.clear();
+      slab_envelope.clear();
+      if (world->parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::cartesian)
+        section_index.reinit(coordinates, reach);
+      else if (world->parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical)
+        slab_envelope.reinit(coordinates, reach);
+
+      // The distance field is sampled in the horizontal coordinates and the
+      // depth below the surface of the feature, because in a cartesian
+      // coordinate system the distances only depend on the depth and not on
+      // where the surface is.
+      distance_field.clear();
+      if (distance_field_resolution > 0
+          && world->parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::cartesian
+          && coordinates.size() > 1)
+        {
+          std::array<double,3> lower_corner = {{coordinates[0][0], coordinates[0][1], 0}};
+          std::array<double,3> upper_corner = {{coordinates[0][0], coordinates[0][1], reach}};
+          for (auto &coordinate : coordinates)
+            for (unsigned int d = 0; d < 2; ++d)
+              {
+                lower_corner[d] = std::min(lower_corner[d], coordinate[d] - reach);
+                upper_corner[d] = std::max(upper_corner[d], coordinate[d] + reach);
+              }
+
+          // The coordinates between two of the original coordinates form
+          // one section for the feature, so the field stores the first of
+          // them, which allows it to interpolate across them.
+          std::vector<size_t> first_section(one_dimensional_coordinates.size(), 0);
+          for (size_t i = 1; i < one_dimensional_coordinates.size(); ++i)
+            first_section[i] = static_cast<size_t>(one_dimensional_coordinates[i]) == static_cast<size_t>(one_dimensional_coordinates[i-1])
+                               ? first_section[i-1] : i;
+
+          const double surface = reach + 1;
+          distance_field.reinit(lower_corner, upper_corner, distance_field_resolution, distance_field_tolerance,
+                                maximum_distance_from_plane + std::sqrt(3.) * distance_field_resolution,
+                                maximum_total_slab_length,
+                                [&](const std::array<double,3> &point)
+          {
+            WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance =
+              Utilities::distance_point_from_curved_planes(Point<3>(point[0], point[1], surface - point[2], cartesian),
+                                                           reference_point,
+                                                           coordinates,
+                                                           segment_table,
+                                                           surface,
+                                                           this->world->parameters.coordinate_system,
+                                                           true,
+                                                           one_dimensional_coordinates,
+                                                           &section_index,
+                                                           &centerline_table);
+            distance.section = first_section[distance.section];
+            return distance;
+          });
+        }
+    }
+
+
+    WorldBuilder::Utilities::PointDistanceFromCurvedPlanes
+    Fault::compute_distance_from_planes(const Point<3> &position, const double starting_radius) const
+    {
+      WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance;
+      if (distance_field.interpolate({{position[0], position[1], starting_radius - position[2]}}, distance))
+        return distance;
+
+      return Utilities::distance_point_from_curved_planes(position,
+                                                          reference_point,
+                                                          coordinates,
+                                                          segment_table,
+                                                          starting_radius,
+                                                          this->world->parameters.coordinate_system,
+                                                          true,
+                                                          one_dimensional_coordinates,
+                                                          &section_index,
+                                                          &centerline_table,
+                                                          world->query_hints.get_section(query_hint_entry));
+    }
+
+
+    bool
+    Fault::may_contain(const Point<3> &position,
+                       const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                       const double starting_radius) const
+    {
+      if (section_index.is_initialized())
+        return section_index.sections(Point<2>(natural_coordinate.get_surface_coordinates(), cartesian)).size() > 0;
+
+      return slab_envelope.may_contain(position, starting_radius);
     }
 
 
@@ -296,6 +458,8 @@ namespace WorldBuilder
                        const double gravity_norm,
                        double temperature) const
     {
+      Profiler::Scope scope(world->profiler, profiler_entry, Profiler::temperature);
+
       WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
                                                                       *(world->parameters.coordinate_system));
 
@@ -312,118 +476,21 @@ namespace WorldBuilder
               );
 
       // todo: explain and check -starting_depth
-      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness)
+      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness
+          && may_contain(position, natural_coordinate, starting_radius))
         {
           // todo: explain
           // This function only returns positive values, because we want
           // the fault to be centered around the line provided by the user.
-          std::map<std::string,double> distance_from_planes =
-            Utilities::distance_point_from_curved_planes(position,
-                                                         reference_point,
-                                                         coordinates,
-                                                         slab_segment_lengths,
-                                                         slab_segment_angles,
-                                                         starting_radius,
-                                                         this->world->parameters.coordinate_system,
-                                                         true,
-                                                         one_dimensional_coordinates);
-
-          const double distance_from_plane = distance_from_planes["distanceFromPlane"];
-          const double distance_along_plane = distance_from_planes["distanceAlongPlane"];
-          const double section_fraction = distance_from_planes["sectionFraction"];
-          const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[static_cast<size_t>(distance_from_planes["section"])]));
-          const size_t next_section = current_section + 1;
-          const size_t current_segment = static_cast<size_t>(distance_from_planes["segment"]); // the original value was a unsigned in, converting it back.
-          //const size_t next_segment = current_segment + 1;
-          const double segment_fraction = distance_from_planes["segmentFraction"];
-
-          if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
-            {
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-
-              const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
-                                          + section_fraction
-                                          * (slab_segment_thickness[next_section][current_segment][0]
-                                             - slab_segment_thickness[current_section][current_segment][0]);
-              const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
-                                            + section_fraction
-                                            * (slab_segment_thickness[next_section][current_segment][1]
-                                               - slab_segment_thickness[current_section][current_segment][1]);
-              const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
-
-              const double max_slab_length = total_slab_length[current_section] +
-                                             section_fraction *
-                                             (total_slab_length[next_section] - total_slab_length[current_section]);
-
-              // secondly for top truncation
-              const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
-                                               + section_fraction
-                                               * (slab_segment_top_truncation[next_section][current_segment][0]
-                                                  - slab_segment_top_truncation[current_section][current_segment][0]);
-              const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
-                                                 + section_fraction
-                                                 * (slab_segment_top_truncation[next_section][current_segment][1]
-                                                    - slab_segment_top_truncation[current_section][current_segment][1]);
-              const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
-
-              // if the thickness is zero, we don't need to compute anything, so return.
-              if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
-                return temperature;
-
-              // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
-              if (thickness_local < top_truncation_local)
-                return temperature;
-
-              // Because both sides return positve values, we have to
-              // devide the thickness_local by two
-              if (std::fabs(distance_from_plane) > 0 &&
-                  std::fabs(distance_from_plane) <= thickness_local * 0.5 &&
-                  distance_along_plane > 0 &&
-                  distance_along_plane <= max_slab_length)
-                {
-                  // Inside the fault!
-                  double temperature_current_section = temperature;
-                  double temperature_next_section = temperature;
+          WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
+            compute_distance_from_planes(position, starting_radius);
 
-                  for (auto &temperature_model: segment_vector[current_section][current_segment].temperature_systems)
-                    {
-                      temperature_current_section = temperature_model->get_temperature(position,
-                                                                                       depth,
-                                                                                       gravity_norm,
-                                                                                       temperature_current_section,
-                                                                                       starting_depth,
-                                                                                       maximum_depth,
-                                                                                       distance_from_planes);
-
-                      WBAssert(!std::isnan(temperature_current_section), "Temparture is not a number: " << temperature_current_section
-                               << ", based on a temperature model with the name " << temperature_model->get_name());
-                      WBAssert(std::isfinite(temperature_current_section), "Temparture is not a finite: " << temperature_current_section
-                               << ", based on a temperature model with the name " << temperature_model->get_name());
-                    }
-
-                  for (auto &temperature_model: segment_vector[next_section][current_segment].temperature_systems)
-                    {
-                      temperature_next_section = temperature_model->get_temperature(position,
-                                                                                    depth,
-                                                                                    gravity_norm,
-                                                                                    temperature_next_section,
-                                                                                    starting_depth,
-                                                                                    maximum_depth,
-                                                                                    distance_from_planes);
-
-                      WBAssert(!std::isnan(temperature_next_section), "Temparture is not a number: " << temperature_next_section
-                               << ", based on a temperature model with the name " << temperature_model->get_name());
-                      WBAssert(std::isfinite(temperature_next_section), "Temparture is not a finite: " << temperature_next_section
-                               << ", based on a temperature model with the name " << temperature_model->get_name());
-
-                    }
-
-
-                  // linear interpolation between current and next section temperatures
-                  temperature = temperature_current_section + section_fraction * (temperature_next_section - temperature_current_section);
-
-                }
-            }
+          temperature = apply_temperature_models(position, depth, gravity_norm, temperature,
+                                                 distance_from_planes, scope);
+        }
+      else
+        {
+          scope.early_reject();
         }
       return temperature;
     }
@@ -434,132 +501,461 @@ namespace WorldBuilder
                        const unsigned int composition_number,
                        double composition) const
     {
+      Profiler::Scope scope(world->profiler, profiler_entry, Profiler::composition);
+
       WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
                                                                       *(world->parameters.coordinate_system));
       // todo: explain
       const double starting_radius = natural_coordinate.get_depth_coordinate() + depth - starting_depth;
 
       // todo: explain and check -starting_depth
-      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness)
+      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness
+          && may_contain(position, natural_coordinate, starting_radius))
         {
           // todo: explain
           // This function only returns positive values, because we want
           // the fault to be centered around the line provided by the user.
-          std::map<std::string,double> distance_from_planes =
-            Utilities::distance_point_from_curved_planes(position,
-                                                         reference_point,
-                                                         coordinates,
-                                                         slab_segment_lengths,
-                                                         slab_segment_angles,
-                                                         starting_radius,
-                                                         this->world->parameters.coordinate_system,
-                                                         true,
-                                                         one_dimensional_coordinates);
-
-          const double distance_from_plane = distance_from_planes["distanceFromPlane"];
-          const double distance_along_plane = distance_from_planes["distanceAlongPlane"];
-          const double section_fraction = distance_from_planes["sectionFraction"];
-          const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[static_cast<size_t>(distance_from_planes["section"])]));
-          const size_t next_section = current_section + 1;
-          const size_t current_segment = static_cast<size_t>(distance_from_planes["segment"]); // the original value was a unsigned int, turning it back.
-          //const size_t next_segment = current_segment + 1;
-          const double segment_fraction = distance_from_planes["segmentFraction"];
-
-          if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
+          WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
+            compute_distance_from_planes(position, starting_radius);
+
+          composition = apply_composition_models(position, depth, composition_number, composition,
+                                                 distance_from_planes, scope);
+        }
+      else
+        {
+          scope.early_reject();
+        }
+
+
+      return composition;
+    }
+
+    template<class Function>
+    void
+    Fault::for_each_distance_from_planes(const size_t n_points,
+                                         const double *x,
+                                         const double *y,
+                                         const double *z,
+                                         const double *depths,
+                                         const Function &function) const
+    {
+      // The points for which the distance is not interpolated from the
+      // distance field are collected, so that their distances can be
+      // computed together.
+      const size_t block_size = 64;
+      size_t block_points[block_size];
+      double block_x[block_size], block_y[block_size], block_z[block_size], block_radii[block_size];
+      WorldBuilder::Utilities::PointDistanceFromCurvedPlanes block_distances[block_size];
+      size_t n_block_points = 0;
+
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          const Point<3> position(x[i], y[i], z[i], cartesian);
+          WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
+                                                                          *(world->parameters.coordinate_system));
+          const double depth = depths[i];
+          const double starting_radius = natural_coordinate.get_depth_coordinate() + depth - starting_depth;
+
+          if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness
+              && may_contain(position, natural_coordinate, starting_radius))
             {
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-
-              const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
-                                          + section_fraction
-                                          * (slab_segment_thickness[next_section][current_segment][0]
-                                             - slab_segment_thickness[current_section][current_segment][0]);
-              const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
-                                            + section_fraction
-                                            * (slab_segment_thickness[next_section][current_segment][1]
-                                               - slab_segment_thickness[current_section][current_segment][1]);
-              const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
-
-              // secondly for top truncation
-              const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
-                                               + section_fraction
-                                               * (slab_segment_top_truncation[next_section][current_segment][0]
-                                                  - slab_segment_top_truncation[current_section][current_segment][0]);
-              const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
-                                                 + section_fraction
-                                                 * (slab_segment_top_truncation[next_section][current_segment][1]
-                                                    - slab_segment_top_truncation[current_section][current_segment][1]);
-              const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
-
-              // if the thickness is zero, we don't need to compute anything, so return.
-              if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
-                return composition;
-
-              // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
-              if (thickness_local < top_truncation_local)
-                return composition;
-
-              const double max_slab_length = total_slab_length[current_section] +
-                                             section_fraction *
-                                             (total_slab_length[next_section] - total_slab_length[current_section]);
-
-
-              // Because both sides return positve values, we have to
-              // devide the thickness_local by two
-              if (std::fabs(distance_from_plane) > 0 &&
-                  std::fabs(distance_from_plane) <= thickness_local * 0.5 &&
-                  distance_along_plane > 0 &&
-                  distance_along_plane <= max_slab_length)
+              WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes;
+              if (distance_field.interpolate({{position[0], position[1], starting_radius - position[2]}}, distance_from_planes))
+                {
+                  function(i, distance_from_planes);
+                }
+              else
                 {
-                  // Inside the fault!
-                  double composition_current_section = composition;
-                  double composition_next_section = composition;
+                  block_points[n_block_points] = i;
+                  block_x[n_block_points] = x[i];
+                  block_y[n_block_points] = y[i];
+                  block_z[n_block_points] = z[i];
+                  block_radii[n_block_points] = starting_radius;
+                  ++n_block_points;
+                }
+            }
 
-                  for (auto &composition_model: segment_vector[current_section][current_segment].composition_systems)
-                    {
-                      composition_current_section = composition_model->get_composition(position,
-                                                                                       depth,
-                                                                                       composition_number,
-                                                                                       composition_current_section,
-                                                                                       starting_depth,
-                                                                                       maximum_depth,
-                                                                                       distance_from_planes);
-
-                      WBAssert(!std::isnan(composition_current_section), "Composition_current_section is not a number: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-                      WBAssert(std::isfinite(composition_current_section), "Composition_current_section is not a finite: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
+          if (n_block_points == block_size || (i + 1 == n_points && n_block_points > 0))
+            {
+              Utilities::distance_points_from_curved_planes(n_block_points, block_x, block_y, block_z, block_radii,
+                                                            reference_point,
+                                                            coordinates,
+                                                            segment_table,
+                                                            this->world->parameters.coordinate_system,
+                                                            true,
+                                                            one_dimensional_coordinates,
+                                                            &section_index,
+                                                            &centerline_table,
+                                                            block_distances);
+              for (size_t j = 0; j < n_block_points; ++j)
+                function(block_points[j], block_distances[j]);
+              n_block_points = 0;
+            }
+        }
+    }
 
-                    }
+    void
+    Fault::temperatures(const size_t n_points,
+                        const double *x,
+                        const double *y,
+                        const double *z,
+                        const double *depths,
+                        const double *gravity_norms,
+                        double *temperatures) const
+    {
+      // The profiler measures the time of every point, so then the points
+      // are processed one by one.
+      if (world->profiler.is_enabled())
+        {
+          Interface::temperatures(n_points, x, y, z, depths, gravity_norms, temperatures);
+          return;
+        }
 
-                  for (auto &composition_model: segment_vector[next_section][current_segment].composition_systems)
-                    {
-                      composition_next_section = composition_model->get_composition(position,
-                                                                                    depth,
-                                                                                    composition_number,
-                                                                                    composition_next_section,
-                                                                                    starting_depth,
-                                                                                    maximum_depth,
-                                                                                    distance_from_planes);
-
-                      WBAssert(!std::isnan(composition_next_section), "Composition_next_section is not a number: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-                      WBAssert(std::isfinite(composition_next_section), "Composition_next_section is not a finite: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
+      for_each_distance_from_planes(n_points, x, y, z, depths,
+                                    [&](const size_t i, WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes)
+      {
+        Profiler::Scope scope(world->profiler, profiler_entry, Profiler::temperature);
+        temperatures[i] = apply_temperature_models(Point<3>(x[i], y[i], z[i], cartesian), depths[i], gravity_norms[i],
+                                                   temperatures[i], distance_from_planes, scope);
+      });
+    }
 
-                    }
+    void
+    Fault::compositions(const size_t n_points,
+                        const double *x,
+                        const double *y,
+                        const double *z,
+                        const double *depths,
+                        const unsigned int composition_number,
+                        double *values) const
+    {
+      if (world->profiler.is_enabled())
+        {
+          Interface::compositions(n_points, x, y, z, depths, composition_number, values);
+          return;
+        }
+
+      for_each_distance_from_planes(n_points, x, y, z, depths,
+                                    [&](const size_t i, WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes)
+      {
+        Profiler::Scope scope(world->profiler, profiler_entry, Profiler::composition);
+        values[i] = apply_composition_models(Point<3>(x[i], y[i], z[i], cartesian), depths[i], composition_number,
+                                             values[i], distance_from_planes, scope);
+      });
+    }
 
-                  // linear interpolation between current and next section temperatures
-                  composition = composition_current_section + section_fraction * (composition_next_section - composition_current_section);
+    double
+    Fault::apply_temperature_models(const Point<3> &position,
+                                    const double depth,
+                                    const double gravity_norm,
+                                    double temperature,
+                                    WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes,
+                                    Profiler::Scope &scope) const
+    {
+      const double distance_from_plane = distance_from_planes.distance_from_plane;
+      const double distance_along_plane = distance_from_planes.distance_along_plane;
+      const double section_fraction = distance_from_planes.section_fraction;
+      const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[distance_from_planes.section]));
+      const size_t next_section = current_section + 1;
+      const size_t current_segment = distance_from_planes.segment;
+      //const size_t next_segment = current_segment + 1;
+      const double segment_fraction = distance_from_planes.segment_fraction;
+
+      if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
+        {
+          // We want to do both section (horizontal) and segment (vertical) interpolation.
+
+          const double thickness_up = segment_table(SegmentTable::thickness_top, current_section, current_segment)
+                                      + section_fraction
+                                      * (segment_table(SegmentTable::thickness_top, next_section, current_segment)
+                                         - segment_table(SegmentTable::thickness_top, current_section, current_segment));
+          const double thickness_down = segment_table(SegmentTable::thickness_bottom, current_section, current_segment)
+                                        + section_fraction
+                                        * (segment_table(SegmentTable::thickness_bottom, next_section, current_segment)
+                                           - segment_table(SegmentTable::thickness_bottom, current_section, current_segment));
+          const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
+
+          const double max_slab_length = segment_table.total_length(current_section) +
+                                         section_fraction *
+                                         (segment_table.total_length(next_section) - segment_table.total_length(current_section));
+
+          // secondly for top truncation
+          const double top_truncation_up = segment_table(SegmentTable::top_truncation_top, current_section, current_segment)
+                                           + section_fraction
+                                           * (segment_table(SegmentTable::top_truncation_top, next_section, current_segment)
+                                              - segment_table(SegmentTable::top_truncation_top, current_section, current_segment));
+          const double top_truncation_down = segment_table(SegmentTable::top_truncation_bottom, current_section, current_segment)
+                                             + section_fraction
+                                             * (segment_table(SegmentTable::top_truncation_bottom, next_section, current_segment)
+                                                - segment_table(SegmentTable::top_truncation_bottom, current_section, current_segment));
+          const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
+
+          // if the thickness is zero, we don't need to compute anything, so return.
+          if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
+            return temperature;
+
+          // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
+          if (thickness_local < top_truncation_local)
+            return temperature;
+
+          // Because both sides return positve values, we have to
+          // devide the thickness_local by two
+          if (std::fabs(distance_from_plane) > 0 &&
+              std::fabs(distance_from_plane) <= thickness_local * 0.5 &&
+              distance_along_plane > 0 &&
+              distance_along_plane <= max_slab_length)
+            {
+              // Inside the fault!
+              scope.hit();
+              double temperature_current_section = temperature;
+              double temperature_next_section = temperature;
 
+              for (auto temperature_model: temperature_model_table(current_section, current_segment))
+                {
+                  Profiler::Scope model_scope(world->profiler, temperature_model, Profiler::temperature);
+                  const double old_temperature_current_section = temperature_current_section;
+                  temperature_current_section = temperature_model->get_temperature(position,
+                                                                                   depth,
+                                                                                   gravity_norm,
+                                                                                   temperature_current_section,
+                                                                                   starting_depth,
+                                                                                   maximum_depth,
+                                                                                   distance_from_planes);
+                  model_scope.hit_if_changed(old_temperature_current_section, temperature_current_section);
+
+                  WBAssert(!std::isnan(temperature_current_section), "Temparture is not a number: " << temperature_current_section
+                           << ", based on a temperature model with the name " << temperature_model->get_name());
+                  WBAssert(std::isfinite(temperature_current_section), "Temparture is not a finite: " << temperature_current_section
+                           << ", based on a temperature model with the name " << temperature_model->get_name());
+                }
+
+              for (auto temperature_model: temperature_model_table(next_section, current_segment))
+                {
+                  Profiler::Scope model_scope(world->profiler, temperature_model, Profiler::temperature);
+                  const double old_temperature_next_section = temperature_next_section;
+                  temperature_next_section = temperature_model->get_temperature(position,
+                                                                                depth,
+                                                                                gravity_norm,
+                                                                                temperature_next_section,
+                                                                                starting_depth,
+                                                                                maximum_depth,
+                                                                                distance_from_planes);
+                  model_scope.hit_if_changed(old_temperature_next_section, temperature_next_section);
+
+                  WBAssert(!std::isnan(temperature_next_section), "Temparture is not a number: " << temperature_next_section
+                           << ", based on a temperature model with the name " << temperature_model->get_name());
+                  WBAssert(std::isfinite(temperature_next_section), "Temparture is not a finite: " << temperature_next_section
+                           << ", based on a temperature model with the name " << temperature_model->get_name());
 
                 }
+
+
+              // linear interpolation between current and next section temperatures
+              temperature = temperature_current_section + section_fraction * (temperature_next_section - temperature_current_section);
+
             }
         }
+      return temperature;
+    }
+
+    double
+    Fault::apply_composition_models(const Point<3> &position,
+                                    const double depth,
+                                    const unsigned int composition_number,
+                                    double composition,
+                                    WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes,
+                                    Profiler::Scope &scope) const
+    {
+      const double distance_from_plane = distance_from_planes.distance_from_plane;
+      const double distance_along_plane = distance_from_planes.distance_along_plane;
+      const double section_fraction = distance_from_planes.section_fraction;
+      const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[distance_from_planes.section]));
+      const size_t next_section = current_section + 1;
+      const size_t current_segment = distance_from_planes.segment;
+      //const size_t next_segment = current_segment + 1;
+      const double segment_fraction = distance_from_planes.segment_fraction;
+
+      if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
+        {
+          // We want to do both section (horizontal) and segment (vertical) interpolation.
+
+          const double thickness_up = segment_table(SegmentTable::thickness_top, current_section, current_segment)
+                                      + section_fraction
+                                      * (segment_table(SegmentTable::thickness_top, next_section, current_segment)
+                                         - segment_table(SegmentTable::thickness_top, current_section, current_segment));
+          const double thickness_down = segment_table(SegmentTable::thickness_bottom, current_section, current_segment)
+                                        + section_fraction
+                                        * (segment_table(SegmentTable::thickness_bottom, next_section, current_segment)
+                                           - segment_table(SegmentTable::thickness_bottom, current_section, current_segment));
+          const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
+
+          // secondly for top truncation
+          const double top_truncation_up = segment_table(SegmentTable::top_truncation_top, current_section, current_segment)
+                                           + section_fraction
+                                           * (segment_table(SegmentTable::top_truncation_top, next_section, current_segment)
+                                              - segment_table(SegmentTable::top_truncation_top, current_section, current_segment));
+          const double top_truncation_down = segment_table(SegmentTable::top_truncation_bottom, current_section, current_segment)
+                                             + section_fraction
+                                             * (segment_table(SegmentTable::top_truncation_bottom, next_section, current_segment)
+                                                - segment_table(SegmentTable::top_truncation_bottom, current_section, current_segment));
+          const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
+
+          // if the thickness is zero, we don't need to compute anything, so return.
+          if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
+            return composition;
+
+          // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
+          if (thickness_local < top_truncation_local)
+            return composition;
+
+          const double max_slab_length = segment_table.total_length(current_section) +
+                                         section_fraction *
+                                         (segment_table.total_length(next_section) - segment_table.total_length(current_section));
+
+
+          // Because both sides return positve values, we have to
+          // devide the thickness_local by two
+          if (std::fabs(distance_from_plane) > 0 &&
+              std::fabs(distance_from_plane) <= thickness_local * 0.5 &&
+              distance_along_plane > 0 &&
+              distance_along_plane <= max_slab_length)
+            {
+              // Inside the fault!
+              scope.hit();
+              double composition_current_section = composition;
+              double composition_next_section = composition;
 
+              for (auto composition_model: composition_model_table(current_section, current_segment))
+                {
+                  Profiler::Scope model_scope(world->profiler, composition_model, Profiler::composition);
+                  const double old_composition_current_section = composition_current_section;
+                  composition_current_section = composition_model->get_composition(position,
+                                                                                   depth,
+                                                                                   composition_number,
+                                                                                   composition_current_section,
+                                                                                   starting_depth,
+                                                                                   maximum_depth,
+                                                                                   distance_from_planes);
+                  model_scope.hit_if_changed(old_composition_current_section, composition_current_section);
+
+                  WBAssert(!std::isnan(composition_current_section), "Composition_current_section is not a number: " << composition_current_section
+                           << ", based on a temperature model with the name " << composition_model->get_name());
+                  WBAssert(std::isfinite(composition_current_section), "Composition_current_section is not a finite: " << composition_current_section
+                           << ", based on a temperature model with the name " << composition_model->get_name());
 
+                }
+
+              for (auto composition_model: composition_model_table(next_section, current_segment))
+                {
+                  Profiler::Scope model_scope(world->profiler, composition_model, Profiler::composition);
+                  const double old_composition_next_section = composition_next_section;
+                  composition_next_section = composition_model->get_composition(position,
+                                                                                depth,
+                                                                                composition_number,
+                                                                                composition_next_section,
+                                                                                starting_depth,
+                                                                                maximum_depth,
+                                                                                distance_from_planes);
+                  model_scope.hit_if_changed(old_composition_next_section, composition_next_section);
+
+                  WBAssert(!std::isnan(composition_next_section), "Composition_next_section is not a number: " << composition_next_section
+                           << ", based on a temperature model with the name " << composition_model->get_name());
+                  WBAssert(std::isfinite(composition_next_section), "Composition_next_section is not a finite: " << composition_next_section
+                           << ", based on a temperature model with the name " << composition_model->get_name());
+
+                }
+
+              // linear interpolation between current and next section temperatures
+              composition = composition_current_section + section_fraction * (composition_next_section - composition_current_section);
+
+
+            }
+        }
       return composition;
     }
 
+    void
+    Fault::release_parse_data()
+    {
+      default_temperature_models.clear();
+      default_temperature_models.shrink_to_fit();
+      default_composition_models.clear();
+      default_composition_models.shrink_to_fit();
+      default_segment_vector.clear();
+      default_segment_vector.shrink_to_fit();
+      sections_segment_vector.clear();
+      sections_segment_vector.shrink_to_fit();
+    }
+
+    std::pair<double,double>
+    Fault::depth_range() const
+    {
+      return std::make_pair(starting_depth, std::min(maximum_depth, maximum_total_slab_length + maximum_slab_thickness));
+    }
+
+    void
+    Fault::serialize(Snapshot &snapshot)
+    {
+      serialize_interface(snapshot);
+      // The default segments and models are only used while parsing, so
+      // only the segments of every section are stored.
+      snapshot(starting_depth, maximum_depth, reference_point, segment_vector,
+               centerline_table_fractions, distance_field_resolution, distance_field_tolerance);
+
+      if (snapshot.is_loading())
+        {
+          fill_segment_tables();
+          add_to_profiler();
+          for (auto &section : segment_vector)
+            for (auto &segment : section)
+              {
+                add_models_to_profiler(segment.temperature_systems);
+                add_models_to_profiler(segment.composition_systems);
+              }
+        }
+    }
+
+    void
+    Fault::memory_usage(std::vector<std::pair<std::string,std::size_t> > &components) const
+    {
+      interface_memory_usage(components, sizeof(*this));
+
+      components.emplace_back(name + ": slab segment tables",
+                              segment_table.memory_usage()
+                              + centerline_table.memory_usage()
+                              + temperature_model_table.memory_usage()
+                              + composition_model_table.memory_usage());
+
+      components.emplace_back(name + ": section index and envelope",
+                              section_index.memory_usage() + slab_envelope.memory_usage());
+
+      if (distance_field.is_initialized())
+        components.emplace_back(name + ": distance field", distance_field.memory_usage());
+
+      components.emplace_back(name + ": segments",
+                              WorldBuilder::Utilities::memory_usage(default_segment_vector)
+                              + WorldBuilder::Utilities::memory_usage(sections_segment_vector)
+                              + WorldBuilder::Utilities::memory_usage(segment_vector));
+
+      // The models are shared between the default segments, the segments of
+      // the sections and the segments of the coordinates.
+      std::set<const void *> counted_models;
+      std::size_t model_bytes = models_memory_usage(default_temperature_models, counted_models)
+                                + models_memory_usage(default_composition_models, counted_models);
+      for (auto &segment : default_segment_vector)
+        model_bytes += models_memory_usage(segment.temperature_systems, counted_models)
+                       + models_memory_usage(segment.composition_systems, counted_models);
+      for (auto &segments : sections_segment_vector)
+        for (auto &segment : segments)
+          model_bytes += models_memory_usage(segment.temperature_systems, counted_models)
+                         + models_memory_usage(segment.composition_systems, counted_models);
+      for (auto &segments : segment_vector)
+        for (auto &segment : segments)
+          model_bytes += models_memory_usage(segment.temperature_systems, counted_models)
+                         + models_memory_usage(segment.composition_systems, counted_models);
+      components.emplace_back(name + ": models", model_bytes);
+    }
+
     /**
      * Register plugin
      */
@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -95,10 +96,10 @@ namespace WorldBuilder
                                  double composition_,
                                  const double ,
                                  const double ,
-                                 const std::map<std::string,double> &distance_from_plane) const
+                                 const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_plane) const
         {
           double composition = composition_;
-          if (std::fabs(distance_from_plane.at("distanceFromPlane")) <= max_depth && std::fabs(distance_from_plane.at("distanceFromPlane")) >= min_depth)
+          if (std::fabs(distance_from_plane.distance_from_plane) <= max_depth && std::fabs(distance_from_plane.distance_from_plane) >= min_depth)
             {
               for (unsigned int i =0; i < compositions.size(); ++i)
                 {
@@ -113,6 +114,21 @@ namespace WorldBuilder
             }
           return composition;
         }
+        std::size_t
+        Uniform::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name)
+                 + WorldBuilder::Utilities::memory_usage(compositions)
+                 + WorldBuilder::Utilities::memory_usage(fractions)
+                 + WorldBuilder::Utilities::memory_usage(operation);
+        }
+
+        void
+        Uniform::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, compositions, fractions, operation);
+        }
+
         WB_REGISTER_FEATURE_FAULT_COMPOSITION_MODEL(Uniform, uniform)
       }
     }
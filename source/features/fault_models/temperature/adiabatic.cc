@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -129,7 +130,7 @@ namespace WorldBuilder
                                    double temperature_,
                                    const double ,
                                    const double ,
-                                   const std::map<std::string,double> &) const
+                                   const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &) const
         {
 
           if (depth <= max_depth && depth >= min_depth)
@@ -156,6 +157,19 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        std::size_t
+        Adiabatic::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Adiabatic::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, potential_mantle_temperature,
+                   thermal_expansion_coefficient, specific_heat, operation);
+        }
+
         WB_REGISTER_FEATURE_FAULT_TEMPERATURE_MODEL(Adiabatic, adiabatic)
       }
     }
@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include <world_builder/assert.h>
+#include <world_builder/utilities.h>
 #include <world_builder/types/string.h>
 #include <world_builder/types/object.h>
 #include <world_builder/features/fault_models/temperature/interface.h>
@@ -42,6 +43,12 @@ namespace WorldBuilder
         Interface::~Interface ()
         {}
 
+        std::size_t
+        Interface::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
         void
         Interface::declare_entries(Parameters &prm,
                                    const std::string &parent_name,
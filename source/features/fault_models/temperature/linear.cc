@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -94,10 +95,10 @@ namespace WorldBuilder
                                 double temperature_,
                                 const double /*feature_min_depth*/,
                                 const double /*feature_max_depth*/,
-                                const std::map<std::string,double> &distance_from_planes) const
+                                const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const
         {
 
-          if (std::fabs(distance_from_planes.at("distanceFromPlane")) <= max_depth && std::fabs(distance_from_planes.at("distanceFromPlane")) >= min_depth)
+          if (std::fabs(distance_from_planes.distance_from_plane) <= max_depth && std::fabs(distance_from_planes.distance_from_plane) >= min_depth)
             {
               const double min_depth_local = min_depth;
               const double max_depth_local = max_depth;
@@ -119,7 +120,7 @@ namespace WorldBuilder
                 }
 
               const double new_temperature =   top_temperature +
-                                               (std::fabs(distance_from_planes.at("distanceFromPlane")) - min_depth_local) *
+                                               (std::fabs(distance_from_planes.distance_from_plane) - min_depth_local) *
                                                ((bottom_temperature_local - top_temperature_local) / (max_depth_local - min_depth_local));
 
               return Utilities::apply_operation(operation,temperature_,new_temperature);
@@ -129,6 +130,18 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        std::size_t
+        Linear::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Linear::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, top_temperature, bottom_temperature, operation);
+        }
+
         WB_REGISTER_FEATURE_FAULT_TEMPERATURE_MODEL(Linear, linear)
       }
     }
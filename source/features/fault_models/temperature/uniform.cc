@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -88,16 +89,28 @@ namespace WorldBuilder
                                  double temperature_,
                                  const double ,
                                  const double ,
-                                 const std::map<std::string,double> &distance_from_plane) const
+                                 const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_plane) const
         {
 
-          if (std::fabs(distance_from_plane.at("distanceFromPlane")) <= max_depth && std::fabs(distance_from_plane.at("distanceFromPlane")) >= min_depth)
+          if (std::fabs(distance_from_plane.distance_from_plane) <= max_depth && std::fabs(distance_from_plane.distance_from_plane) >= min_depth)
             {
               return Utilities::apply_operation(operation,temperature_,temperature);
             }
           return temperature_;
         }
 
+        std::size_t
+        Uniform::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Uniform::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, temperature, operation);
+        }
+
         WB_REGISTER_FEATURE_FAULT_TEMPERATURE_MODEL(Uniform, uniform)
       }
     }
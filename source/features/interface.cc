@@ -18,6 +18,7 @@
 */
 
 #include <algorithm>
+#include <limits>
 
 #include <world_builder/features/interface.h>
 #include <world_builder/features/continental_plate.h>
@@ -26,6 +27,7 @@
 #include <world_builder/features/subducting_plate.h>
 #include <world_builder/features/mantle_layer.h>
 #include <world_builder/assert.h>
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 
 
@@ -42,11 +44,93 @@ namespace WorldBuilder
   namespace Features
   {
     Interface::Interface()
+      :
+      profiler_entry(0),
+      query_hint_entry(0)
     {}
 
     Interface::~Interface ()
     {}
 
+    void
+    Interface::temperatures(const size_t n_points,
+                            const double *x,
+                            const double *y,
+                            const double *z,
+                            const double *depths,
+                            const double *gravity_norms,
+                            double *temperatures) const
+    {
+      for (size_t i = 0; i < n_points; ++i)
+        temperatures[i] = temperature(Point<3>(x[i], y[i], z[i], cartesian), depths[i], gravity_norms[i], temperatures[i]);
+    }
+
+    void
+    Interface::compositions(const size_t n_points,
+                            const double *x,
+                            const double *y,
+                            const double *z,
+                            const double *depths,
+                            const unsigned int composition_number,
+                            double *values) const
+    {
+      for (size_t i = 0; i < n_points; ++i)
+        values[i] = composition(Point<3>(x[i], y[i], z[i], cartesian), depths[i], composition_number, values[i]);
+    }
+
+    bool
+    Interface::replaces_temperature(const Point<3> &,
+                                    const double) const
+    {
+      return false;
+    }
+
+    bool
+    Interface::replaces_composition(const Point<3> &,
+                                    const double,
+                                    const unsigned int) const
+    {
+      return false;
+    }
+
+    std::pair<double,double>
+    Interface::depth_range() const
+    {
+      return std::make_pair(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+    }
+
+    void
+    Interface::release_parse_data()
+    {}
+
+    void
+    Interface::serialize_interface(Snapshot &snapshot)
+    {
+      snapshot(name, original_number_of_coordinates, coordinates, one_dimensional_coordinates,
+               temperature_submodule_name, composition_submodule_name);
+    }
+
+    void
+    Interface::interface_memory_usage(std::vector<std::pair<std::string,std::size_t> > &components,
+                                      const std::size_t object_size) const
+    {
+      components.emplace_back(name + ": feature",
+                              object_size
+                              + WorldBuilder::Utilities::memory_usage(name)
+                              + WorldBuilder::Utilities::memory_usage(temperature_submodule_name)
+                              + WorldBuilder::Utilities::memory_usage(composition_submodule_name));
+      components.emplace_back(name + ": coordinates",
+                              WorldBuilder::Utilities::memory_usage(coordinates)
+                              + WorldBuilder::Utilities::memory_usage(one_dimensional_coordinates));
+    }
+
+    void
+    Interface::add_to_profiler()
+    {
+      profiler_entry = world->profiler.add_feature(name);
+      query_hint_entry = world->query_hints.add_feature(name);
+    }
+
     void
     Interface::declare_entries(Parameters &prm, const std::string &parent_name, const std::vector<std::string> &required_entries)
     {
@@ -96,6 +180,7 @@ namespace WorldBuilder
                                Parameters &prm,
                                const CoordinateSystem coordinate_system)
     {
+      Trace::Scope scope(world->trace, "Features::Interface::get_coordinates", "features");
 
       coordinates = prm.get_vector<Point<2> >("coordinates");
       if (coordinate_system == CoordinateSystem::spherical)
@@ -126,7 +211,6 @@ namespace WorldBuilder
             {
               std::vector<double> x_list(original_number_of_coordinates,0.0);
               std::vector<double> y_list(original_number_of_coordinates,0.0);
-              std::vector<Point<2> > coordinate_list_local = coordinates;
               for (size_t j=0; j<original_number_of_coordinates; ++j)
                 {
                   x_list[j] = coordinates[j][0];
@@ -137,32 +221,50 @@ namespace WorldBuilder
               x_spline.set_points(one_dimensional_coordinates_local, x_list, interpolation == "linear" ? false : true);
               y_spline.set_points(one_dimensional_coordinates_local, y_list, interpolation == "linear" ? false : true);
 
-              size_t additional_parts = 0;
-              for (size_t i_plane=0; i_plane<original_number_of_coordinates-1; ++i_plane)
+              // First determine in how many parts every line between two
+              // original coordinates is split, so that the new coordinates
+              // can be added in a single forward pass to vectors of the final
+              // size. Every original coordinate is only evaluated once.
+              const size_t n_planes = original_number_of_coordinates > 0 ? original_number_of_coordinates - 1 : 0;
+              std::vector<size_t> parts(n_planes);
+              size_t n_coordinates = original_number_of_coordinates;
+              Point<2> P1(x_spline(0.0), y_spline(0.0), coordinate_system);
+              for (size_t i_plane=0; i_plane<n_planes; ++i_plane)
                 {
-                  const Point<2> P1 (x_spline(one_dimensional_coordinates_local[i_plane + additional_parts]),
-                                     y_spline(one_dimensional_coordinates_local[i_plane + additional_parts]),
-                                     coordinate_system);
-
-                  const Point<2> P2 (x_spline(one_dimensional_coordinates_local[i_plane + additional_parts + 1]),
-                                     y_spline(one_dimensional_coordinates_local[i_plane  + additional_parts+ 1]),
-                                     coordinate_system);
+                  const Point<2> P2(x_spline(static_cast<double>(i_plane + 1)),
+                                    y_spline(static_cast<double>(i_plane + 1)),
+                                    coordinate_system);
 
                   const double length = (P1 - P2).norm();
-                  const size_t parts = static_cast<size_t>(std::ceil(length / maximum_distance_between_coordinates));
-                  for (size_t j = 1; j < parts; j++)
+                  parts[i_plane] = std::max(static_cast<size_t>(std::ceil(length / maximum_distance_between_coordinates)), static_cast<size_t>(1));
+                  n_coordinates += parts[i_plane] - 1;
+                  P1 = P2;
+                }
+
+              std::vector<Point<2> > coordinate_list_local;
+              coordinate_list_local.reserve(n_coordinates);
+              one_dimensional_coordinates_local.clear();
+              one_dimensional_coordinates_local.reserve(n_coordinates);
+              for (size_t i_plane=0; i_plane<n_planes; ++i_plane)
+                {
+                  coordinate_list_local.push_back(coordinates[i_plane]);
+                  one_dimensional_coordinates_local.push_back(static_cast<double>(i_plane));
+                  for (size_t j = 1; j < parts[i_plane]; j++)
                     {
-                      const double x_position3 = static_cast<double>(i_plane) + static_cast<double>(j)/static_cast<double>(parts);
-                      const Point<2> P3(x_spline(x_position3), y_spline(x_position3), coordinate_system);
-                      one_dimensional_coordinates_local.insert(one_dimensional_coordinates_local.begin() + static_cast<std::vector<double>::difference_type>(additional_parts + i_plane + 1), x_position3);
-                      coordinate_list_local.insert(coordinate_list_local.begin() + static_cast<std::vector<double>::difference_type>(additional_parts + i_plane + 1), P3);
-                      additional_parts++;
+                      const double x_position3 = static_cast<double>(i_plane) + static_cast<double>(j)/static_cast<double>(parts[i_plane]);
+                      coordinate_list_local.push_back(Point<2>(x_spline(x_position3), y_spline(x_position3), coordinate_system));
+                      one_dimensional_coordinates_local.push_back(x_position3);
                     }
                 }
-              coordinates = coordinate_list_local;
+              if (original_number_of_coordinates > 0)
+                {
+                  coordinate_list_local.push_back(coordinates.back());
+                  one_dimensional_coordinates_local.push_back(static_cast<double>(n_planes));
+                }
+              coordinates.swap(coordinate_list_local);
             }
         }
-      one_dimensional_coordinates = one_dimensional_coordinates_local;
+      one_dimensional_coordinates.swap(one_dimensional_coordinates_local);
     }
 
 
@@ -193,7 +295,9 @@ namespace WorldBuilder
       // Using at() because the [] will just insert values
       // which is undesirable in this case. An exception is
       // thrown when the name is not present.
-      return get_factory_map().at(lower_case_name)->create(world);
+      std::unique_ptr<Interface> object = get_factory_map().at(lower_case_name)->create(world);
+      object->plugin_name = lower_case_name;
+      return object;
     }
 
   }
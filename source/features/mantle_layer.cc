@@ -20,6 +20,7 @@
 #include <world_builder/features/mantle_layer.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
+#include <world_builder/snapshot.h>
 #include <world_builder/nan.h>
 #include <world_builder/parameters.h>
 
@@ -106,6 +107,11 @@ namespace WorldBuilder
           }
       }
       prm.leave_subsection();
+
+      add_to_profiler();
+      add_models_to_profiler(temperature_models);
+      add_models_to_profiler(composition_models);
+      build_model_indices();
     }
 
 
@@ -115,21 +121,29 @@ namespace WorldBuilder
                              const double gravity_norm,
                              double temperature) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
+      Profiler::Scope scope(world->profiler, profiler_entry, Profiler::temperature);
 
-      if (depth <= max_depth && depth >= min_depth &&
-          Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
-                                                                  world->parameters.coordinate_system->natural_coordinate_system())))
+      if (depth <= max_depth && depth >= min_depth && contains_surface_point(position))
         {
-          for (auto &temperature_model: temperature_models)
+          scope.hit();
+
+          // The profiler counts the calls of every model, so then all
+          // models are called.
+          const std::vector<unsigned int> &active_models = world->profiler.is_enabled()
+                                                           ? temperature_model_index.all()
+                                                           : temperature_model_index.active(depth);
+          for (const unsigned int i_model : active_models)
             {
+              auto &temperature_model = temperature_models[i_model];
+              Profiler::Scope model_scope(world->profiler, temperature_model.get(), Profiler::temperature);
+              const double old_temperature = temperature;
               temperature = temperature_model->get_temperature(position,
                                                                depth,
                                                                gravity_norm,
                                                                temperature,
                                                                min_depth,
                                                                max_depth);
+              model_scope.hit_if_changed(old_temperature, temperature);
 
               WBAssert(!std::isnan(temperature), "Temparture is not a number: " << temperature
                        << ", based on a temperature model with the name " << temperature_model->get_name());
@@ -138,6 +152,10 @@ namespace WorldBuilder
 
             }
         }
+      else
+        {
+          scope.early_reject();
+        }
 
       return temperature;
     }
@@ -148,21 +166,29 @@ namespace WorldBuilder
                              const unsigned int composition_number,
                              double composition) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
+      Profiler::Scope scope(world->profiler, profiler_entry, Profiler::composition);
 
-      if (depth <= max_depth && depth >= min_depth &&
-          Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
-                                                                  world->parameters.coordinate_system->natural_coordinate_system())))
+      if (depth <= max_depth && depth >= min_depth && contains_surface_point(position))
         {
-          for (auto &composition_model: composition_models)
+          scope.hit();
+
+          // The profiler counts the calls of every model, so then all
+          // models are called.
+          const std::vector<unsigned int> &active_models = world->profiler.is_enabled()
+                                                           ? composition_model_index.all()
+                                                           : composition_model_index.active(depth);
+          for (const unsigned int i_model : active_models)
             {
+              auto &composition_model = composition_models[i_model];
+              Profiler::Scope model_scope(world->profiler, composition_model.get(), Profiler::composition);
+              const double old_composition = composition;
               composition = composition_model->get_composition(position,
                                                                depth,
                                                                composition_number,
                                                                composition,
                                                                min_depth,
                                                                max_depth);
+              model_scope.hit_if_changed(old_composition, composition);
 
               WBAssert(!std::isnan(composition), "Composition is not a number: " << composition
                        << ", based on a temperature model with the name " << composition_model->get_name());
@@ -171,10 +197,102 @@ namespace WorldBuilder
 
             }
         }
+      else
+        {
+          scope.early_reject();
+        }
 
       return composition;
     }
 
+    bool
+    MantleLayer::contains_surface_point(const Point<3> &position) const
+    {
+      const WorldBuilder::Utilities::NaturalCoordinate natural_coordinate(position, *(world->parameters.coordinate_system));
+      return Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
+                                                                     world->parameters.coordinate_system->natural_coordinate_system()),
+                                               world->query_hints.get_polygon(query_hint_entry));
+    }
+
+    bool
+    MantleLayer::replaces_temperature(const Point<3> &position,
+                                      const double depth) const
+    {
+      if (!(depth <= max_depth && depth >= min_depth))
+        return false;
+
+      // The models are checked first, since that is cheaper than checking
+      // whether the point is inside the polygon.
+      bool model_replaces = false;
+      for (const unsigned int i_model : temperature_model_index.active(depth))
+        model_replaces = model_replaces || temperature_models[i_model]->replaces_temperature(depth);
+
+      return model_replaces && contains_surface_point(position);
+    }
+
+    bool
+    MantleLayer::replaces_composition(const Point<3> &position,
+                                      const double depth,
+                                      const unsigned int) const
+    {
+      if (!(depth <= max_depth && depth >= min_depth))
+        return false;
+
+      bool model_replaces = false;
+      for (const unsigned int i_model : composition_model_index.active(depth))
+        model_replaces = model_replaces || composition_models[i_model]->replaces_composition(depth);
+
+      return model_replaces && contains_surface_point(position);
+    }
+
+    std::pair<double,double>
+    MantleLayer::depth_range() const
+    {
+      return std::make_pair(min_depth, max_depth);
+    }
+
+    void
+    MantleLayer::build_model_indices()
+    {
+      std::vector<std::pair<double,double> > ranges;
+      for (auto &temperature_model: temperature_models)
+        ranges.push_back(temperature_model->depth_range());
+      temperature_model_index.build(ranges);
+
+      ranges.clear();
+      for (auto &composition_model: composition_models)
+        ranges.push_back(composition_model->depth_range());
+      composition_model_index.build(ranges);
+    }
+
+    void
+    MantleLayer::serialize(Snapshot &snapshot)
+    {
+      serialize_interface(snapshot);
+      snapshot(min_depth, max_depth, temperature_models, composition_models);
+
+      if (snapshot.is_loading())
+        {
+          add_to_profiler();
+          add_models_to_profiler(temperature_models);
+          add_models_to_profiler(composition_models);
+          build_model_indices();
+        }
+    }
+
+    void
+    MantleLayer::memory_usage(std::vector<std::pair<std::string,std::size_t> > &components) const
+    {
+      interface_memory_usage(components, sizeof(*this));
+
+      std::set<const void *> counted_models;
+      components.emplace_back(name + ": models",
+                              models_memory_usage(temperature_models, counted_models)
+                              + models_memory_usage(composition_models, counted_models)
+                              + temperature_model_index.memory_usage()
+                              + composition_model_index.memory_usage());
+    }
+
     WB_REGISTER_FEATURE(MantleLayer, mantle layer)
 
   }
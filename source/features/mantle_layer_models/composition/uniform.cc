@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -113,6 +114,34 @@ namespace WorldBuilder
             }
           return composition;
         }
+
+        bool
+        Uniform::replaces_composition(const double depth) const
+        {
+          return operation == "replace" && depth <= max_depth && depth >= min_depth;
+        }
+
+        std::pair<double,double>
+        Uniform::depth_range() const
+        {
+          return std::make_pair(min_depth, max_depth);
+        }
+
+        std::size_t
+        Uniform::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name)
+                 + WorldBuilder::Utilities::memory_usage(compositions)
+                 + WorldBuilder::Utilities::memory_usage(fractions)
+                 + WorldBuilder::Utilities::memory_usage(operation);
+        }
+
+        void
+        Uniform::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, compositions, fractions, operation);
+        }
+
         WB_REGISTER_FEATURE_MANTLE_LAYER_COMPOSITION_MODEL(Uniform, uniform)
       }
     }
@@ -17,8 +17,10 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 #include <algorithm>
+#include <limits>
 
 #include <world_builder/assert.h>
+#include <world_builder/utilities.h>
 #include <world_builder/types/string.h>
 #include <world_builder/types/object.h>
 #include <world_builder/features/mantle_layer_models/temperature/interface.h>
@@ -40,6 +42,24 @@ namespace WorldBuilder
         Interface::~Interface ()
         {}
 
+        bool
+        Interface::replaces_temperature(const double) const
+        {
+          return false;
+        }
+
+        std::pair<double,double>
+        Interface::depth_range() const
+        {
+          return std::make_pair(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        }
+
+        std::size_t
+        Interface::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
         void
         Interface::declare_entries(Parameters &prm,
                                    const std::string &parent_name,
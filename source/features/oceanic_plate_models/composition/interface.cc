@@ -19,8 +19,10 @@
 
 
 #include <algorithm>
+#include <limits>
 
 #include <world_builder/assert.h>
+#include <world_builder/utilities.h>
 #include <world_builder/types/string.h>
 #include <world_builder/types/object.h>
 #include <world_builder/features/oceanic_plate_models/composition/interface.h>
@@ -41,6 +43,24 @@ namespace WorldBuilder
         Interface::~Interface ()
         {}
 
+        bool
+        Interface::replaces_composition(const double) const
+        {
+          return false;
+        }
+
+        std::pair<double,double>
+        Interface::depth_range() const
+        {
+          return std::make_pair(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+        }
+
+        std::size_t
+        Interface::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
         void
         Interface::declare_entries(Parameters &prm,
                                    const std::string &parent_name,
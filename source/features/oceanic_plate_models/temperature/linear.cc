@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -126,6 +127,30 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        bool
+        Linear::replaces_temperature(const double depth) const
+        {
+          return operation == Utilities::Operations::REPLACE && depth <= max_depth && depth >= min_depth;
+        }
+
+        std::pair<double,double>
+        Linear::depth_range() const
+        {
+          return std::make_pair(min_depth, max_depth);
+        }
+
+        std::size_t
+        Linear::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Linear::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, top_temperature, bottom_temperature, operation);
+        }
+
         WB_REGISTER_FEATURE_OCEANIC_PLATE_TEMPERATURE_MODEL(Linear, linear)
       }
     }
@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -204,6 +205,32 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        bool
+        PlateModel::replaces_temperature(const double depth) const
+        {
+          return operation == Utilities::Operations::REPLACE && depth <= max_depth && depth >= min_depth;
+        }
+
+        std::pair<double,double>
+        PlateModel::depth_range() const
+        {
+          return std::make_pair(min_depth, max_depth);
+        }
+
+        std::size_t
+        PlateModel::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name)
+                 + WorldBuilder::Utilities::memory_usage(ridge_coordinates);
+        }
+
+        void
+        PlateModel::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, top_temperature, bottom_temperature, spreading_velocity,
+                   ridge_coordinates, operation);
+        }
+
         WB_REGISTER_FEATURE_OCEANIC_PLATE_TEMPERATURE_MODEL(PlateModel, plate model)
       }
     }
@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -129,10 +130,10 @@ namespace WorldBuilder
                                    double temperature_,
                                    const double ,
                                    const double ,
-                                   const std::map<std::string,double> &distance_from_planes) const
+                                   const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const
         {
 
-          const double distance_from_plane = distance_from_planes.at("distanceFromPlane");
+          const double distance_from_plane = distance_from_planes.distance_from_plane;
           if (distance_from_plane <= max_depth && distance_from_plane >= min_depth)
             {
               const double adabatic_temperature = potential_mantle_temperature *
@@ -158,6 +159,19 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        std::size_t
+        Adiabatic::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Adiabatic::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, potential_mantle_temperature,
+                   thermal_expansion_coefficient, specific_heat, operation);
+        }
+
         WB_REGISTER_FEATURE_SUBDUCTING_PLATE_TEMPERATURE_MODEL(Adiabatic, adiabatic)
       }
     }
@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -93,9 +94,9 @@ namespace WorldBuilder
                                 double temperature_,
                                 const double,
                                 const double,
-                                const std::map<std::string,double> &distance_from_plane) const
+                                const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_plane) const
         {
-          if (distance_from_plane.at("distanceFromPlane") <= max_depth && distance_from_plane.at("distanceFromPlane") >= min_depth)
+          if (distance_from_plane.distance_from_plane <= max_depth && distance_from_plane.distance_from_plane >= min_depth)
             {
               const double min_depth_local = min_depth;
               const double max_depth_local = max_depth;
@@ -118,7 +119,7 @@ namespace WorldBuilder
                 }
 
               const double new_temperature = top_temperature +
-                                             (distance_from_plane.at("distanceFromPlane") - min_depth_local) *
+                                             (distance_from_plane.distance_from_plane - min_depth_local) *
                                              ((bottom_temperature_local - top_temperature_local) / (max_depth_local - min_depth_local));
               return Utilities::apply_operation(operation,temperature_,new_temperature);
 
@@ -127,6 +128,18 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        std::size_t
+        Linear::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        Linear::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, top_temperature, bottom_temperature, operation);
+        }
+
         WB_REGISTER_FEATURE_SUBDUCTING_PLATE_TEMPERATURE_MODEL(Linear, linear)
       }
     }
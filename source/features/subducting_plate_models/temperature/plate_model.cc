@@ -17,6 +17,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <world_builder/snapshot.h>
 #include <world_builder/utilities.h>
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
@@ -146,12 +147,12 @@ namespace WorldBuilder
                                     double temperature_,
                                     const double,
                                     const double,
-                                    const std::map<std::string,double> &distance_from_planes) const
+                                    const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const
         {
-          const double thickness_local = std::min(distance_from_planes.at("thicknessLocal"), max_depth);
-          const double distance_from_plane = distance_from_planes.at("distanceFromPlane");
-          const double distance_along_plane = distance_from_planes.at("distanceAlongPlane");
-          const double average_angle = distance_from_planes.at("averageAngle");
+          const double thickness_local = std::min(distance_from_planes.local_thickness, max_depth);
+          const double distance_from_plane = distance_from_planes.distance_from_plane;
+          const double distance_along_plane = distance_from_planes.distance_along_plane;
+          const double average_angle = distance_from_planes.average_angle;
 
           if (distance_from_plane <= max_depth && distance_from_plane >= min_depth)
             {
@@ -238,6 +239,20 @@ namespace WorldBuilder
           return temperature_;
         }
 
+        std::size_t
+        PlateModel::memory_usage() const
+        {
+          return sizeof(*this) + WorldBuilder::Utilities::memory_usage(name);
+        }
+
+        void
+        PlateModel::serialize(Snapshot &snapshot)
+        {
+          snapshot(min_depth, max_depth, density, plate_velocity, thermal_conductivity,
+                   thermal_expansion_coefficient, specific_heat, potential_mantle_temperature,
+                   surface_temperature, adiabatic_heating, operation);
+        }
+
         WB_REGISTER_FEATURE_SUBDUCTING_PLATE_TEMPERATURE_MODEL(PlateModel, plate model)
       }
     }
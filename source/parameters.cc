@@ -16,7 +16,11 @@
    You should have received a copy of the GNU Lesser General Public License
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
+#include <algorithm>
 #include <fstream>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 #include <tuple>
@@ -32,6 +36,7 @@
 #include <world_builder/config.h>
 #include <world_builder/parameters.h>
 #include <world_builder/utilities.h>
+#include <world_builder/world.h>
 
 #include <world_builder/types/object.h>
 #include <world_builder/types/point.h>
@@ -62,6 +67,101 @@ using namespace rapidjson;
 
 namespace WorldBuilder
 {
+  namespace
+  {
+    /**
+     * A schema compiled from the declarations, together with the copy of the
+     * declarations it was compiled from and their canonical text.
+     */
+    struct CompiledSchema
+    {
+      CompiledSchema(const Document &declarations_, const std::string &declarations_text_)
+        :
+        declarations_text(declarations_text_)
+      {
+        declarations.CopyFrom(declarations_, declarations.GetAllocator());
+        schema.reset(new SchemaDocument(declarations));
+      }
+
+      const std::string declarations_text;
+      Document declarations;
+      std::unique_ptr<SchemaDocument> schema;
+    };
+
+    /**
+     * The declarations only depend on the registered plugins, so the schema
+     * is compiled once and shared by all worlds in the process. The canonical
+     * texts of the last world builder files which have been validated
+     * successfully against it are also stored, so that loading the same file
+     * again does not need to validate it again.
+     */
+    std::mutex schema_cache_mutex;
+    std::shared_ptr<const CompiledSchema> cached_schema;
+    std::deque<std::string> validated_files;
+
+    /**
+     * The maximum number of validated files which are remembered. When more
+     * files are validated, the oldest one is forgotten.
+     */
+    const size_t max_validated_files = 16;
+
+    /**
+     * Writes a json value to the writer with the members of every object
+     * sorted by name. Members with the same name are all kept, in their
+     * original order.
+     */
+    template<class Writer>
+    void
+    write_canonical(const Value &value, Writer &writer)
+    {
+      if (value.IsObject())
+        {
+          std::vector<Value::ConstMemberIterator> members;
+          for (Value::ConstMemberIterator member = value.MemberBegin(); member != value.MemberEnd(); ++member)
+            members.push_back(member);
+          std::stable_sort(members.begin(), members.end(),
+                           [](const Value::ConstMemberIterator &a, const Value::ConstMemberIterator &b)
+          {
+            return std::string(a->name.GetString(), a->name.GetStringLength())
+                   < std::string(b->name.GetString(), b->name.GetStringLength());
+          });
+
+          writer.StartObject();
+          for (auto &member : members)
+            {
+              writer.Key(member->name.GetString(), member->name.GetStringLength());
+              write_canonical(member->value, writer);
+            }
+          writer.EndObject();
+        }
+      else if (value.IsArray())
+        {
+          writer.StartArray();
+          for (auto &element : value.GetArray())
+            write_canonical(element, writer);
+          writer.EndArray();
+        }
+      else
+        {
+          value.Accept(writer);
+        }
+    }
+
+    /**
+     * Returns the text of a json value, which does not depend on the order
+     * of the members of objects or on the formatting of the file it was read
+     * from. Two values have the same text only if they have the same content.
+     */
+    std::string
+    canonical_text(const Value &value)
+    {
+      StringBuffer buffer;
+      Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> writer(buffer);
+      write_canonical(value, writer);
+      return std::string(buffer.GetString(), buffer.GetSize());
+    }
+  }
+
   Parameters::Parameters(World &world_)
     :
     world(world_)
@@ -73,30 +173,10 @@ namespace WorldBuilder
 
   void Parameters::initialize(std::string &filename, bool has_output_dir, std::string output_dir)
   {
+    Trace::Scope scope(world.trace, "Parameters::initialize", "parameters");
 
     if (has_output_dir == true)
-      {
-        StringBuffer buffer;
-        std::ofstream file;
-        // write out declarations
-        file.open (output_dir + "world_buider_declarations.tex");
-
-        WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.tex' for string the tex declarations.");
-
-        LatexWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> tex_writer(buffer);
-        declarations.Accept(tex_writer);
-        file << buffer.GetString();
-        file.close();
-
-        // write out json schema
-        buffer.Clear();
-        file.open (output_dir + "world_buider_declarations.schema.json");
-        WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.schema.json' for string the json declarations.");
-        PrettyWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> json_writer(buffer);
-        declarations.Accept(json_writer);
-        file << buffer.GetString();
-        file.close();
-      }
+      write_declarations(output_dir);
 
     path_level =0;
     // Now read in the world builder file into a file stream and
@@ -111,6 +191,8 @@ namespace WorldBuilder
 
     rapidjson::IStreamWrapper isw(json_input_stream);
 
+    Trace::Scope parse_scope(world.trace, "parse world builder file", "parameters");
+
     // relaxing sytax by allowing comments () for now, maybe also allow trailing commas and (kParseTrailingCommasFlag) and nan's, inf etc (kParseNanAndInfFlag)?
     //WBAssertThrow(!parameters.ParseStream<kParseCommentsFlag>(isw).HasParseError(), "Parsing erros world builder file");
 
@@ -139,12 +221,37 @@ namespace WorldBuilder
                                                                             ));
 
     WBAssertThrow(parameters.IsObject(), "World builder file is is not an object.");
+    clear_lookup_caches();
     json_input_stream.close();
+    parse_scope.end();
+
+    Trace::Scope schema_scope(world.trace, "create schema", "parameters");
+    const std::string declarations_text = canonical_text(declarations);
+    std::shared_ptr<const CompiledSchema> schema;
+    {
+      std::lock_guard<std::mutex> lock(schema_cache_mutex);
+      if (cached_schema == nullptr || cached_schema->declarations_text != declarations_text)
+        {
+          cached_schema = std::make_shared<const CompiledSchema>(declarations, declarations_text);
+          validated_files.clear();
+        }
+      schema = cached_schema;
+    }
+    schema_scope.end();
+
+    Trace::Scope validate_scope(world.trace, "validate world builder file", "parameters");
+    std::string parameters_text = canonical_text(parameters);
+    {
+      std::lock_guard<std::mutex> lock(schema_cache_mutex);
+      if (schema == cached_schema
+          && std::find(validated_files.begin(), validated_files.end(), parameters_text) != validated_files.end())
+        {
+          validate_scope.add_argument("cached", "true");
+          return;
+        }
+    }
 
-
-    SchemaDocument schema(declarations);
-    SchemaValidator validator(schema);
-
+    SchemaValidator validator(*schema->schema);
     if (!parameters.Accept(validator))
       {
         // Input JSON is invalid according to the schema
@@ -161,6 +268,60 @@ namespace WorldBuilder
         validator.GetError().Accept(writer);
         WBAssertThrow(false, string.str() << "Error document: " << std::endl << buffer.GetString());
       }
+
+    std::lock_guard<std::mutex> lock(schema_cache_mutex);
+    if (schema == cached_schema)
+      {
+        if (validated_files.size() >= max_validated_files)
+          validated_files.pop_front();
+        validated_files.push_back(std::move(parameters_text));
+      }
+  }
+
+  void
+  Parameters::write_declarations(const std::string &output_dir) const
+  {
+    Trace::Scope export_scope(world.trace, "write declarations", "parameters");
+    StringBuffer buffer;
+    std::ofstream file;
+    // write out declarations
+    file.open (output_dir + "world_buider_declarations.tex");
+
+    WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.tex' for string the tex declarations.");
+
+    LatexWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> tex_writer(buffer);
+    declarations.Accept(tex_writer);
+    file << buffer.GetString();
+    file.close();
+
+    // write out json schema
+    buffer.Clear();
+    file.open (output_dir + "world_buider_declarations.schema.json");
+    WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.schema.json' for string the json declarations.");
+    PrettyWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> json_writer(buffer);
+    declarations.Accept(json_writer);
+    file << buffer.GetString();
+    file.close();
+  }
+
+  void
+  Parameters::release_parse_data()
+  {
+    Trace::Scope scope(world.trace, "Parameters::release_parse_data", "parameters");
+
+    // Swapping with empty documents releases the memory pools of the
+    // documents, instead of only clearing their values.
+    rapidjson::Document().Swap(declarations);
+    rapidjson::Document().Swap(parameters);
+    std::vector<std::string>().swap(path);
+    std::string().swap(full_json_path);
+    path_level = 0;
+    std::unordered_map<std::string, const rapidjson::Value *>().swap(parameter_value_cache);
+    std::unordered_map<std::string, const rapidjson::Value *>().swap(declaration_value_cache);
+    std::unordered_map<std::string, std::string>().swap(schema_path_cache);
+
+    for (auto &feature : features)
+      feature->release_parse_data();
   }
 
   void
@@ -174,7 +335,7 @@ namespace WorldBuilder
   bool
   Parameters::check_entry(const std::string &name) const
   {
-    return Pointer((this->get_full_json_path() + "/" + name).c_str()).Get(parameters) == NULL ? false : true;
+    return get_parameter_value(this->get_full_json_path() + "/" + name) == NULL ? false : true;
   }
 
 
@@ -183,13 +344,13 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name);
 
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(base + "/required") != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -203,7 +364,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << base + "/" + name + "/default value");
@@ -217,12 +378,12 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name);
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(base + "/required") != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -236,7 +397,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << get_full_json_schema_path() + "/" + name + "/default value, for value: " << base + "/" + name);
@@ -259,13 +420,13 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name);
 
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(base + "/required") != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -279,7 +440,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << base + "/" + name + "/default value");
@@ -293,13 +454,13 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name);
 
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(base + "/required") != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -313,7 +474,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << base + "/" + name + "/default value");
@@ -327,13 +488,13 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name);
 
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(base + "/required") != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -347,7 +508,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << base + "/" + name + "/default value");
@@ -363,13 +524,13 @@ namespace WorldBuilder
   {
 
     const std::string strict_base = this->get_full_json_path();
-    const Value *array = Pointer((strict_base + "/" + name).c_str()).Get(parameters);
+    const Value *array = get_parameter_value(strict_base + "/" + name);
 
 #ifdef debug
     bool required = false;
-    if (Pointer((strict_base + "/required").c_str()).Get(declarations) != NULL)
+    if (get_declaration_value(strict_base + "/required") != NULL)
       {
-        for (auto &v : Pointer((strict_base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : get_declaration_value(strict_base + "/required")->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -390,8 +551,8 @@ namespace WorldBuilder
 
         try
           {
-            value1 = Pointer((base + "/0").c_str()).Get(parameters)->GetDouble();
-            value2 = Pointer((base + "/1").c_str()).Get(parameters)->GetDouble();
+            value1 = get_parameter_value(base + "/0")->GetDouble();
+            value2 = get_parameter_value(base + "/1")->GetDouble();
           }
         catch (...)
           {
@@ -410,9 +571,9 @@ namespace WorldBuilder
   {
     std::vector<Point<2> > vector;
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
@@ -423,8 +584,8 @@ namespace WorldBuilder
 
             try
               {
-                value1 = Pointer((base + "/0").c_str()).Get(parameters)->GetDouble();
-                value2 = Pointer((base + "/1").c_str()).Get(parameters)->GetDouble();
+                value1 = get_parameter_value(base + "/0")->GetDouble();
+                value2 = get_parameter_value(base + "/1")->GetDouble();
               }
             catch (...)
               {
@@ -442,14 +603,14 @@ namespace WorldBuilder
   {
     std::vector<std::array<std::array<double,3>,3>  > vector;
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array1 = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array1 = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array1->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-            Value *array2 = Pointer((base).c_str()).Get(parameters);
+            const Value *array2 = get_parameter_value(base);
 
             // Not sure why cppcheck it is generating the warning
             // Filed a question at: https://sourceforge.net/p/cppcheck/discussion/general/thread/429759f85e/
@@ -461,16 +622,16 @@ namespace WorldBuilder
               {
                 const std::string base_extended = base + "/" + std::to_string(j);
 
-                WBAssertThrow(Pointer((base_extended).c_str()).Get(parameters)->Size() == 3,
+                WBAssertThrow(get_parameter_value(base_extended)->Size() == 3,
                               "Array " << i << " is supposed to be a 3x3 array, but the inner array dimensions of "
-                              << j << " is " << Pointer((base_extended).c_str()).Get(parameters)->Size() << ".");
+                              << j << " is " << get_parameter_value(base_extended)->Size() << ".");
                 double value1, value2, value3;
 
                 try
                   {
-                    value1 = Pointer((base_extended + "/0").c_str()).Get(parameters)->GetDouble();
-                    value2 = Pointer((base_extended + "/1").c_str()).Get(parameters)->GetDouble();
-                    value3 = Pointer((base_extended + "/2").c_str()).Get(parameters)->GetDouble();
+                    value1 = get_parameter_value(base_extended + "/0")->GetDouble();
+                    value2 = get_parameter_value(base_extended + "/1")->GetDouble();
+                    value3 = get_parameter_value(base_extended + "/2")->GetDouble();
                   }
                 catch (...)
                   {
@@ -497,10 +658,10 @@ namespace WorldBuilder
     std::vector<Objects::Segment<Temperature::Interface,Composition::Interface> > vector;
     this->enter_subsection(name);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base) != NULL)
       {
         // get the array of segments
-        Value *array = Pointer((strict_base).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
@@ -508,60 +669,60 @@ namespace WorldBuilder
             const std::string base = this->get_full_json_path();
             // get one segment
             // length
-            double length = Pointer((base + "/length").c_str()).Get(parameters)->GetDouble();
+            double length = get_parameter_value(base + "/length")->GetDouble();
 
             // get thickness
-            Value *point_array = Pointer((base  + "/thickness").c_str()).Get(parameters);
+            const Value *point_array = get_parameter_value(base  + "/thickness");
             Point<2> thickness(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/thickness/0")->GetDouble();
                     thickness = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/thickness/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/thickness/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/thickness/1")->GetDouble();
                     thickness = Point<2>(local0,local1,invalid);
                   }
               }
 
             // get top trunctation (default is 0,0)
-            point_array = Pointer((base  + "/top truncation").c_str()).Get(parameters);
+            point_array = get_parameter_value(base  + "/top truncation");
             Point<2> top_trunctation(invalid);
             if (point_array != NULL)
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/top truncation/0")->GetDouble();
                     top_trunctation = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/top truncation/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/top truncation/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/top truncation/1")->GetDouble();
                     top_trunctation = Point<2>(local0,local1,invalid);
                   }
               }
             // get thickness
-            point_array = Pointer((base  + "/angle").c_str()).Get(parameters);
+            point_array = get_parameter_value(base  + "/angle");
             Point<2> angle(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/angle/0")->GetDouble();
                     angle = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/angle/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/angle/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/angle/1")->GetDouble();
                     angle = Point<2>(local0,local1,invalid);
                   }
               }
@@ -572,14 +733,14 @@ namespace WorldBuilder
             //This is a value to look back in the path elements.
             size_t searchback = 0;
             if (this->get_shared_pointers<Temperature::Interface>("temperature models", temperature_models) == false ||
-                Pointer((base + "/temperature model default entry").c_str()).Get(parameters) != NULL)
+                get_parameter_value(base + "/temperature model default entry") != NULL)
               {
                 temperature_models = default_temperature_models;
 
                 // find the default value, which is the closest to the current path
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters) != NULL)
+                    if (get_parameter_value(this->get_full_json_path(path.size()-searchback) + "/temperature models") != NULL)
                       {
                         break;
                       }
@@ -601,13 +762,15 @@ namespace WorldBuilder
 
                     Pointer((base).c_str()).Get(parameters)->AddMember("temperature models", value2, parameters.GetAllocator());
                     Pointer((base + "/temperature model default entry").c_str()).Set(parameters,true);
+                    // adding members may have moved values of the parameters
+                    parameter_value_cache.clear();
                   }
               }
 
             // now do the same for compositions
             std::vector<std::shared_ptr<Composition::Interface> > composition_models;
             if (this->get_shared_pointers<Composition::Interface>("composition models", composition_models) == false ||
-                Pointer((base + "/composition model default entry").c_str()).Get(parameters) != NULL)
+                get_parameter_value(base + "/composition model default entry") != NULL)
               {
                 composition_models = default_composition_models;
 
@@ -615,7 +778,7 @@ namespace WorldBuilder
                 // find the default value, which is the closest to the current path
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters) != NULL)
+                    if (get_parameter_value(this->get_full_json_path(path.size()-searchback) + "/composition models") != NULL)
                       {
                         break;
                       }
@@ -637,6 +800,8 @@ namespace WorldBuilder
 
                     Pointer((base).c_str()).Get(parameters)->AddMember("composition models", value2, parameters.GetAllocator());
                     Pointer((base + "/composition model default entry").c_str()).Set(parameters,true);
+                    // adding members may have moved values of the parameters
+                    parameter_value_cache.clear();
                   }
               }
             vector.push_back(Objects::Segment<Temperature::Interface,Composition::Interface>(length, thickness, top_trunctation, angle, temperature_models, composition_models));
@@ -659,10 +824,10 @@ namespace WorldBuilder
     std::vector<Objects::Segment<Temperature::Interface,Composition::Interface> > vector;
     this->enter_subsection(name);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base) != NULL)
       {
         // get the array of segments
-        Value *array = Pointer((strict_base).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
@@ -670,60 +835,60 @@ namespace WorldBuilder
             const std::string base = this->get_full_json_path();
             // get one segment
             // length
-            double length = Pointer((base + "/length").c_str()).Get(parameters)->GetDouble();
+            double length = get_parameter_value(base + "/length")->GetDouble();
 
             // get thickness
-            Value *point_array = Pointer((base  + "/thickness").c_str()).Get(parameters);
+            const Value *point_array = get_parameter_value(base  + "/thickness");
             Point<2> thickness(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/thickness/0")->GetDouble();
                     thickness = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/thickness/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/thickness/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/thickness/1")->GetDouble();
                     thickness = Point<2>(local0,local1,invalid);
                   }
               }
 
             // get top trunctation (default is 0,0)
-            point_array = Pointer((base  + "/top truncation").c_str()).Get(parameters);
+            point_array = get_parameter_value(base  + "/top truncation");
             Point<2> top_trunctation(invalid);
             if (point_array != NULL)
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/top truncation/0")->GetDouble();
                     top_trunctation = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/top truncation/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/top truncation/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/top truncation/1")->GetDouble();
                     top_trunctation = Point<2>(local0,local1,invalid);
                   }
               }
             // get thickness
-            point_array = Pointer((base  + "/angle").c_str()).Get(parameters);
+            point_array = get_parameter_value(base  + "/angle");
             Point<2> angle(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/angle/0")->GetDouble();
                     angle = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/angle/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = get_parameter_value(base + "/angle/0")->GetDouble();
+                    double local1 = get_parameter_value(base + "/angle/1")->GetDouble();
                     angle = Point<2>(local0,local1,invalid);
                   }
               }
@@ -734,14 +899,14 @@ namespace WorldBuilder
             //This is a value to look back in the path elements.
             size_t searchback = 0;
             if (this->get_shared_pointers<Temperature::Interface>("temperature models", temperature_models) == false ||
-                Pointer((base + "/temperature model default entry").c_str()).Get(parameters) != NULL)
+                get_parameter_value(base + "/temperature model default entry") != NULL)
               {
                 temperature_models = default_temperature_models;
 
                 // find the default value, which is the closest to the current path
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters) != NULL)
+                    if (get_parameter_value(this->get_full_json_path(path.size()-searchback) + "/temperature models") != NULL)
                       {
                         break;
                       }
@@ -763,13 +928,15 @@ namespace WorldBuilder
 
                     Pointer((base).c_str()).Get(parameters)->AddMember("temperature models", value2, parameters.GetAllocator());
                     Pointer((base + "/temperature model default entry").c_str()).Set(parameters,true);
+                    // adding members may have moved values of the parameters
+                    parameter_value_cache.clear();
                   }
               }
 
             // now do the same for compositions
             std::vector<std::shared_ptr<Composition::Interface> > composition_models;
             if (this->get_shared_pointers<Composition::Interface>("composition models", composition_models) == false ||
-                Pointer((base + "/composition model default entry").c_str()).Get(parameters) != NULL)
+                get_parameter_value(base + "/composition model default entry") != NULL)
               {
                 composition_models = default_composition_models;
 
@@ -777,7 +944,7 @@ namespace WorldBuilder
                 // find the default value, which is the closest to the current path
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters) != NULL)
+                    if (get_parameter_value(this->get_full_json_path(path.size()-searchback) + "/composition models") != NULL)
                       {
                         break;
                       }
@@ -799,6 +966,8 @@ namespace WorldBuilder
 
                     Pointer((base).c_str()).Get(parameters)->AddMember("composition models", value2, parameters.GetAllocator());
                     Pointer((base + "/composition model default entry").c_str()).Set(parameters,true);
+                    // adding members may have moved values of the parameters
+                    parameter_value_cache.clear();
                   }
               }
             vector.push_back(Objects::Segment<Temperature::Interface,Composition::Interface>(length, thickness, top_trunctation, angle, temperature_models, composition_models));
@@ -816,27 +985,27 @@ namespace WorldBuilder
   {
     std::vector<double> vector;
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
 
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetDouble());
+            vector.push_back(get_parameter_value(base)->GetDouble());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems");
 
         size_t min_size = value->GetUint();
 
-        value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations);
+        value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/items/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/default value");
@@ -858,27 +1027,27 @@ namespace WorldBuilder
   {
     std::vector<size_t> vector;
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
 
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetUint());
+            vector.push_back(get_parameter_value(base)->GetUint());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems");
 
         size_t min_size = value->GetUint();
 
-        value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations);
+        value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/items/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/default value");
@@ -900,27 +1069,27 @@ namespace WorldBuilder
   {
     std::vector<unsigned int> vector;
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
 
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetUint());
+            vector.push_back(get_parameter_value(base)->GetUint());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems value");
 
         size_t min_size = value->GetUint();
 
-        unsigned int default_value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations)->GetUint();
+        unsigned int default_value = get_declaration_value(this->get_full_json_schema_path()  + "/" + name + "/items/default value")->GetUint();
 
         // set to min size
         for (size_t i = 0; i < min_size; ++i)
@@ -936,12 +1105,12 @@ namespace WorldBuilder
   Parameters::get_unique_pointer(const std::string &name)
   {
     const std::string base = this->get_full_json_path();
-    Value *value = Pointer((base + "/" + name + "/model").c_str()).Get(parameters);
+    const Value *value = get_parameter_value(base + "/" + name + "/model");
 
 #ifdef debug
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
-      for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+    if (get_declaration_value(base + "/required") != NULL)
+      for (auto &v : get_declaration_value(base + "/required")->GetArray())
         {
           if (v.GetString() == name)
             {
@@ -954,7 +1123,7 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration_value(get_full_json_schema_path() + "/" + name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << base + "/" + name + "/default value. Make sure the value has been declared.");
@@ -969,15 +1138,15 @@ namespace WorldBuilder
   {
     vector.resize(0);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
 
-            std::string value = Pointer((base + "/model").c_str()).Get(parameters)->GetString();
+            std::string value = get_parameter_value(base + "/model")->GetString();
 
             vector.push_back(std::move(T::create(value, &world)));
           }
@@ -996,9 +1165,9 @@ namespace WorldBuilder
   {
     vector.resize(0);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
@@ -1019,9 +1188,9 @@ namespace WorldBuilder
   {
     vector.resize(0);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
@@ -1044,15 +1213,15 @@ namespace WorldBuilder
   {
     //vector.resize(0);
     const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    if (get_parameter_value(strict_base + "/" + name) != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
+        const Value *array = get_parameter_value(strict_base  + "/" + name);
 
         for (size_t i = 0; i < array->Size(); ++i )
           {
             const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
 
-            std::string value = Pointer((base + "/model").c_str()).Get(parameters)->GetString();
+            std::string value = get_parameter_value(base + "/model")->GetString();
 
             vector.push_back(std::move(T::create(value, &world)));
           }
@@ -1069,15 +1238,72 @@ namespace WorldBuilder
   Parameters::enter_subsection(const std::string name)
   {
     path.push_back(name);
+    full_json_path += "/" + name;
     //TODO: WBAssert(is path valid?)
   }
 
   void
   Parameters::leave_subsection()
   {
+    full_json_path.resize(full_json_path.size() - path.back().size() - 1);
     path.pop_back();
   }
 
+  const Value *
+  Parameters::get_parameter_value(const std::string &json_pointer) const
+  {
+    auto cached_value = parameter_value_cache.find(json_pointer);
+    if (cached_value != parameter_value_cache.end())
+      return cached_value->second;
+
+    const Value *value = Pointer(json_pointer.c_str()).Get(parameters);
+    parameter_value_cache.emplace(json_pointer, value);
+    return value;
+  }
+
+  const Value *
+  Parameters::get_declaration_value(const std::string &json_pointer) const
+  {
+    auto cached_value = declaration_value_cache.find(json_pointer);
+    if (cached_value != declaration_value_cache.end())
+      return cached_value->second;
+
+    const Value *value = Pointer(json_pointer.c_str()).Get(declarations);
+    declaration_value_cache.emplace(json_pointer, value);
+    return value;
+  }
+
+  void
+  Parameters::clear_lookup_caches()
+  {
+    parameter_value_cache.clear();
+    declaration_value_cache.clear();
+    schema_path_cache.clear();
+  }
+
+  std::size_t
+  Parameters::lookup_cache_memory_usage() const
+  {
+    // Every element of an unordered map is a node with the element, a
+    // pointer to the next node and the hash, and every bucket is a pointer.
+    // A map with a single bucket stores it inside the map.
+    std::size_t bytes = 0;
+    for (auto &entry : parameter_value_cache)
+      bytes += sizeof(entry) + 2 * sizeof(void *) + Utilities::memory_usage(entry.first);
+    for (auto &entry : declaration_value_cache)
+      bytes += sizeof(entry) + 2 * sizeof(void *) + Utilities::memory_usage(entry.first);
+    for (auto &entry : schema_path_cache)
+      bytes += sizeof(entry) + 2 * sizeof(void *)
+               + Utilities::memory_usage(entry.first) + Utilities::memory_usage(entry.second);
+    for (std::size_t bucket_count :
+         {
+           parameter_value_cache.bucket_count(), declaration_value_cache.bucket_count(), schema_path_cache.bucket_count()
+         })
+      if (bucket_count > 1)
+        bytes += bucket_count * sizeof(void *);
+    return bytes;
+  }
+
 
 
   void
@@ -1130,6 +1356,9 @@ namespace WorldBuilder
   std::string
   Parameters::get_full_json_path(size_t max_size) const
   {
+    if (max_size >= path.size())
+      return full_json_path;
+
     std::string collapse = "";
     for (size_t i = 0; i < path.size() && i < max_size; i++)
       {
@@ -1141,43 +1370,60 @@ namespace WorldBuilder
   std::string
   Parameters::get_full_json_schema_path() const
   {
+    // Start from the longest beginning of the path for which the schema path
+    // has already been determined. Only the beginnings at which the loop
+    // below starts an iteration are cached, since the loop may take two
+    // elements of the path at once.
+    size_t i = path.size();
     std::string collapse = "/properties";
-    for (size_t i = 0; i < path.size(); i++)
+    for (; i > 0; --i)
       {
+        auto cached_path = schema_path_cache.find(get_full_json_path(i));
+        if (cached_path != schema_path_cache.end())
+          {
+            collapse = cached_path->second;
+            break;
+          }
+      }
+
+    for (; i < path.size(); i++)
+      {
+        schema_path_cache.emplace(get_full_json_path(i), collapse);
+
         // first get the type
-        //WBAssert(Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(declarations) != NULL, "Internal error: could not find " << collapse + "/" + path[i] + "/type");
+        //WBAssert(get_declaration_value(collapse + "/" + path[i] + "/type") != NULL, "Internal error: could not find " << collapse + "/" + path[i] + "/type");
 
-        std::string base_path = Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(declarations) != NULL
+        std::string base_path = get_declaration_value(collapse + "/" + path[i] + "/type") != NULL
                                 ?
                                 collapse + "/" + path[i]
                                 :
                                 collapse;
-        std::string type = Pointer((base_path + "/type").c_str()).Get(declarations)->GetString();
+        std::string type = get_declaration_value(base_path + "/type")->GetString();
 
         if (type == "array")
           {
             // the type is an array. Arrays always have an items, but can also
             // have a oneOf (todo: or anyOf ...). Find out whether this is the case
             //collapse += path[i] + "/items";
-            if (Pointer((base_path + "/items/oneOf").c_str()).Get(declarations) != NULL)
+            if (get_declaration_value(base_path + "/items/oneOf") != NULL)
               {
                 // it has a structure with oneOf. Find out which of the entries is needed.
                 // This means we have to take a sneak peak to figure out how to get to the
                 // next value.
-                size_t size = Pointer((base_path + "/items/oneOf").c_str()).Get(declarations)->Size();
+                size_t size = get_declaration_value(base_path + "/items/oneOf")->Size();
 #ifdef debug
                 bool found = false;
 #endif
                 size_t index = 0;
                 for (; index < size; ++index)
                   {
-                    std::string declarations_string = Pointer((base_path + "/items/oneOf/" + std::to_string(index)
-                                                               + "/properties/model/enum/0").c_str()).Get(declarations)->GetString();
+                    std::string declarations_string = get_declaration_value(base_path + "/items/oneOf/" + std::to_string(index)
+                                                               + "/properties/model/enum/0")->GetString();
 
                     // we need to get the json path relevant for the current declaration string
                     // we are interested in, which requires an offset of 2.
-                    WBAssert(Pointer((get_full_json_path(i+2) + "/model").c_str()).Get(parameters) != NULL, "Could not find model in: " << get_full_json_path(i+2) + "/model");
-                    std::string parameters_string = Pointer((get_full_json_path(i+2) + "/model").c_str()).Get(parameters)->GetString();
+                    WBAssert(get_parameter_value(get_full_json_path(i+2) + "/model") != NULL, "Could not find model in: " << get_full_json_path(i+2) + "/model");
+                    std::string parameters_string = get_parameter_value(get_full_json_path(i+2) + "/model")->GetString();
 
                     // currently in our case these are always objects, so go directly to find the option we need.
                     if (declarations_string == parameters_string)
@@ -1212,6 +1458,7 @@ namespace WorldBuilder
             collapse += "/" + path[i];
           }
       }
+    schema_path_cache.emplace(full_json_path, collapse);
     return collapse;
   }
 
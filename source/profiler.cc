@@ -0,0 +1,141 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iomanip>
+#include <sstream>
+
+#include <world_builder/assert.h>
+#include <world_builder/profiler.h>
+
+namespace WorldBuilder
+{
+  Profiler::Counters::Counters()
+    :
+    calls(0),
+    early_rejects(0),
+    hits(0),
+    time(0)
+  {}
+
+  void
+  Profiler::Counters::merge(const Counters &other)
+  {
+    calls += other.calls;
+    early_rejects += other.early_rejects;
+    hits += other.hits;
+    time += other.time;
+  }
+
+  Profiler::Profiler()
+    :
+    enabled(false)
+  {}
+
+  Profiler::~Profiler()
+  {}
+
+  void
+  Profiler::set_enabled(const bool enabled_)
+  {
+    enabled.store(enabled_, std::memory_order_relaxed);
+  }
+
+  unsigned int
+  Profiler::add_feature(const std::string &name)
+  {
+    WBAssertThrow(thread_counters.n_slots() == 0, "Features can not be added to the profiler after counters have been collected.");
+    entries.emplace_back(name, "");
+    return static_cast<unsigned int>(entries.size() - 1);
+  }
+
+  void
+  Profiler::add_model(const unsigned int feature, const void *model, const std::string &name)
+  {
+    WBAssertThrow(thread_counters.n_slots() == 0, "Models can not be added to the profiler after counters have been collected.");
+    WBAssert(feature < entries.size(), "Internal error: feature entry " << feature << " does not exist.");
+    if (model_entries.find(model) != model_entries.end())
+      return;
+
+    entries.emplace_back(entries[feature].first, name);
+    model_entries[model] = static_cast<unsigned int>(entries.size() - 1);
+  }
+
+  unsigned int
+  Profiler::get_model_entry(const void *model) const
+  {
+    auto it = model_entries.find(model);
+    WBAssertThrow(it != model_entries.end(), "Internal error: the model was not registered in the profiler.");
+    return it->second;
+  }
+
+  void
+  Profiler::reset()
+  {
+    thread_counters.for_each([](std::vector<Counters> &counters)
+    {
+      for (auto &counter : counters)
+        counter = Counters();
+    });
+  }
+
+  Profiler::Counters &
+  Profiler::get_thread_counters(const unsigned int entry, const Quantity quantity) const
+  {
+    std::vector<Counters> &counters = thread_counters.get(2 * entries.size());
+    WBAssert(2 * entry + quantity < counters.size(), "Internal error: profiler entry " << entry << " does not exist.");
+    return counters[2 * entry + quantity];
+  }
+
+  Profiler::Counters
+  Profiler::get_counters(const unsigned int entry, const Quantity quantity) const
+  {
+    WBAssertThrow(entry < entries.size(), "The profiler entry " << entry << " does not exist.");
+    Counters counters;
+    thread_counters.for_each([&](const std::vector<Counters> &thread_counter)
+    {
+      counters.merge(thread_counter[2 * entry + quantity]);
+    });
+    return counters;
+  }
+
+  std::string
+  Profiler::report() const
+  {
+    std::stringstream report;
+    report << std::left << std::setw(40) << "feature" << std::setw(30) << "model" << std::setw(13) << "quantity"
+           << std::right << std::setw(14) << "calls" << std::setw(14) << "early rejects" << std::setw(14) << "hits"
+           << std::setw(14) << "time (s)" << std::endl;
+
+    const char *quantity_names[] = {"temperature", "composition"};
+    for (unsigned int entry = 0; entry < entries.size(); ++entry)
+      for (unsigned int quantity = 0; quantity < 2; ++quantity)
+        {
+          const Counters counters = get_counters(entry, static_cast<Quantity>(quantity));
+          if (counters.calls == 0)
+            continue;
+
+          report << std::left << std::setw(40) << entries[entry].first << std::setw(30) << entries[entry].second
+                 << std::setw(13) << quantity_names[quantity] << std::right << std::setw(14) << counters.calls
+                 << std::setw(14) << counters.early_rejects << std::setw(14) << counters.hits
+                 << std::setw(14) << std::setprecision(6) << counters.time << std::endl;
+        }
+
+    return report.str();
+  }
+}
@@ -0,0 +1,120 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iomanip>
+#include <sstream>
+
+#include <world_builder/assert.h>
+#include <world_builder/query_hints.h>
+
+namespace WorldBuilder
+{
+  QueryHints::PolygonHint::PolygonHint()
+    :
+    valid(false),
+    point(),
+    safe_distance(0),
+    inside(false),
+    lookups(0),
+    hits(0)
+  {}
+
+  QueryHints::SectionHint::SectionHint()
+    :
+    valid(false),
+    point(),
+    safe_distance(0),
+    candidate_sections(nullptr),
+    lookups(0),
+    hits(0)
+  {}
+
+  QueryHints::QueryHints()
+    :
+    enabled(false)
+  {}
+
+  void
+  QueryHints::set_enabled(const bool enabled_)
+  {
+    enabled = enabled_;
+  }
+
+  unsigned int
+  QueryHints::add_feature(const std::string &name)
+  {
+    WBAssertThrow(thread_hints.n_slots() == 0, "Features can not be added to the query hints after they have been used.");
+    names.push_back(name);
+    return static_cast<unsigned int>(names.size() - 1);
+  }
+
+  QueryHints::FeatureHints &
+  QueryHints::get_thread_hints(const unsigned int entry) const
+  {
+    std::vector<FeatureHints> &hints = thread_hints.get(names.size());
+    WBAssert(entry < hints.size(), "Internal error: query hint entry " << entry << " does not exist.");
+    return hints[entry];
+  }
+
+  std::pair<unsigned long long,unsigned long long>
+  QueryHints::get_counters(const unsigned int entry) const
+  {
+    WBAssertThrow(entry < names.size(), "The query hint entry " << entry << " does not exist.");
+    std::pair<unsigned long long,unsigned long long> counters(0,0);
+    thread_hints.for_each([&](const std::vector<FeatureHints> &hints)
+    {
+      const FeatureHints &feature_hints = hints[entry];
+      counters.first += feature_hints.polygon.lookups + feature_hints.section.lookups;
+      counters.second += feature_hints.polygon.hits + feature_hints.section.hits;
+    });
+    return counters;
+  }
+
+  void
+  QueryHints::reset()
+  {
+    thread_hints.for_each([](std::vector<FeatureHints> &hints)
+    {
+      for (auto &feature_hints : hints)
+        feature_hints = FeatureHints();
+    });
+  }
+
+  std::string
+  QueryHints::report() const
+  {
+    std::stringstream report;
+    report << std::left << std::setw(40) << "feature"
+           << std::right << std::setw(14) << "lookups" << std::setw(14) << "hits" << std::setw(14) << "hit rate" << std::endl;
+
+    for (unsigned int entry = 0; entry < names.size(); ++entry)
+      {
+        const std::pair<unsigned long long,unsigned long long> counters = get_counters(entry);
+        if (counters.first == 0)
+          continue;
+
+        report << std::left << std::setw(40) << names[entry]
+               << std::right << std::setw(14) << counters.first << std::setw(14) << counters.second
+               << std::setw(14) << std::fixed << std::setprecision(4)
+               << static_cast<double>(counters.second) / static_cast<double>(counters.first) << std::endl;
+      }
+
+    return report.str();
+  }
+}
@@ -0,0 +1,201 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <world_builder/section_index.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The maximum number of cells of the grid.
+     */
+    const double maximum_n_cells = 4194304;
+
+    /**
+     * The strip of a section: the points between the two lines through the
+     * end points perpendicular to the section, and within the reach of the
+     * section.
+     */
+    struct Strip
+    {
+      Strip(const Point<2> &begin_, const Point<2> &end_, const double reach_)
+        :
+        begin(begin_),
+        length((end_ - begin_).norm()),
+        reach(reach_)
+      {
+        direction[0] = length > 0 ? (end_[0] - begin_[0]) / length : 0;
+        direction[1] = length > 0 ? (end_[1] - begin_[1]) / length : 0;
+
+        // The bounding box of the four corners of the strip.
+        const double half_width[2] = {std::fabs(direction[1]) * reach + (length > 0 ? 0 : reach),
+                                      std::fabs(direction[0]) * reach + (length > 0 ? 0 : reach)
+                                     };
+        for (unsigned int i = 0; i < 2; ++i)
+          {
+            box_min[i] = std::min(begin_[i], end_[i]) - half_width[i];
+            box_max[i] = std::max(begin_[i], end_[i]) + half_width[i];
+          }
+      }
+
+      /**
+       * Whether a square with the given center and half diagonal may
+       * overlap with the strip.
+       */
+      bool
+      may_overlap(const double x, const double y, const double half_diagonal) const
+      {
+        if (length <= 0)
+          return true;
+        const double along = (x - begin[0]) * direction[0] + (y - begin[1]) * direction[1];
+        const double across = (x - begin[0]) * direction[1] - (y - begin[1]) * direction[0];
+        const double dx = std::max(0.0, std::max(-along, along - length));
+        const double dy = std::max(0.0, std::fabs(across) - reach);
+        return dx * dx + dy * dy <= half_diagonal * half_diagonal;
+      }
+
+      const Point<2> begin;
+      const double length;
+      const double reach;
+      double direction[2];
+      double box_min[2];
+      double box_max[2];
+    };
+  }
+
+  SectionIndex::SectionIndex()
+    :
+    initialized(false),
+    cell_size(0)
+  {
+    origin[0] = origin[1] = 0;
+    n_cells[0] = n_cells[1] = 0;
+  }
+
+  void
+  SectionIndex::clear()
+  {
+    initialized = false;
+    cell_offsets.clear();
+    cell_offsets.shrink_to_fit();
+    cell_sections.clear();
+    cell_sections.shrink_to_fit();
+  }
+
+  void
+  SectionIndex::reinit(const std::vector<Point<2> > &point_list, const double reach)
+  {
+    clear();
+    if (point_list.size() < 2 || !std::isfinite(reach))
+      return;
+
+    std::vector<Strip> strips;
+    strips.reserve(point_list.size() - 1);
+    double box_min[2] = {INFINITY, INFINITY};
+    double box_max[2] = {-INFINITY, -INFINITY};
+    double total_length = 0;
+    for (std::size_t i = 0; i + 1 < point_list.size(); ++i)
+      {
+        strips.emplace_back(point_list[i], point_list[i+1], reach);
+        total_length += strips.back().length;
+        for (unsigned int d = 0; d < 2; ++d)
+          {
+            box_min[d] = std::min(box_min[d], strips.back().box_min[d]);
+            box_max[d] = std::max(box_max[d], strips.back().box_max[d]);
+          }
+      }
+
+    // Cells of about an eighth of the reach, but not smaller than a section,
+    // keep the number of sections per cell and the number of cells per
+    // section small.
+    const double width[2] = {box_max[0] - box_min[0], box_max[1] - box_min[1]};
+    cell_size = std::max(reach / 8, total_length / static_cast<double>(strips.size()));
+    cell_size = std::max(cell_size, std::sqrt(width[0] * width[1] / maximum_n_cells));
+    if (!(cell_size > 0))
+      cell_size = 1;
+
+    for (unsigned int d = 0; d < 2; ++d)
+      {
+        origin[d] = box_min[d];
+        n_cells[d] = static_cast<std::size_t>(width[d] / cell_size) + 1;
+      }
+
+    // A cell is counted for a section when its center is within half a
+    // diagonal of the strip, with a little extra for round off errors.
+    const double half_diagonal = cell_size * (0.5 * std::sqrt(2.0) + 1e-6);
+    cell_offsets.assign(n_cells[0] * n_cells[1] + 1, 0);
+    for (unsigned int pass = 0; pass < 2; ++pass)
+      {
+        for (std::size_t section = 0; section < strips.size(); ++section)
+          {
+            const Strip &strip = strips[section];
+            const std::size_t first_x = static_cast<std::size_t>((strip.box_min[0] - origin[0]) / cell_size);
+            const std::size_t first_y = static_cast<std::size_t>((strip.box_min[1] - origin[1]) / cell_size);
+            const std::size_t last_x = std::min(n_cells[0] - 1, static_cast<std::size_t>((strip.box_max[0] - origin[0]) / cell_size));
+            const std::size_t last_y = std::min(n_cells[1] - 1, static_cast<std::size_t>((strip.box_max[1] - origin[1]) / cell_size));
+            for (std::size_t j = first_y; j <= last_y; ++j)
+              for (std::size_t i = first_x; i <= last_x; ++i)
+                if (strip.may_overlap(origin[0] + (i + 0.5) * cell_size, origin[1] + (j + 0.5) * cell_size, half_diagonal))
+                  {
+                    const std::size_t cell = j * n_cells[0] + i;
+                    if (pass == 0)
+                      ++cell_offsets[cell + 1];
+                    else
+                      cell_sections[cell_offsets[cell]++] = static_cast<unsigned int>(section);
+                  }
+          }
+
+        if (pass == 0)
+          {
+            for (std::size_t cell = 0; cell + 1 < cell_offsets.size(); ++cell)
+              cell_offsets[cell + 1] += cell_offsets[cell];
+            cell_sections.resize(cell_offsets.back());
+          }
+      }
+
+    // The second pass has moved every offset to the begin of the next cell.
+    for (std::size_t cell = cell_offsets.size() - 1; cell > 0; --cell)
+      cell_offsets[cell] = cell_offsets[cell - 1];
+    cell_offsets[0] = 0;
+
+    initialized = true;
+  }
+
+  SectionIndex::Range
+  SectionIndex::sections(const Point<2> &point) const
+  {
+    const double x = (point[0] - origin[0]) / cell_size;
+    const double y = (point[1] - origin[1]) / cell_size;
+    if (!(x >= 0 && y >= 0 && x < static_cast<double>(n_cells[0]) && y < static_cast<double>(n_cells[1])))
+      return Range(nullptr, nullptr);
+
+    const std::size_t cell = static_cast<std::size_t>(y) * n_cells[0] + static_cast<std::size_t>(x);
+    return Range(cell_sections.data() + cell_offsets[cell], cell_sections.data() + cell_offsets[cell + 1]);
+  }
+
+  std::size_t
+  SectionIndex::memory_usage() const
+  {
+    return cell_offsets.capacity() * sizeof(std::size_t) + cell_sections.capacity() * sizeof(unsigned int);
+  }
+}
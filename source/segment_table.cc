@@ -0,0 +1,74 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdint>
+
+#include <world_builder/segment_table.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The number of doubles in a cache line.
+     */
+    const std::size_t cache_line_doubles = 64 / sizeof(double);
+
+    std::size_t
+    round_up_to_cache_line(const std::size_t n)
+    {
+      return (n + cache_line_doubles - 1) / cache_line_doubles * cache_line_doubles;
+    }
+  }
+
+  SegmentTable::SegmentTable()
+    :
+    number_of_sections(0),
+    number_of_segments(0),
+    row_stride(0),
+    storage_size(0),
+    data(nullptr)
+  {}
+
+  void
+  SegmentTable::reinit(const std::size_t n_sections, const std::size_t n_segments)
+  {
+    number_of_sections = n_sections;
+    number_of_segments = n_segments;
+    row_stride = round_up_to_cache_line(n_segments);
+
+    // Allocate one cache line more than needed, so that the start of the
+    // table can be moved to a cache line boundary.
+    const std::size_t n_values = n_fields * n_sections * row_stride + round_up_to_cache_line(n_sections);
+    storage_size = n_values + cache_line_doubles;
+    storage.reset(new double[storage_size]);
+    std::fill(storage.get(), storage.get() + storage_size, 0.0);
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage.get());
+    const std::uintptr_t aligned_address = (address + 63) / 64 * 64;
+    data = storage.get() + (aligned_address - address) / sizeof(double);
+  }
+
+  std::size_t
+  SegmentTable::memory_usage() const
+  {
+    return storage_size * sizeof(double);
+  }
+}
@@ -0,0 +1,152 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <world_builder/slab_envelope.h>
+#include <world_builder/utilities.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * Whether the unit vector is within the given angle of the cap, where
+     * the angle is given by its cosine and sine. A small tolerance keeps
+     * the test conservative with respect to round off errors.
+     */
+    template<class Cap>
+    bool
+    within_angle_of_cap(const Cap &cap, const double unit[3], const double cos_angle, const double sin_angle)
+    {
+      // The sum of the angles is at least 180 degrees, which contains the
+      // whole sphere.
+      if (cos_angle <= -cap.cos_radius)
+        return true;
+
+      const double cos_distance = unit[0] * cap.center[0] + unit[1] * cap.center[1] + unit[2] * cap.center[2];
+      return cos_distance >= cos_angle * cap.cos_radius - sin_angle * cap.sin_radius - 1e-12;
+    }
+  }
+
+  SlabEnvelope::SlabEnvelope()
+    :
+    initialized(false),
+    reach(0)
+  {
+    bounding_cap.center[0] = bounding_cap.center[1] = bounding_cap.center[2] = 0;
+    bounding_cap.cos_radius = -1;
+    bounding_cap.sin_radius = 0;
+  }
+
+  void
+  SlabEnvelope::clear()
+  {
+    initialized = false;
+    caps.clear();
+    caps.shrink_to_fit();
+  }
+
+  void
+  SlabEnvelope::reinit(const std::vector<Point<2> > &point_list, const double reach_)
+  {
+    clear();
+    if (point_list.size() < 2 || !std::isfinite(reach_))
+      return;
+
+    reach = reach_;
+    caps.resize(point_list.size() - 1);
+    double sum[3] = {0, 0, 0};
+    for (std::size_t i = 0; i + 1 < point_list.size(); ++i)
+      {
+        // The path between the two points is a straight line in longitude
+        // and latitude, so every point on it is at most half its length in
+        // longitude and latitude away from its center on the unit sphere.
+        const Point<2> center = 0.5 * (point_list[i] + point_list[i+1]);
+        const double radius = std::min(0.5 * (point_list[i+1] - point_list[i]).norm(), Utilities::const_pi);
+        const Point<3> center_cartesian = Utilities::spherical_to_cartesian_coordinates({{1, center[0], center[1]}});
+
+        Cap &cap = caps[i];
+        for (unsigned int d = 0; d < 3; ++d)
+          {
+            cap.center[d] = center_cartesian[d];
+            sum[d] += center_cartesian[d];
+          }
+        cap.cos_radius = std::cos(radius);
+        cap.sin_radius = std::sin(radius);
+      }
+
+    // The bounding cap is centered at the mean of the centers of the caps,
+    // and is large enough to contain all of them.
+    const double sum_norm = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+    double bounding_radius = Utilities::const_pi;
+    if (sum_norm > 1e-8)
+      {
+        for (unsigned int d = 0; d < 3; ++d)
+          bounding_cap.center[d] = sum[d] / sum_norm;
+
+        bounding_radius = 0;
+        for (auto &cap : caps)
+          {
+            const double cos_distance = cap.center[0] * bounding_cap.center[0]
+                                        + cap.center[1] * bounding_cap.center[1]
+                                        + cap.center[2] * bounding_cap.center[2];
+            bounding_radius = std::max(bounding_radius,
+                                       std::acos(std::max(-1.0, std::min(1.0, cos_distance))) + std::acos(cap.cos_radius));
+          }
+        // Be generous with round off errors.
+        bounding_radius = std::min(Utilities::const_pi, bounding_radius * (1 + 1e-8) + 1e-8);
+      }
+    bounding_cap.cos_radius = std::cos(bounding_radius);
+    bounding_cap.sin_radius = std::sin(bounding_radius);
+
+    initialized = true;
+  }
+
+  bool
+  SlabEnvelope::may_contain(const Point<3> &position, const double surface_radius) const
+  {
+    if (!initialized || !(reach < surface_radius))
+      return true;
+
+    const double norm = position.norm();
+    if (!(norm > 0))
+      return true;
+
+    const double unit[3] = {position[0] / norm, position[1] / norm, position[2] / norm};
+    const double cos_angle = 1 - reach / surface_radius;
+    const double sin_angle = std::sqrt(std::max(0.0, 1 - cos_angle * cos_angle));
+
+    if (!within_angle_of_cap(bounding_cap, unit, cos_angle, sin_angle))
+      return false;
+
+    for (auto &cap : caps)
+      if (within_angle_of_cap(cap, unit, cos_angle, sin_angle))
+        return true;
+
+    return false;
+  }
+
+  std::size_t
+  SlabEnvelope::memory_usage() const
+  {
+    return caps.capacity() * sizeof(Cap);
+  }
+}
@@ -0,0 +1,200 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define WB_SNAPSHOT_USE_MMAP
+#endif
+
+#include <world_builder/config.h>
+#include <world_builder/snapshot.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The first bytes of every snapshot.
+     */
+    const char magic[8] = {'W','B','S','N','A','P','S','H'};
+
+    /**
+     * A number which is written to the snapshot to check that it is loaded
+     * on a machine with the same byte order.
+     */
+    const std::uint32_t byte_order_mark = 0x01020304;
+
+    /**
+     * The version of the World Builder which writes or loads a snapshot.
+     */
+    std::string
+    world_builder_version()
+    {
+      return Version::MAJOR + "." + Version::MINOR + "." + Version::PATCH + " (" + Version::GIT_SHA1 + ")";
+    }
+  }
+
+  Snapshot::Snapshot(World *world_)
+    :
+    world(world_),
+    loading(false),
+    data(nullptr),
+    data_size(0),
+    position(0),
+    mapped_data(nullptr)
+  {
+    write_bytes(magic, sizeof(magic));
+    std::uint32_t mark = byte_order_mark;
+    std::uint32_t version = format_version;
+    std::string world_builder = world_builder_version();
+    (*this)(mark, version, world_builder);
+  }
+
+  Snapshot::Snapshot(World *world_, const std::string &filename)
+    :
+    world(world_),
+    loading(true),
+    data(nullptr),
+    data_size(0),
+    position(0),
+    mapped_data(nullptr)
+  {
+#ifdef WB_SNAPSHOT_USE_MMAP
+    const int file = open(filename.c_str(), O_RDONLY);
+    WBAssertThrow(file != -1, "Could not open the snapshot file '" << filename << "'.");
+    struct stat file_status;
+    const bool has_status = fstat(file, &file_status) == 0;
+    if (has_status && file_status.st_size > 0)
+      {
+        data_size = static_cast<std::size_t>(file_status.st_size);
+        mapped_data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, file, 0);
+      }
+    close(file);
+    WBAssertThrow(has_status, "Could not read the size of the snapshot file '" << filename << "'.");
+    WBAssertThrow(mapped_data != MAP_FAILED, "Could not map the snapshot file '" << filename << "' into memory.");
+    data = static_cast<const char *>(mapped_data);
+#else
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.is_open(), "Could not open the snapshot file '" << filename << "'.");
+    loaded_file.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = loaded_file.data();
+    data_size = loaded_file.size();
+#endif
+
+    WBAssertThrow(data_size >= sizeof(magic) && std::memcmp(data, magic, sizeof(magic)) == 0,
+                  "The file '" << filename << "' is not a World Builder snapshot.");
+    position = sizeof(magic);
+
+    std::uint32_t mark = 0;
+    std::uint32_t version = 0;
+    (*this)(mark, version);
+    WBAssertThrow(mark == byte_order_mark,
+                  "The snapshot '" << filename << "' was written on a machine with a different byte order.");
+    WBAssertThrow(version == format_version,
+                  "The snapshot '" << filename << "' has format version " << version
+                  << ", but this version of the World Builder reads format version " << format_version << ".");
+
+    std::string world_builder;
+    (*this)(world_builder);
+    WBAssertThrow(world_builder == world_builder_version(),
+                  "The snapshot '" << filename << "' was written by World Builder version " << world_builder
+                  << ", but this is version " << world_builder_version()
+                  << ". Please create the snapshot again from the world builder file.");
+  }
+
+  Snapshot::~Snapshot()
+  {
+#ifdef WB_SNAPSHOT_USE_MMAP
+    if (mapped_data != nullptr && mapped_data != MAP_FAILED)
+      munmap(mapped_data, data_size);
+#endif
+  }
+
+  bool
+  Snapshot::is_snapshot(const std::string &filename)
+  {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    char file_magic[sizeof(magic)];
+    return file.read(file_magic, sizeof(magic)) && std::memcmp(file_magic, magic, sizeof(magic)) == 0;
+  }
+
+  void
+  Snapshot::write(const std::string &filename) const
+  {
+    WBAssertThrow(!loading, "Internal error: a snapshot which is being loaded can not be written.");
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.is_open(), "Could not open the snapshot file '" << filename << "' for writing.");
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    WBAssertThrow(file.good(), "Could not write the snapshot file '" << filename << "'.");
+  }
+
+  void
+  Snapshot::finish() const
+  {
+    WBAssertThrow(!loading || position == data_size,
+                  "The snapshot is corrupt: " << data_size - position << " bytes were not read.");
+  }
+
+  void
+  Snapshot::operator()(std::string &string)
+  {
+    const std::size_t n = container_size(string.size(), 1);
+    if (loading)
+      {
+        WBAssertThrow(n <= data_size - position, "The snapshot is corrupt: it ends in the middle of a string.");
+        string.assign(data + position, n);
+        position += n;
+      }
+    else
+      write_bytes(string.data(), n);
+  }
+
+  void
+  Snapshot::write_bytes(const void *bytes, const std::size_t n)
+  {
+    const char *begin = static_cast<const char *>(bytes);
+    buffer.insert(buffer.end(), begin, begin + n);
+  }
+
+  void
+  Snapshot::read_bytes(void *bytes, const std::size_t n)
+  {
+    WBAssertThrow(n <= data_size - position, "The snapshot is corrupt: it ends before all data is read.");
+    if (n > 0)
+      std::memcpy(bytes, data + position, n);
+    position += n;
+  }
+
+  std::size_t
+  Snapshot::container_size(const std::size_t size, const std::size_t element_size)
+  {
+    std::uint64_t n = size;
+    (*this)(n);
+    WBAssertThrow(!loading || n <= (data_size - position) / element_size,
+                  "The snapshot is corrupt: a container has " << n << " elements, but only "
+                  << data_size - position << " bytes are left.");
+    return static_cast<std::size_t>(n);
+  }
+}
@@ -0,0 +1,225 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+
+#include <world_builder/assert.h>
+#include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/spatial_order.h>
+#include <world_builder/thread_chunks.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The number of bits of a coordinate in a key.
+     */
+    const unsigned int bits_per_coordinate = 21;
+
+    /**
+     * The number of bits of the key which are sorted in one pass of the
+     * radix sort, and the number of buckets of a pass.
+     */
+    const unsigned int bits_per_pass = 11;
+    const size_t n_buckets = static_cast<size_t>(1) << bits_per_pass;
+
+    /**
+     * The minimum number of points a thread sorts. Below this, starting the
+     * threads takes longer than sorting.
+     */
+    const size_t minimum_points_per_thread = 32768;
+
+    /**
+     * Spreads the lowest 21 bits of value out so that there are two zero
+     * bits between every two bits.
+     */
+    std::uint64_t
+    spread_bits(const std::uint32_t value)
+    {
+      std::uint64_t bits = value & 0x1fffff;
+      bits = (bits | bits << 32) & 0x1f00000000ffffULL;
+      bits = (bits | bits << 16) & 0x1f0000ff0000ffULL;
+      bits = (bits | bits << 8) & 0x100f00f00f00f00fULL;
+      bits = (bits | bits << 4) & 0x10c30c30c30c30c3ULL;
+      bits = (bits | bits << 2) & 0x1249249249249249ULL;
+      return bits;
+    }
+
+    /**
+     * Returns the number of threads to use for n points, given the maximum
+     * number of threads.
+     */
+    unsigned int
+    threads_for(const size_t n, unsigned int n_threads)
+    {
+      if (n_threads == 0)
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+      return static_cast<unsigned int>(std::max(std::min(static_cast<size_t>(n_threads), n / minimum_points_per_thread),
+                                                static_cast<size_t>(1)));
+    }
+  }
+
+  SpatialOrder::SpatialOrder()
+    :
+    enabled(false),
+    n_threads(1)
+  {}
+
+  void
+  SpatialOrder::set_enabled(const bool enabled_)
+  {
+    enabled = enabled_;
+  }
+
+  void
+  SpatialOrder::set_n_threads(const unsigned int n_threads_)
+  {
+    n_threads = n_threads_;
+  }
+
+  std::uint64_t
+  SpatialOrder::morton_key(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
+  {
+    return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+  }
+
+  void
+  SpatialOrder::compute_permutation(const size_t n_points,
+                                    const double *x,
+                                    const double *y,
+                                    const double *z,
+                                    const CoordinateSystems::Interface &coordinate_system,
+                                    std::vector<size_t> &permutation) const
+  {
+    const unsigned int n_used_threads = threads_for(n_points, n_threads);
+
+    // The keys are computed in the natural coordinates, in which the
+    // features are defined, scaled to the bounding box of the points.
+    std::vector<std::array<double,3> > natural(n_points);
+    std::vector<std::array<double,3> > lower(n_used_threads, {{INFINITY, INFINITY, INFINITY}});
+    std::vector<std::array<double,3> > upper(n_used_threads, {{-INFINITY, -INFINITY, -INFINITY}});
+    Utilities::run_in_chunks(n_points, n_used_threads, [&](const unsigned int thread, const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        {
+          natural[i] = coordinate_system.cartesian_to_natural_coordinates({{x[i], y[i], z[i]}});
+          for (unsigned int d = 0; d < 3; ++d)
+            {
+              lower[thread][d] = std::min(lower[thread][d], natural[i][d]);
+              upper[thread][d] = std::max(upper[thread][d], natural[i][d]);
+            }
+        }
+    });
+
+    std::array<double,3> minimum = {{INFINITY, INFINITY, INFINITY}};
+    std::array<double,3> scale = {{0, 0, 0}};
+    for (unsigned int d = 0; d < 3; ++d)
+      {
+        double maximum = -INFINITY;
+        for (unsigned int thread = 0; thread < n_used_threads; ++thread)
+          {
+            minimum[d] = std::min(minimum[d], lower[thread][d]);
+            maximum = std::max(maximum, upper[thread][d]);
+          }
+        WBAssertThrow(n_points == 0 || (std::isfinite(minimum[d]) && std::isfinite(maximum)),
+                      "The coordinates of the points to order have to be finite.");
+        if (maximum > minimum[d])
+          scale[d] = static_cast<double>((1u << bits_per_coordinate) - 1) / (maximum - minimum[d]);
+      }
+
+    std::vector<std::uint64_t> keys(n_points);
+    Utilities::run_in_chunks(n_points, n_used_threads, [&](const unsigned int, const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        keys[i] = morton_key(static_cast<std::uint32_t>((natural[i][0] - minimum[0]) * scale[0]),
+                             static_cast<std::uint32_t>((natural[i][1] - minimum[1]) * scale[1]),
+                             static_cast<std::uint32_t>((natural[i][2] - minimum[2]) * scale[2]));
+    });
+
+    radix_sort(keys, permutation, n_threads);
+  }
+
+  void
+  SpatialOrder::radix_sort(const std::vector<std::uint64_t> &keys,
+                           std::vector<size_t> &permutation,
+                           unsigned int n_threads)
+  {
+    const size_t n = keys.size();
+    n_threads = threads_for(n, n_threads);
+
+    std::vector<std::uint64_t> sorted_keys(keys), next_keys(n);
+    std::vector<size_t> next_permutation(n);
+    permutation.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      permutation[i] = i;
+
+    // Every thread counts the digits of its own part of the keys, after
+    // which the position of every bucket of every thread follows from the
+    // counts, and every thread moves its part of the keys to their positions.
+    // Moving the keys of a part in order keeps the sort stable.
+    std::vector<std::vector<size_t> > counts(n_threads, std::vector<size_t>(n_buckets));
+    for (unsigned int shift = 0; shift < 64; shift += bits_per_pass)
+      {
+        Utilities::run_in_chunks(n, n_threads, [&](const unsigned int thread, const size_t begin, const size_t end)
+        {
+          std::vector<size_t> &count = counts[thread];
+          std::fill(count.begin(), count.end(), 0);
+          for (size_t i = begin; i < end; ++i)
+            ++count[(sorted_keys[i] >> shift) & (n_buckets - 1)];
+        });
+
+        // If all keys have the same digit, this pass does not change the order.
+        bool one_bucket = false;
+        size_t position = 0;
+        for (size_t bucket = 0; bucket < n_buckets; ++bucket)
+          {
+            size_t bucket_size = 0;
+            for (unsigned int thread = 0; thread < n_threads; ++thread)
+              {
+                const size_t count = counts[thread][bucket];
+                counts[thread][bucket] = position;
+                position += count;
+                bucket_size += count;
+              }
+            one_bucket = one_bucket || bucket_size == n;
+          }
+        if (one_bucket)
+          continue;
+
+        Utilities::run_in_chunks(n, n_threads, [&](const unsigned int thread, const size_t begin, const size_t end)
+        {
+          std::vector<size_t> &next_position = counts[thread];
+          for (size_t i = begin; i < end; ++i)
+            {
+              const size_t target = next_position[(sorted_keys[i] >> shift) & (n_buckets - 1)]++;
+              next_keys[target] = sorted_keys[i];
+              next_permutation[target] = permutation[i];
+            }
+        });
+        sorted_keys.swap(next_keys);
+        permutation.swap(next_permutation);
+      }
+  }
+}
@@ -0,0 +1,163 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <world_builder/assert.h>
+#include <world_builder/trace.h>
+
+namespace WorldBuilder
+{
+  Trace::Scope::Scope(Trace &trace_, const std::string &name_, const std::string &category_)
+    :
+    trace(trace_.is_enabled() ? &trace_ : nullptr)
+  {
+    if (trace != nullptr)
+      {
+        name = name_;
+        category = category_;
+        start = std::chrono::steady_clock::now();
+      }
+  }
+
+  Trace::Scope::~Scope()
+  {
+    end();
+  }
+
+  void
+  Trace::Scope::end()
+  {
+    if (trace != nullptr)
+      {
+        trace->add_span(name, category, arguments, start, std::chrono::steady_clock::now());
+        trace = nullptr;
+      }
+  }
+
+  void
+  Trace::Scope::add_argument(const std::string &key, const std::string &value)
+  {
+    if (trace != nullptr)
+      arguments.emplace_back(key, value);
+  }
+
+  Trace::Trace()
+    :
+    enabled(false),
+    creation_time(std::chrono::steady_clock::now())
+  {}
+
+  Trace::~Trace()
+  {}
+
+  void
+  Trace::enable(const std::string &file_name_)
+  {
+    file_name = file_name_;
+    enabled = true;
+  }
+
+  void
+  Trace::add_span(const std::string &name,
+                  const std::string &category,
+                  const std::vector<std::pair<std::string,std::string> > &arguments,
+                  const std::chrono::steady_clock::time_point &begin,
+                  const std::chrono::steady_clock::time_point &end)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto thread = thread_numbers.find(std::this_thread::get_id());
+    if (thread == thread_numbers.end())
+      thread = thread_numbers.insert(std::make_pair(std::this_thread::get_id(),
+                                                    static_cast<unsigned int>(thread_numbers.size()))).first;
+
+    Span span;
+    span.name = name;
+    span.category = category;
+    span.arguments = arguments;
+    span.begin = std::chrono::duration<double, std::micro>(begin - creation_time).count();
+    span.duration = std::chrono::duration<double, std::micro>(end - begin).count();
+    span.thread = thread->second;
+    spans.push_back(span);
+  }
+
+  std::string
+  Trace::to_json() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+    for (auto &span : spans)
+      {
+        // A complete event ("X"), which has both a begin time and a duration.
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(span.name.c_str());
+        writer.Key("cat");
+        writer.String(span.category.c_str());
+        writer.Key("ph");
+        writer.String("X");
+        writer.Key("ts");
+        writer.Double(span.begin);
+        writer.Key("dur");
+        writer.Double(span.duration);
+        writer.Key("pid");
+        writer.Uint(0);
+        writer.Key("tid");
+        writer.Uint(span.thread);
+        if (span.arguments.size() > 0)
+          {
+            writer.Key("args");
+            writer.StartObject();
+            for (auto &argument : span.arguments)
+              {
+                writer.Key(argument.first.c_str());
+                writer.String(argument.second.c_str());
+              }
+            writer.EndObject();
+          }
+        writer.EndObject();
+      }
+    writer.EndArray();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.EndObject();
+
+    return buffer.GetString();
+  }
+
+  void
+  Trace::write() const
+  {
+    if (!enabled)
+      return;
+
+    std::ofstream file(file_name.c_str());
+    WBAssertThrow(file.is_open(), "Error: Could not open the trace file '" << file_name << "' for writing.");
+    file << to_json() << std::endl;
+  }
+}
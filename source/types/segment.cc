@@ -18,8 +18,10 @@
 */
 #include <world_builder/types/segment.h>
 #include <world_builder/assert.h>
+#include <world_builder/nan.h>
 #include <world_builder/utilities.h>
 #include <world_builder/parameters.h>
+#include <world_builder/snapshot.h>
 
 
 #include <world_builder/features/subducting_plate_models/temperature/interface.h>
@@ -159,6 +161,18 @@ namespace WorldBuilder
 
     }
 
+    template<class A, class B>
+    Segment<A,B>::Segment()
+      :
+      value_length(NaN::DSNAN),
+      default_length(NaN::DSNAN),
+      value_thickness(NaN::DSNAN,NaN::DSNAN,cartesian),
+      value_top_truncation(NaN::DSNAN,NaN::DSNAN,cartesian),
+      value_angle(NaN::DSNAN,NaN::DSNAN,cartesian)
+    {
+      this->type_name = Types::type::Segment;
+    }
+
     template<class A, class B>
     Segment<A,B>::Segment(Segment const &other)
       :
@@ -186,6 +200,14 @@ namespace WorldBuilder
       WBAssertThrow(false, "not implemented.");
     }
 
+    template<class A, class B>
+    void
+    Segment<A,B>::serialize(Snapshot &snapshot)
+    {
+      snapshot(value_length, default_length, value_thickness, value_top_truncation, value_angle,
+               temperature_systems, composition_systems);
+    }
+
 
     /**
     * Todo: Returns a vector of pointers to the Point<3> Type based on the provided name.
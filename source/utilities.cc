@@ -49,6 +49,77 @@ namespace WorldBuilder
         }
     }
 
+    namespace
+    {
+      /**
+       * Returns the distance of the point to the closest edge of the polygon.
+       */
+      double
+      distance_to_polygon_edges(const std::vector<Point<2> > &point_list,
+                                const Point<2> &point)
+      {
+        double minimum_distance_square = INFINITY;
+        for (size_t i = 0, j = point_list.size() - 1; i < point_list.size(); j = i++)
+          {
+            const double edge_x = point_list[i][0] - point_list[j][0];
+            const double edge_y = point_list[i][1] - point_list[j][1];
+            const double point_x = point[0] - point_list[j][0];
+            const double point_y = point[1] - point_list[j][1];
+            const double edge_length_square = edge_x * edge_x + edge_y * edge_y;
+            double fraction = edge_length_square > 0 ? (point_x * edge_x + point_y * edge_y) / edge_length_square : 0;
+            fraction = std::min(std::max(fraction, 0.0), 1.0);
+            const double distance_x = point_x - fraction * edge_x;
+            const double distance_y = point_y - fraction * edge_y;
+            minimum_distance_square = std::min(minimum_distance_square, distance_x * distance_x + distance_y * distance_y);
+          }
+        return std::sqrt(minimum_distance_square);
+      }
+    }
+
+    bool
+    polygon_contains_point(const std::vector<Point<2> > &point_list,
+                           const Point<2> &point,
+                           QueryHints::PolygonHint *hint)
+    {
+      if (hint == nullptr)
+        return polygon_contains_point(point_list, point);
+
+      ++hint->lookups;
+      const bool spherical_point = point.get_coordinate_system() == CoordinateSystem::spherical;
+      if (hint->valid
+          // In spherical coordinates, the point is also tested shifted by
+          // 2 pi in the direction of the longitude of the hint.
+          && (!spherical_point || (point[0] < 0) == (hint->point[0] < 0)))
+        {
+          const double distance_x = point[0] - hint->point[0];
+          const double distance_y = point[1] - hint->point[1];
+          if (distance_x * distance_x + distance_y * distance_y < hint->safe_distance * hint->safe_distance)
+            {
+              ++hint->hits;
+              return hint->inside;
+            }
+        }
+
+      const bool inside = polygon_contains_point(point_list, point);
+
+      // Within this distance, the point can not cross an edge of the
+      // polygon. A small part of it is left out, so that round off in the
+      // test above can not change the result.
+      double safe_distance = distance_to_polygon_edges(point_list, point);
+      if (spherical_point)
+        {
+          Point<2> other_point = point;
+          other_point[0] += point[0] < 0 ? 2.0 * const_pi : -2.0 * const_pi;
+          safe_distance = std::min(safe_distance, distance_to_polygon_edges(point_list, other_point));
+        }
+
+      hint->point = {{point[0], point[1]}};
+      hint->safe_distance = safe_distance - 1e-9 * (1 + std::fabs(point[0]) + std::fabs(point[1]));
+      hint->valid = hint->safe_distance > 0;
+      hint->inside = inside;
+      return inside;
+    }
+
     bool
     polygon_contains_point_implementation(const std::vector<Point<2> > &point_list,
                                           const Point<2> &point)
@@ -433,16 +504,431 @@ namespace WorldBuilder
       return Point<3>(x,y,z,a.get_coordinate_system());
     }
 
-    std::map<std::string,double>
-    distance_point_from_curved_planes(const Point<3> &check_point, // cartesian point in spherical system
-                                      const Point<2> &reference_point, // in (rad) spherical coordinates in spherical system
-                                      const std::vector<Point<2> > &point_list, // in  (rad) spherical coordinates in spherical system
-                                      const std::vector<std::vector<double> > &plane_segment_lengths,
-                                      const std::vector<std::vector<Point<2> > > &plane_segment_angles,
-                                      const double start_radius,
-                                      const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
-                                      const bool only_positive,
-                                      std::vector<double> global_x_list)
+    PointDistanceFromCurvedPlanes::PointDistanceFromCurvedPlanes()
+      :
+      distance_from_plane(INFINITY),
+      distance_along_plane(INFINITY),
+      section_fraction(0.0),
+      segment_fraction(0.0),
+      section(0),
+      segment(0),
+      average_angle(0.0),
+      local_thickness(INFINITY)
+    {}
+
+    namespace
+    {
+      /**
+       * Gives access to segment tables which are stored as nested vectors.
+       */
+      class NestedSegmentTables
+      {
+        public:
+          NestedSegmentTables(const std::vector<std::vector<double> > &lengths_,
+                              const std::vector<std::vector<Point<2> > > &angles_)
+            :
+            lengths(lengths_),
+            angles(angles_)
+          {}
+
+          size_t n_sections() const
+          {
+            return angles.size();
+          }
+
+          size_t n_segments(const size_t section) const
+          {
+            return lengths[section].size();
+          }
+
+          double length(const size_t section, const size_t segment) const
+          {
+            return lengths[section][segment];
+          }
+
+          double angle_top(const size_t section, const size_t segment) const
+          {
+            return angles[section][segment][0];
+          }
+
+          double angle_bottom(const size_t section, const size_t segment) const
+          {
+            return angles[section][segment][1];
+          }
+
+        private:
+          const std::vector<std::vector<double> > &lengths;
+          const std::vector<std::vector<Point<2> > > &angles;
+      };
+
+      /**
+       * Gives access to segment tables which are stored in a SegmentTable.
+       */
+      class FlatSegmentTables
+      {
+        public:
+          FlatSegmentTables(const SegmentTable &table_)
+            :
+            table(table_)
+          {}
+
+          size_t n_sections() const
+          {
+            return table.n_sections();
+          }
+
+          size_t n_segments(const size_t) const
+          {
+            return table.n_segments();
+          }
+
+          double length(const size_t section, const size_t segment) const
+          {
+            return table(SegmentTable::length, section, segment);
+          }
+
+          double angle_top(const size_t section, const size_t segment) const
+          {
+            return table(SegmentTable::angle_top, section, segment);
+          }
+
+          double angle_bottom(const size_t section, const size_t segment) const
+          {
+            return table(SegmentTable::angle_bottom, section, segment);
+          }
+
+        private:
+          const SegmentTable &table;
+      };
+
+      /**
+       * The closest segment to a point found up to now, and the state of the
+       * search through the segments of the current section.
+       */
+      struct SegmentSearch
+      {
+        SegmentSearch()
+          :
+          new_distance(INFINITY),
+          new_along_plane_distance(INFINITY),
+          begin_segment(cartesian),
+          end_segment(cartesian),
+          total_length(0.0),
+          average_angle(0.0)
+        {}
+
+        PointDistanceFromCurvedPlanes closest;
+        double new_distance;
+        double new_along_plane_distance;
+        Point<2> begin_segment;
+        Point<2> end_segment;
+        double total_length;
+        double average_angle;
+      };
+
+      /**
+       * Moves the search of a point on to the next segment of a section, and
+       * makes this segment the closest one if the point is closer to it. The
+       * point and the segments are given in the plane perpendicular to the
+       * section, and the segment is given by its interpolated angles and
+       * length. The add_angle is the angle which has been added to these
+       * angles for the depth method angle_at_begin_segment_with_surface.
+       *
+       * This is the step which distance_point_from_curved_planes_impl() and
+       * cartesian_distance_block() have in common, so that they compute the
+       * same results.
+       */
+      inline void
+      search_segment(const Point<2> &check_point_2d,
+                     const double interpolated_angle_top,
+                     const double interpolated_angle_bottom,
+                     const double interpolated_segment_length,
+                     const double add_angle,
+                     const CenterlineTable *centerline_table,
+                     const CenterlineTable::Sample &centerline_sample,
+                     const size_t current_section,
+                     const double section_fraction,
+                     const size_t current_segment,
+                     const bool only_positive,
+                     SegmentSearch &search)
+      {
+        Point<2> &begin_segment = search.begin_segment;
+        Point<2> &end_segment = search.end_segment;
+        double &new_distance = search.new_distance;
+        double &new_along_plane_distance = search.new_along_plane_distance;
+
+        begin_segment = end_segment;
+
+        WBAssert(!std::isnan(begin_segment[0]),
+                 "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
+        WBAssert(!std::isnan(begin_segment[1]),
+                 "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
+
+        const double degree_90_to_rad = 0.5 * const_pi;
+
+        WBAssert(!std::isnan(interpolated_angle_top),
+                 "Internal error: The interpolated_angle_top variable is not a number: " << interpolated_angle_top);
+
+        // We want to know where the end point of this segment is (and
+        // the start of the next segment). There are two cases which we
+        // will deal with separately. The first one is if the angle is
+        // constant. The second one is if the angle changes.
+        const double difference_in_angle_along_segment = interpolated_angle_top - interpolated_angle_bottom;
+
+        if (std::fabs(difference_in_angle_along_segment) < 1e-8)
+          {
+            // The angle is constant. It is easy find find the end of
+            // this segment and the distance.
+            if (std::fabs(interpolated_segment_length) > std::numeric_limits<double>::epsilon())
+              {
+                if (centerline_sample.lower != nullptr)
+                  {
+                    const CenterlineTable::Directions directions = centerline_table->directions(centerline_sample, current_segment);
+                    end_segment[0] += interpolated_segment_length * directions.cos_angle_top;
+                    end_segment[1] -= interpolated_segment_length * directions.sin_angle_top;
+                  }
+                else
+                  {
+                    end_segment[0] += interpolated_segment_length * std::sin(degree_90_to_rad - interpolated_angle_top);
+                    end_segment[1] -= interpolated_segment_length * std::cos(degree_90_to_rad - interpolated_angle_top);
+                  }
+
+                Point<2> begin_end_segment = end_segment - begin_segment;
+                Point<2> normal_2d_plane(-begin_end_segment[0],begin_end_segment[1], cartesian);
+                WBAssert(std::fabs(normal_2d_plane.norm()) > std::numeric_limits<double>::epsilon(), "Internal Error: normal_2d_plane.norm() is zero, which should not happen. "
+                         << "Extra info: begin_end_segment[0] = " << begin_end_segment[0]
+                         << ", begin_end_segment[1] = " << begin_end_segment[1]
+                         << ", end_segment: [" << end_segment[0] << "," << end_segment[1] << "]"
+                         << ", begin_segment: [" << begin_segment[0] << "," << begin_segment[1] << "]"
+                        );
+                normal_2d_plane /= normal_2d_plane.norm();
+
+                // Now find the distance of a point to this line.
+                // Based on http://geomalgorithms.com/a02-_lines.html.
+                const Point<2> BSP_ESP = end_segment - begin_segment;
+                const Point<2> BSP_CP = check_point_2d - begin_segment;
+
+                const double c1 = BSP_ESP * BSP_CP;
+                const double c2 = BSP_ESP * BSP_ESP;
+
+                if (c1 < 0 || c2 < c1)
+                  {
+                    new_distance = INFINITY;
+                    new_along_plane_distance = INFINITY;
+                  }
+                else
+                  {
+                    const Point<2> Pb = begin_segment + (c1/c2) * BSP_ESP;
+                    const double side_of_line =  (begin_segment[0] - end_segment[0]) * (check_point_2d[1] - begin_segment[1])
+                                                 - (begin_segment[1] - end_segment[1]) * (check_point_2d[0] - begin_segment[0])
+                                                 < 0 ? -1.0 : 1.0;
+
+                    new_distance = side_of_line * (check_point_2d - Pb).norm();
+                    new_along_plane_distance = (begin_segment - Pb).norm();
+                  }
+
+              }
+          }
+        else
+          {
+            // The angle is not constant. This means that we need to
+            // define a circle. First find the center of the circle.
+            const double radius_angle_circle = std::fabs(interpolated_segment_length/difference_in_angle_along_segment);
+
+            WBAssert(!std::isnan(radius_angle_circle),
+                     "Internal error: The radius_angle_circle variable is not a number: " << radius_angle_circle
+                     << ". interpolated_segment_length = " << interpolated_segment_length
+                     << ", difference_in_angle_along_segment = " << difference_in_angle_along_segment);
+
+            Point<2> center_circle(cartesian);
+            double sin_angle_diff = 0;
+            double cos_angle_diff = 0;
+            if (centerline_sample.lower != nullptr)
+              {
+                // The center of the circle is a radius away from the
+                // begin point, perpendicular to the direction of the
+                // segment at the top.
+                const CenterlineTable::Directions directions = centerline_table->directions(centerline_sample, current_segment);
+                const double side_of_circle = difference_in_angle_along_segment < 0 ? -1.0 : 1.0;
+                center_circle[0] = begin_segment[0] + side_of_circle * radius_angle_circle * directions.sin_angle_top;
+                center_circle[1] = begin_segment[1] + side_of_circle * radius_angle_circle * directions.cos_angle_top;
+                sin_angle_diff = directions.sin_angle_difference;
+                cos_angle_diff = directions.cos_angle_difference;
+              }
+            else
+              {
+                const double cos_angle_top = std::cos(interpolated_angle_top);
+
+                WBAssert(!std::isnan(cos_angle_top),
+                         "Internal error: The radius_angle_circle variable is not a number: " << cos_angle_top
+                         << ". interpolated_angle_top = " << interpolated_angle_top);
+
+                if (std::fabs(interpolated_angle_top - 0.5 * const_pi) < 1e-8)
+                  {
+                    // if interpolated_angle_top is 90 degrees, the tan function
+                    // is undefined (1/0). What we really want in this case is
+                    // set the center to the correct location which is x = the x
+                    //begin point + radius and y = the y begin point.
+                    center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] + radius_angle_circle : begin_segment[0] - radius_angle_circle;
+                    center_circle[1] = begin_segment[1];
+                  }
+                else if (std::fabs(interpolated_angle_top - 1.5 * const_pi) < 1e-8)
+                  {
+                    // if interpolated_angle_top is 270 degrees, the tan function
+                    // is undefined (-1/0). What we really want in this case is
+                    // set the center to the correct location which is x = the x
+                    //begin point - radius and y = the y begin point.
+                    center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] - radius_angle_circle : begin_segment[0] + radius_angle_circle;
+                    center_circle[1] = begin_segment[1];
+                  }
+                else
+                  {
+                    double tan_angle_top = std::tan(interpolated_angle_top);
+
+                    WBAssert(!std::isnan(tan_angle_top),
+                             "Internal error: The tan_angle_top variable is not a number: " << tan_angle_top);
+                    const double center_circle_y = difference_in_angle_along_segment < 0 ?
+                                                   begin_segment[1] - radius_angle_circle * cos_angle_top
+                                                   : begin_segment[1] + radius_angle_circle * cos_angle_top;
+
+                    WBAssert(!std::isnan(center_circle_y),
+                             "Internal error: The center_circle_y variable is not a number: " << center_circle_y
+                             << ". begin_segment[1] = " << begin_segment[1]
+                             << ", radius_angle_circle = " << radius_angle_circle
+                             << ", cos_angle_top = " << cos_angle_top);
+
+                    // to prevent round off errors becomming dominant, we check
+                    // whether center_circle_y - begin_segment[1] should be zero.
+                    // TODO: improve this to some kind of relative difference.
+                    const double CCYBS = center_circle_y - begin_segment[1];
+
+                    WBAssert(!std::isnan(CCYBS),
+                             "Internal error: The CCYBS variable is not a number: " << CCYBS);
+
+
+
+                    center_circle[0] = begin_segment[0] + tan_angle_top * (CCYBS);
+                    center_circle[1] = center_circle_y;
+                  }
+
+                sin_angle_diff = sin(difference_in_angle_along_segment);
+                cos_angle_diff = cos(difference_in_angle_along_segment);
+              }
+
+            WBAssert(!std::isnan(center_circle[0]) || !std::isnan(center_circle[1]),
+                     "Internal error: The center variable contains not a number: " << center_circle[0] << ":" << center_circle[0]);
+            WBAssert(std::fabs((begin_segment-center_circle).norm() - std::fabs(radius_angle_circle))
+                     < 1e-8 * std::fabs((begin_segment-center_circle).norm() + std::fabs(radius_angle_circle)),
+                     "Internal error: The center of the circle is not a radius away from the begin point. " << std::endl
+                     << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
+                     << "The begin point is located at " << begin_segment[0] << ":" << begin_segment[1] << std::endl
+                     << "The computed radius is " << std::fabs((begin_segment-center_circle).norm())
+                     << ", and it should be " << radius_angle_circle << ".");
+
+
+            // Now compute the location of the end of the segment by
+            // rotating P1 around the center_circle
+            Point<2> BSPC = begin_segment - center_circle;
+            end_segment[0] = cos_angle_diff * BSPC[0] - sin_angle_diff * BSPC[1] + center_circle[0];
+            end_segment[1] = sin_angle_diff * BSPC[0] + cos_angle_diff * BSPC[1] + center_circle[1];
+
+
+
+            WBAssert(std::fabs((end_segment-center_circle).norm() - std::fabs(radius_angle_circle))
+                     < 1e-8 * std::fabs((end_segment-center_circle).norm() + std::fabs(radius_angle_circle)) ,
+                     "Internal error: The center of the circle is not a radius away from the end point. " << std::endl
+                     << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
+                     << "The end point is located at " << end_segment[0] << ":" << end_segment[1] << std::endl
+                     << "The computed radius is " << std::fabs((end_segment-center_circle).norm())
+                     << ", and it should be " << radius_angle_circle << ".");
+
+            // Now check if the angle of the check point in this circle
+            // is larger then the angle of P1 and smaller then P1 + angle
+            // difference. If that is the case then the distance from the
+            // plane is radius - (center - check_point).norm(). Otherwise
+            // it is infinity.
+            // The angle of the check point is computed with the help of
+            // dot product. But before that we need to adjust the check
+            // point 2d.
+            const Point<2> CPCR = check_point_2d - center_circle;
+            const double CPCR_norm = CPCR.norm();
+
+            const double dot_product = CPCR * Point<2>(0, radius_angle_circle, cartesian);
+            // If the x of the check point is larger then the x of center
+            // the circle, the angle is more than 180 degree, but the dot
+            // product will decrease instead of increase from 180 degrees.
+            // To fix this we make a special case for this.
+            // Furthermore, when the check point is at the same location as
+            // the center of the circle, we count that point as belonging
+            // to the top of the top segment (0 degree).
+            double check_point_angle = std::fabs(CPCR_norm) < std::numeric_limits<double>::epsilon() ? 2.0 * const_pi : (check_point_2d[0] <= center_circle[0]
+                                       ? std::acos(dot_product/(CPCR_norm * radius_angle_circle))
+                                       : 2.0 * const_pi - std::acos(dot_product/(CPCR_norm * radius_angle_circle)));
+            check_point_angle = difference_in_angle_along_segment >= 0 ? const_pi - check_point_angle : 2.0 * const_pi - check_point_angle;
+
+            // In the case that it is exactly 2 * pi, bring it back to zero
+            check_point_angle = (std::fabs(check_point_angle - 2 * const_pi) < 1e-14 ? 0 : check_point_angle);
+
+            if ((difference_in_angle_along_segment > 0 && (check_point_angle <= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
+                 && (check_point_angle >= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12))
+                || (difference_in_angle_along_segment < 0 && (check_point_angle >= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
+                    && (check_point_angle <= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12)))
+              {
+                new_distance = (radius_angle_circle - CPCR_norm) * (difference_in_angle_along_segment < 0 ? 1 : -1);
+                new_along_plane_distance = (radius_angle_circle * check_point_angle - radius_angle_circle * interpolated_angle_top) * (difference_in_angle_along_segment < 0 ? 1 : -1);
+              }
+
+          }
+
+        // Now we need to see whether we need to update the information
+        // based on whether this segment is the closest one to the point
+        // up to now. To do this we first look whether the point falls
+        // within the bound of the segment and if it is actually closer.
+        // TODO: find out whether the fabs() are needed.
+        PointDistanceFromCurvedPlanes &closest = search.closest;
+        if (new_along_plane_distance >= -1e-10 &&
+            new_along_plane_distance <= std::fabs(interpolated_segment_length) &&
+            std::fabs(new_distance) < std::fabs(closest.distance_from_plane))
+          {
+            // There are two specific cases we are concerned with. The
+            // first case is that we want to have both the positive and
+            // negative distances (above and below the line). The second
+            // case is that we only want positive distances.
+            closest.distance_from_plane = only_positive ? std::fabs(new_distance) : new_distance;
+            closest.distance_along_plane = new_along_plane_distance + search.total_length;
+            closest.section = current_section;
+            closest.section_fraction = section_fraction;
+            closest.segment = current_segment;
+            closest.segment_fraction = new_along_plane_distance / interpolated_segment_length;
+            closest.average_angle = (search.average_angle * search.total_length
+                                     + 0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * new_along_plane_distance);
+            closest.average_angle = (std::fabs(closest.average_angle) < std::numeric_limits<double>::epsilon() ? 0 : closest.average_angle /
+                                     (search.total_length + new_along_plane_distance));
+          }
+
+        // increase average angle
+        search.average_angle = (search.average_angle * search.total_length +
+                                0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * interpolated_segment_length);
+        search.average_angle = (std::fabs(search.average_angle) < std::numeric_limits<double>::epsilon() ? 0 : search.average_angle /
+                                (search.total_length + interpolated_segment_length));
+        // increase the total length for the next segment.
+        search.total_length += interpolated_segment_length;
+      }
+    }
+
+    template<class Segments>
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes_impl(const Point<3> &check_point, // cartesian point in spherical system
+                                           const Point<2> &reference_point, // in (rad) spherical coordinates in spherical system
+                                           const std::vector<Point<2> > &point_list, // in  (rad) spherical coordinates in spherical system
+                                           const Segments &segments,
+                                           const double start_radius,
+                                           const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                           const bool only_positive,
+                                           const std::vector<double> &global_x_list,
+                                           const SectionIndex *section_index,
+                                           const CenterlineTable *centerline_table,
+                                           QueryHints::SectionHint *section_hint)
     {
       // TODO: Assert that point_list, plane_segment_angles and plane_segment_lenghts have the same size.
       /*WBAssert(point_list.size() == plane_segment_lengths.size(),
@@ -454,20 +940,14 @@ namespace WorldBuilder
       WBAssert(point_list.size() == plane_segment_angles.size(),
                "Internal error: The size of point_list (" << point_list.size()
                << ") and global_x_list (" << global_x_list.size() << ") are different.");*/
-      if (global_x_list.size() == 0)
-        {
-          // fill it
-          global_x_list.resize(point_list.size());
-          for (unsigned int i = 0; i < point_list.size(); ++i)
-            global_x_list[i] = i;
-        }
-      WBAssertThrow(global_x_list.size() == point_list.size(), "The given global_x_list doesn't have "
-                    "the same size as the point list. This is required.");
+      // An empty global_x_list means {0,1,2,...}. It is not filled in, since
+      // this function is called for every point and should not allocate.
+      WBAssertThrow(global_x_list.size() == 0 || global_x_list.size() == point_list.size(),
+                    "The given global_x_list doesn't have the same size as the point list. This is required.");
+      const bool has_global_x_list = global_x_list.size() > 0;
 
-      double distance = INFINITY;
-      double new_distance = INFINITY;
-      double along_plane_distance = INFINITY;
-      double new_along_plane_distance  = INFINITY;
+      // The closest segment found up to now.
+      SegmentSearch search;
 
       const CoordinateSystem natural_coordinate_system = coordinate_system->natural_coordinate_system();
       const bool bool_cartesian = natural_coordinate_system == cartesian;
@@ -481,20 +961,6 @@ namespace WorldBuilder
                                             bool_cartesian ? check_point_natural[1] : check_point_natural[2],
                                             natural_coordinate_system);
 
-      // The section which is checked.
-      size_t section = 0;
-
-      // The 'horizontal' fraction between the points at the surface.
-      double section_fraction = 0.0;
-
-      // What segment the point on the line is in.
-      unsigned int segment = 0;
-
-      // The 'vertical' fraction, indicates how far in the current segment the
-      // point on the line is.
-      double segment_fraction = 0.0;
-      double total_average_angle = 0.0;
-
       const DepthMethod depth_method = coordinate_system->depth_method();
       WBAssertThrow(depth_method == DepthMethod::none
                     || depth_method == DepthMethod::angle_at_starting_point_with_surface
@@ -504,12 +970,57 @@ namespace WorldBuilder
 
       // loop over all the planes to find out which one is closest to the point.
 
-      for (size_t i_section=0; i_section < point_list.size()-1; ++i_section)
+      // Only search the sections which can contain the point, if an index
+      // is available.
+      const bool use_section_index = section_index != nullptr && section_index->is_initialized();
+      const SectionIndex::Range candidate_sections = use_section_index
+                                                     ? section_index->sections(check_point_surface_2d)
+                                                     : SectionIndex::Range(nullptr, nullptr);
+      const size_t n_candidate_sections = use_section_index ? candidate_sections.size() : point_list.size()-1;
+
+      // The centerline table does not contain the angle which is added at
+      // the begin of every segment for the depth method
+      // angle_at_begin_segment_with_surface, because it depends on the radius.
+      const bool use_centerline_table = centerline_table != nullptr && centerline_table->is_initialized()
+                                        && depth_method != DepthMethod::angle_at_begin_segment_with_surface;
+
+      // Whether a section is searched only depends on the position of the
+      // point at the surface. If the point is close enough to the previous
+      // point that no section can have changed between being searched or
+      // not, only the sections of the previous point need to be searched.
+      const unsigned int *candidate_sections_begin = use_section_index ? candidate_sections.begin() : nullptr;
+      bool use_section_hint = false;
+      if (section_hint != nullptr)
+        {
+          ++section_hint->lookups;
+          if (section_hint->valid && section_hint->candidate_sections == candidate_sections_begin)
+            {
+              const double hint_distance_x = check_point_surface_2d[0] - section_hint->point[0];
+              const double hint_distance_y = check_point_surface_2d[1] - section_hint->point[1];
+              use_section_hint = hint_distance_x * hint_distance_x + hint_distance_y * hint_distance_y
+                                 < section_hint->safe_distance * section_hint->safe_distance;
+            }
+
+          if (use_section_hint)
+            ++section_hint->hits;
+          else
+            section_hint->sections.clear();
+        }
+      const bool record_section_hint = section_hint != nullptr && !use_section_hint;
+      double section_hint_safe_distance = INFINITY;
+      bool found_coinciding_point = false;
+
+      const size_t n_searched_sections = use_section_hint ? section_hint->sections.size() : n_candidate_sections;
+      for (size_t i_candidate = 0; i_candidate < n_searched_sections; ++i_candidate)
         {
+          const size_t i_section = use_section_hint ? section_hint->sections[i_candidate]
+                                   : (use_section_index ? candidate_sections.begin()[i_candidate] : i_candidate);
           const size_t current_section = i_section;
           const size_t next_section = i_section+1;
           // translate to orignal coordinates current and next section
-          const size_t original_current_section = static_cast<size_t>(std::floor(global_x_list[i_section]));
+          const double global_x_current = has_global_x_list ? global_x_list[i_section] : static_cast<double>(i_section);
+          const double global_x_next = has_global_x_list ? global_x_list[i_section+1] : static_cast<double>(i_section+1);
+          const size_t original_current_section = static_cast<size_t>(std::floor(global_x_current));
           const size_t original_next_section = original_current_section + 1;
           // see on what side the line P1P2 reference point is. This is based on the determinant
           const double reference_on_side_of_line = (point_list[next_section][0] - point_list[current_section][0])
@@ -543,14 +1054,26 @@ namespace WorldBuilder
           const double fraction_CPL_P1P2_strict = (P1CPL * P1P2 <= 0 ? -1.0 : 1.0)
                                                   * (1 - (P1P2.norm() - P1CPL.norm()) / P1P2.norm());
 
+          if (record_section_hint)
+            {
+              // The distance along the section can not change more than the
+              // distance the point moves.
+              const double along_section = (P1PC * P1P2) / P1P2.norm();
+              section_hint_safe_distance = std::min(section_hint_safe_distance,
+                                                    std::min(std::fabs(along_section), std::fabs(P1P2.norm() - along_section)));
+            }
+
           // If the point on the line does not lay between point P1 and P2
           // then ignore it. Otherwise continue.
           if (fraction_CPL_P1P2_strict >= 0 && fraction_CPL_P1P2_strict <= 1.0)
             {
+              if (record_section_hint)
+                section_hint->sections.push_back(static_cast<unsigned int>(i_section));
+
               // now figure out where the point is in relation with the user
               // defined coordinates
-              const double fraction_CPL_P1P2 = global_x_list[i_section] - static_cast<int>(global_x_list[i_section])
-                                               + (global_x_list[i_section+1]-global_x_list[i_section]) * fraction_CPL_P1P2_strict;
+              const double fraction_CPL_P1P2 = global_x_current - static_cast<int>(global_x_current)
+                                               + (global_x_next-global_x_current) * fraction_CPL_P1P2_strict;
 
               const Point<2> unit_normal_to_plane_spherical = P1P2 / P1P2.norm();
               const Point<2> closest_point_on_line_plus_normal_to_plane_spherical = closest_point_on_line_2d + 1e-8 * (closest_point_on_line_2d.norm() > 1.0 ? closest_point_on_line_2d.norm() : 1.0) * unit_normal_to_plane_spherical;
@@ -587,15 +1110,16 @@ namespace WorldBuilder
               // if the two points are the same, we don't need to search any further
               if (std::fabs((check_point_cartesian - closest_point_on_line_cartesian).norm()) < 2e-14)
                 {
-                  distance = 0.0;
-                  along_plane_distance = 0.0;
-                  section = current_section;
-                  section_fraction = fraction_CPL_P1P2;
-                  segment = 0;
-                  segment_fraction = 0.0;
-                  total_average_angle = plane_segment_angles[original_current_section][0][0]
-                                        + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][0][0]
-                                                               - plane_segment_angles[original_current_section][0][0]);
+                  search.closest.distance_from_plane = 0.0;
+                  search.closest.distance_along_plane = 0.0;
+                  search.closest.section = current_section;
+                  search.closest.section_fraction = fraction_CPL_P1P2;
+                  search.closest.segment = 0;
+                  search.closest.segment_fraction = 0.0;
+                  search.closest.average_angle = segments.angle_top(original_current_section, 0)
+                                                 + fraction_CPL_P1P2 * (segments.angle_top(original_next_section, 0)
+                                                                        - segments.angle_top(original_current_section, 0));
+                  found_coinciding_point = true;
                   break;
                 }
 
@@ -684,13 +1208,17 @@ namespace WorldBuilder
               WBAssert(!std::isnan(begin_segment[1]),
                        "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
 
-              Point<2> end_segment = begin_segment;
-
+              // The samples of the centerline table for this fraction, if
+              // the table contains the section.
+              const CenterlineTable::Sample centerline_sample = use_centerline_table
+                                                                ? centerline_table->sample(original_current_section, fraction_CPL_P1P2)
+                                                                : CenterlineTable::Sample {nullptr, nullptr, 0};
 
-              double total_length = 0.0;
+              search.end_segment = begin_segment;
+              search.total_length = 0.0;
+              search.average_angle = 0.0;
               double add_angle = 0.0;
-              double average_angle = 0.0;
-              for (unsigned int i_segment = 0; i_segment < plane_segment_lengths[original_current_section].size(); i_segment++)
+              for (unsigned int i_segment = 0; i_segment < segments.n_segments(original_current_section); i_segment++)
                 {
                   const unsigned int current_segment = i_segment;
 
@@ -698,14 +1226,14 @@ namespace WorldBuilder
                   // the depth method is angle_at_begin_segment_with_surface.
                   if (i_segment != 0 && depth_method == DepthMethod::angle_at_begin_segment_with_surface)
                     {
-                      const double add_angle_inner = (begin_segment * end_segment) / (begin_segment.norm() * end_segment.norm());
+                      const double add_angle_inner = (search.begin_segment * search.end_segment) / (search.begin_segment.norm() * search.end_segment.norm());
 
                       WBAssert(!std::isnan(add_angle_inner),
                                "Internal error: The add_angle_inner variable is not a number: " << add_angle_inner
-                               << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
-                               << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
-                               << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
-                               << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
+                               << ". Variables: search.begin_segment = " << search.begin_segment[0] << ":" << search.begin_segment[1]
+                               << ", search.end_segment = " << search.end_segment[0] << ":" << search.end_segment[1]
+                               << ", search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm()) = "
+                               << std::setprecision(32) << search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm())
                                << ".");
 
                       // there could be round of error problems here is the inner part is close to one
@@ -719,283 +1247,365 @@ namespace WorldBuilder
 
                       WBAssert(!std::isnan(add_angle),
                                "Internal error: The add_angle variable is not a number: " << add_angle
-                               << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
-                               << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
-                               << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
-                               << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
-                               << ", std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())) = "
-                               << std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())));
+                               << ". Variables: search.begin_segment = " << search.begin_segment[0] << ":" << search.begin_segment[1]
+                               << ", search.end_segment = " << search.end_segment[0] << ":" << search.end_segment[1]
+                               << ", search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm()) = "
+                               << std::setprecision(32) << search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm())
+                               << ", std::acos(search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm())) = "
+                               << std::acos(search.begin_segment * search.end_segment / (search.begin_segment.norm() * search.end_segment.norm())));
                     }
 
-
-
-
-                  begin_segment = end_segment;
-
-                  WBAssert(!std::isnan(begin_segment[0]),
-                           "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
-                  WBAssert(!std::isnan(begin_segment[1]),
-                           "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
-
-
-                  // This interpolates different properties between P1 and P2 (the
-                  // points of the plane at the surface)
-                  const double degree_90_to_rad = 0.5 * const_pi;
-
-                  WBAssert(plane_segment_angles.size() > original_next_section,
+                  WBAssert(segments.n_sections() > original_next_section,
                            "Error: original_next_section = " << original_next_section
-                           << ", and plane_segment_angles.size() = " << plane_segment_angles.size());
+                           << ", and segments.n_sections() = " << segments.n_sections());
 
 
-                  WBAssert(plane_segment_angles[original_next_section].size() > current_segment,
+                  WBAssert(segments.n_segments(original_next_section) > current_segment,
                            "Error: current_segment = "  << current_segment
-                           << ", and current_segment.size() = " << plane_segment_angles[original_next_section].size());
+                           << ", and current_segment.size() = " << segments.n_segments(original_next_section));
 
-                  const double interpolated_angle_top    = plane_segment_angles[original_current_section][current_segment][0]
-                                                           + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][current_segment][0]
-                                                                                  - plane_segment_angles[original_current_section][current_segment][0])
+                  // This interpolates different properties between P1 and P2 (the
+                  // points of the plane at the surface)
+                  const double interpolated_angle_top    = segments.angle_top(original_current_section, current_segment)
+                                                           + fraction_CPL_P1P2 * (segments.angle_top(original_next_section, current_segment)
+                                                                                  - segments.angle_top(original_current_section, current_segment))
                                                            + add_angle;
 
-                  const double interpolated_angle_bottom = plane_segment_angles[original_current_section][current_segment][1]
-                                                           + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][current_segment][1]
-                                                                                  - plane_segment_angles[original_current_section][current_segment][1])
+                  const double interpolated_angle_bottom = segments.angle_bottom(original_current_section, current_segment)
+                                                           + fraction_CPL_P1P2 * (segments.angle_bottom(original_next_section, current_segment)
+                                                                                  - segments.angle_bottom(original_current_section, current_segment))
                                                            + add_angle;
 
 
-                  double interpolated_segment_length     = plane_segment_lengths[original_current_section][current_segment]
-                                                           + fraction_CPL_P1P2 * (plane_segment_lengths[original_next_section][current_segment]
-                                                                                  - plane_segment_lengths[original_current_section][current_segment]);
-                  WBAssert(!std::isnan(interpolated_angle_top),
-                           "Internal error: The interpolated_angle_top variable is not a number: " << interpolated_angle_top);
-
-                  // We want to know where the end point of this segment is (and
-                  // the start of the next segment). There are two cases which we
-                  // will deal with separately. The first one is if the angle is
-                  // constant. The second one is if the angle changes.
-                  const double difference_in_angle_along_segment = interpolated_angle_top - interpolated_angle_bottom;
-
-                  if (std::fabs(difference_in_angle_along_segment) < 1e-8)
-                    {
-                      // The angle is constant. It is easy find find the end of
-                      // this segment and the distance.
-                      if (std::fabs(interpolated_segment_length) > std::numeric_limits<double>::epsilon())
-                        {
-                          end_segment[0] += interpolated_segment_length * std::sin(degree_90_to_rad - interpolated_angle_top);
-                          end_segment[1] -= interpolated_segment_length * std::cos(degree_90_to_rad - interpolated_angle_top);
-
-                          Point<2> begin_end_segment = end_segment - begin_segment;
-                          Point<2> normal_2d_plane(-begin_end_segment[0],begin_end_segment[1], cartesian);
-                          WBAssert(std::fabs(normal_2d_plane.norm()) > std::numeric_limits<double>::epsilon(), "Internal Error: normal_2d_plane.norm() is zero, which should not happen. "
-                                   << "Extra info: begin_end_segment[0] = " << begin_end_segment[0]
-                                   << ", begin_end_segment[1] = " << begin_end_segment[1]
-                                   << ", end_segment: [" << end_segment[0] << "," << end_segment[1] << "]"
-                                   << ", begin_segment: [" << begin_segment[0] << "," << begin_segment[1] << "]"
-                                  );
-                          normal_2d_plane /= normal_2d_plane.norm();
-
-                          // Now find the distance of a point to this line.
-                          // Based on http://geomalgorithms.com/a02-_lines.html.
-                          const Point<2> BSP_ESP = end_segment - begin_segment;
-                          const Point<2> BSP_CP = check_point_2d - begin_segment;
-
-                          const double c1 = BSP_ESP * BSP_CP;
-                          const double c2 = BSP_ESP * BSP_ESP;
-
-                          if (c1 < 0 || c2 < c1)
-                            {
-                              new_distance = INFINITY;
-                              new_along_plane_distance = INFINITY;
-                            }
-                          else
-                            {
-                              const Point<2> Pb = begin_segment + (c1/c2) * BSP_ESP;
-                              const double side_of_line =  (begin_segment[0] - end_segment[0]) * (check_point_2d[1] - begin_segment[1])
-                                                           - (begin_segment[1] - end_segment[1]) * (check_point_2d[0] - begin_segment[0])
-                                                           < 0 ? -1.0 : 1.0;
-
-                              new_distance = side_of_line * (check_point_2d - Pb).norm();
-                              new_along_plane_distance = (begin_segment - Pb).norm();
-                            }
-
-                        }
-                    }
-                  else
-                    {
-                      // The angle is not constant. This means that we need to
-                      // define a circle. First find the center of the circle.
-                      const double radius_angle_circle = std::fabs(interpolated_segment_length/difference_in_angle_along_segment);
-
-                      WBAssert(!std::isnan(radius_angle_circle),
-                               "Internal error: The radius_angle_circle variable is not a number: " << radius_angle_circle
-                               << ". interpolated_segment_length = " << interpolated_segment_length
-                               << ", difference_in_angle_along_segment = " << difference_in_angle_along_segment);
-
-                      const double cos_angle_top = std::cos(interpolated_angle_top);
-
-                      WBAssert(!std::isnan(cos_angle_top),
-                               "Internal error: The radius_angle_circle variable is not a number: " << cos_angle_top
-                               << ". interpolated_angle_top = " << interpolated_angle_top);
-
-                      Point<2> center_circle(cartesian);
-                      if (std::fabs(interpolated_angle_top - 0.5 * const_pi) < 1e-8)
-                        {
-                          // if interpolated_angle_top is 90 degrees, the tan function
-                          // is undefined (1/0). What we really want in this case is
-                          // set the center to the correct location which is x = the x
-                          //begin point + radius and y = the y begin point.
-                          center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] + radius_angle_circle : begin_segment[0] - radius_angle_circle;
-                          center_circle[1] = begin_segment[1];
-                        }
-                      else if (std::fabs(interpolated_angle_top - 1.5 * const_pi) < 1e-8)
-                        {
-                          // if interpolated_angle_top is 270 degrees, the tan function
-                          // is undefined (-1/0). What we really want in this case is
-                          // set the center to the correct location which is x = the x
-                          //begin point - radius and y = the y begin point.
-                          center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] - radius_angle_circle : begin_segment[0] + radius_angle_circle;
-                          center_circle[1] = begin_segment[1];
-                        }
-                      else
-                        {
-                          double tan_angle_top = std::tan(interpolated_angle_top);
-
-                          WBAssert(!std::isnan(tan_angle_top),
-                                   "Internal error: The tan_angle_top variable is not a number: " << tan_angle_top);
-                          const double center_circle_y = difference_in_angle_along_segment < 0 ?
-                                                         begin_segment[1] - radius_angle_circle * cos_angle_top
-                                                         : begin_segment[1] + radius_angle_circle * cos_angle_top;
+                  double interpolated_segment_length     = segments.length(original_current_section, current_segment)
+                                                           + fraction_CPL_P1P2 * (segments.length(original_next_section, current_segment)
+                                                                                  - segments.length(original_current_section, current_segment));
 
-                          WBAssert(!std::isnan(center_circle_y),
-                                   "Internal error: The center_circle_y variable is not a number: " << center_circle_y
-                                   << ". begin_segment[1] = " << begin_segment[1]
-                                   << ", radius_angle_circle = " << radius_angle_circle
-                                   << ", cos_angle_top = " << cos_angle_top);
-
-                          // to prevent round off errors becomming dominant, we check
-                          // whether center_circle_y - begin_segment[1] should be zero.
-                          // TODO: improve this to some kind of relative difference.
-                          const double CCYBS = center_circle_y - begin_segment[1];
+                  search_segment(check_point_2d, interpolated_angle_top, interpolated_angle_bottom, interpolated_segment_length,
+                                 add_angle, centerline_table, centerline_sample, current_section, fraction_CPL_P1P2,
+                                 current_segment, only_positive, search);
+                }
+            }
+        }
 
-                          WBAssert(!std::isnan(CCYBS),
-                                   "Internal error: The CCYBS variable is not a number: " << CCYBS);
+      if (record_section_hint)
+        {
+          // After a point which coincides with a section, the other sections
+          // have not been checked, so the hint can not be used.
+          section_hint->point = {{check_point_surface_2d[0], check_point_surface_2d[1]}};
+          section_hint->candidate_sections = candidate_sections_begin;
+          section_hint->safe_distance = section_hint_safe_distance
+                                        - 1e-9 * (1 + std::fabs(check_point_surface_2d[0]) + std::fabs(check_point_surface_2d[1]));
+          section_hint->valid = !found_coinciding_point && section_hint->safe_distance > 0;
+        }
 
+      return search.closest;
+    }
 
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes(const Point<3> &check_point,
+                                      const Point<2> &reference_point,
+                                      const std::vector<Point<2> > &point_list,
+                                      const std::vector<std::vector<double> > &plane_segment_lengths,
+                                      const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                                      const double start_radius,
+                                      const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                      const bool only_positive,
+                                      const std::vector<double> &global_x_list)
+    {
+      return distance_point_from_curved_planes_impl(check_point, reference_point, point_list,
+                                                    NestedSegmentTables(plane_segment_lengths, plane_segment_angles),
+                                                    start_radius, coordinate_system, only_positive, global_x_list,
+                                                    nullptr, nullptr, nullptr);
+    }
 
-                          center_circle[0] = begin_segment[0] + tan_angle_top * (CCYBS);
-                          center_circle[1] = center_circle_y;
-                        }
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes(const Point<3> &check_point,
+                                      const Point<2> &reference_point,
+                                      const std::vector<Point<2> > &point_list,
+                                      const SegmentTable &segment_table,
+                                      const double start_radius,
+                                      const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                      const bool only_positive,
+                                      const std::vector<double> &global_x_list,
+                                      const SectionIndex *section_index,
+                                      const CenterlineTable *centerline_table,
+                                      QueryHints::SectionHint *section_hint)
+    {
+      return distance_point_from_curved_planes_impl(check_point, reference_point, point_list,
+                                                    FlatSegmentTables(segment_table),
+                                                    start_radius, coordinate_system, only_positive, global_x_list,
+                                                    section_index, centerline_table, section_hint);
+    }
 
-                      WBAssert(!std::isnan(center_circle[0]) || !std::isnan(center_circle[1]),
-                               "Internal error: The center variable contains not a number: " << center_circle[0] << ":" << center_circle[0]);
-                      WBAssert(std::fabs((begin_segment-center_circle).norm() - std::fabs(radius_angle_circle))
-                               < 1e-8 * std::fabs((begin_segment-center_circle).norm() + std::fabs(radius_angle_circle)),
-                               "Internal error: The center of the circle is not a radius away from the begin point. " << std::endl
-                               << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
-                               << "The begin point is located at " << begin_segment[0] << ":" << begin_segment[1] << std::endl
-                               << "The computed radius is " << std::fabs((begin_segment-center_circle).norm())
-                               << ", and it should be " << radius_angle_circle << ".");
-
-
-                      // Now compute the location of the end of the segment by
-                      // rotating P1 around the center_circle
-                      Point<2> BSPC = begin_segment - center_circle;
-                      const double sin_angle_diff = sin(difference_in_angle_along_segment);
-                      const double cos_angle_diff = cos(difference_in_angle_along_segment);
-                      end_segment[0] = cos_angle_diff * BSPC[0] - sin_angle_diff * BSPC[1] + center_circle[0];
-                      end_segment[1] = sin_angle_diff * BSPC[0] + cos_angle_diff * BSPC[1] + center_circle[1];
-
-
-
-                      WBAssert(std::fabs((end_segment-center_circle).norm() - std::fabs(radius_angle_circle))
-                               < 1e-8 * std::fabs((end_segment-center_circle).norm() + std::fabs(radius_angle_circle)) ,
-                               "Internal error: The center of the circle is not a radius away from the end point. " << std::endl
-                               << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
-                               << "The end point is located at " << end_segment[0] << ":" << end_segment[1] << std::endl
-                               << "The computed radius is " << std::fabs((end_segment-center_circle).norm())
-                               << ", and it should be " << radius_angle_circle << ".");
-
-                      // Now check if the angle of the check point in this circle
-                      // is larger then the angle of P1 and smaller then P1 + angle
-                      // difference. If that is the case then the distance from the
-                      // plane is radius - (center - check_point).norm(). Otherwise
-                      // it is infinity.
-                      // The angle of the check point is computed with the help of
-                      // dot product. But before that we need to adjust the check
-                      // point 2d.
-                      const Point<2> CPCR = check_point_2d - center_circle;
-                      const double CPCR_norm = CPCR.norm();
-
-                      const double dot_product = CPCR * Point<2>(0, radius_angle_circle, cartesian);
-                      // If the x of the check point is larger then the x of center
-                      // the circle, the angle is more than 180 degree, but the dot
-                      // product will decrease instead of increase from 180 degrees.
-                      // To fix this we make a special case for this.
-                      // Furthermore, when the check point is at the same location as
-                      // the center of the circle, we count that point as belonging
-                      // to the top of the top segment (0 degree).
-                      double check_point_angle = std::fabs(CPCR_norm) < std::numeric_limits<double>::epsilon() ? 2.0 * const_pi : (check_point_2d[0] <= center_circle[0]
-                                                 ? std::acos(dot_product/(CPCR_norm * radius_angle_circle))
-                                                 : 2.0 * const_pi - std::acos(dot_product/(CPCR_norm * radius_angle_circle)));
-                      check_point_angle = difference_in_angle_along_segment >= 0 ? const_pi - check_point_angle : 2.0 * const_pi - check_point_angle;
-
-                      // In the case that it is exactly 2 * pi, bring it back to zero
-                      check_point_angle = (std::fabs(check_point_angle - 2 * const_pi) < 1e-14 ? 0 : check_point_angle);
-
-                      if ((difference_in_angle_along_segment > 0 && (check_point_angle <= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
-                           && (check_point_angle >= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12))
-                          || (difference_in_angle_along_segment < 0 && (check_point_angle >= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
-                              && (check_point_angle <= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12)))
-                        {
-                          new_distance = (radius_angle_circle - CPCR_norm) * (difference_in_angle_along_segment < 0 ? 1 : -1);
-                          new_along_plane_distance = (radius_angle_circle * check_point_angle - radius_angle_circle * interpolated_angle_top) * (difference_in_angle_along_segment < 0 ? 1 : -1);
-                        }
+    namespace
+    {
+      /**
+       * The number of points which distance_points_from_curved_planes()
+       * processes together.
+       */
+      const size_t distance_block_size = 8;
 
-                    }
+      /**
+       * Computes the distances of at most distance_block_size points in a
+       * cartesian coordinate system, in which the depth method is none. The
+       * computation is the same as in distance_point_from_curved_planes_impl(),
+       * and uses the same search_segment(), but the loops over the sections
+       * and segments are the outer loops, and every step is done for all
+       * points of the block which are still searching that section, so that
+       * the values which only depend on the section and segment are only
+       * computed once.
+       */
+      void
+      cartesian_distance_block(const size_t n_points,
+                               const double *x,
+                               const double *y,
+                               const double *z,
+                               const double *start_radii,
+                               const Point<2> &reference_point,
+                               const std::vector<Point<2> > &point_list,
+                               const SegmentTable &segment_table,
+                               const bool only_positive,
+                               const std::vector<double> &global_x_list,
+                               const SectionIndex *section_index,
+                               const CenterlineTable *centerline_table,
+                               PointDistanceFromCurvedPlanes *distances)
+      {
+        const size_t n = distance_block_size;
+        const bool has_global_x_list = global_x_list.size() > 0;
+        const bool use_section_index = section_index != nullptr && section_index->is_initialized();
+        const bool use_centerline_table = centerline_table != nullptr && centerline_table->is_initialized();
+        const size_t n_segments = segment_table.n_segments();
+
+        // The points which are not used are filled with the first point, and
+        // are finished from the start.
+        double check_x[n], check_y[n], check_z[n], start_radius[n];
+        bool finished[n];
+        for (size_t p = 0; p < n; ++p)
+          {
+            const size_t i_point = p < n_points ? p : 0;
+            check_x[p] = x[i_point];
+            check_y[p] = y[i_point];
+            check_z[p] = z[i_point];
+            start_radius[p] = start_radii[i_point];
+            finished[p] = p >= n_points;
+          }
+
+        // The closest segment and the search through the segments of the
+        // current section of every point.
+        SegmentSearch search[n];
+
+        // Every point searches the sections which the index returns for it
+        // in increasing order, so the block searches the sections from the
+        // first to the last one which any point needs, and keeps track of
+        // the next candidate section of every point.
+        const unsigned int *next_candidate[n];
+        const unsigned int *end_candidate[n];
+        size_t first_section = 0;
+        size_t end_section = point_list.size() - 1;
+        if (use_section_index)
+          {
+            first_section = point_list.size();
+            end_section = 0;
+            for (size_t p = 0; p < n; ++p)
+              {
+                const SectionIndex::Range candidate_sections = section_index->sections(Point<2>(check_x[p], check_y[p], cartesian));
+                next_candidate[p] = candidate_sections.begin();
+                end_candidate[p] = candidate_sections.end();
+                if (!finished[p] && candidate_sections.size() > 0)
+                  {
+                    first_section = std::min(first_section, static_cast<size_t>(candidate_sections.begin()[0]));
+                    end_section = std::max(end_section, static_cast<size_t>(candidate_sections.end()[-1]) + 1);
+                  }
+              }
+          }
+
+        for (size_t current_section = first_section; current_section < end_section; ++current_section)
+          {
+            bool active[n];
+            bool any_active = false;
+            for (size_t p = 0; p < n; ++p)
+              {
+                active[p] = !finished[p];
+                if (use_section_index)
+                  {
+                    const bool is_candidate = next_candidate[p] != end_candidate[p] && *next_candidate[p] == current_section;
+                    next_candidate[p] += is_candidate ? 1 : 0;
+                    active[p] = active[p] && is_candidate;
+                  }
+                any_active = any_active || active[p];
+              }
+            if (!any_active)
+              continue;
+
+            const size_t next_section = current_section + 1;
+            const double global_x_current = has_global_x_list ? global_x_list[current_section] : static_cast<double>(current_section);
+            const double global_x_next = has_global_x_list ? global_x_list[next_section] : static_cast<double>(next_section);
+            const size_t original_current_section = static_cast<size_t>(std::floor(global_x_current));
+            const size_t original_next_section = original_current_section + 1;
+            const double reference_on_side_of_line = (point_list[next_section][0] - point_list[current_section][0])
+                                                     * (reference_point[1] - point_list[current_section][1])
+                                                     - (point_list[next_section][1] - point_list[current_section][1])
+                                                     * (reference_point[0] - point_list[current_section][0])
+                                                     < 0 ? 1 : -1;
+
+            const Point<2> P1(point_list[current_section]);
+            const Point<2> P2(point_list[next_section]);
+            const Point<2> P1P2 = P2 - P1;
+            const Point<2> unit_normal_to_plane = P1P2 / P1P2.norm();
+
+            // Find where the points are along the section, and compute their
+            // position in the plane perpendicular to the section.
+            double fraction_CPL_P1P2[n], check_point_2d_x[n], check_point_2d_y[n];
+            any_active = false;
+            for (size_t p = 0; p < n; ++p)
+              {
+                if (!active[p])
+                  continue;
+
+                const Point<2> P1PC = Point<2>(check_x[p], check_y[p], cartesian) - P1;
+                const Point<2> closest_point_on_line_2d = P1 + ((P1PC * P1P2) / (P1P2 * P1P2)) * P1P2;
+                const Point<2> P1CPL = closest_point_on_line_2d - P1;
+                const double fraction_CPL_P1P2_strict = (P1CPL * P1P2 <= 0 ? -1.0 : 1.0)
+                                                        * (1 - (P1P2.norm() - P1CPL.norm()) / P1P2.norm());
+                if (!(fraction_CPL_P1P2_strict >= 0 && fraction_CPL_P1P2_strict <= 1.0))
+                  {
+                    active[p] = false;
+                    continue;
+                  }
+
+                fraction_CPL_P1P2[p] = global_x_current - static_cast<int>(global_x_current)
+                                       + (global_x_next-global_x_current) * fraction_CPL_P1P2_strict;
+
+                const Point<2> closest_point_on_line_plus_normal_to_plane_2d = closest_point_on_line_2d + 1e-8 * (closest_point_on_line_2d.norm() > 1.0 ? closest_point_on_line_2d.norm() : 1.0) * unit_normal_to_plane;
+                const Point<3> check_point(check_x[p], check_y[p], check_z[p], cartesian);
+                const Point<3> closest_point_on_line(closest_point_on_line_2d[0], closest_point_on_line_2d[1], start_radius[p], cartesian);
+                const Point<3> closest_point_on_line_bottom(closest_point_on_line_2d[0], closest_point_on_line_2d[1], 0, cartesian);
+                const Point<3> closest_point_on_line_plus_normal_to_plane(closest_point_on_line_plus_normal_to_plane_2d[0],
+                                                                          closest_point_on_line_plus_normal_to_plane_2d[1],
+                                                                          start_radius[p], cartesian);
+
+                // if the two points are the same, the point does not need to
+                // search any further
+                if (std::fabs((check_point - closest_point_on_line).norm()) < 2e-14)
+                  {
+                    PointDistanceFromCurvedPlanes &closest = search[p].closest;
+                    closest.distance_from_plane = 0.0;
+                    closest.distance_along_plane = 0.0;
+                    closest.section = current_section;
+                    closest.section_fraction = fraction_CPL_P1P2[p];
+                    closest.segment = 0;
+                    closest.segment_fraction = 0.0;
+                    closest.average_angle = segment_table(SegmentTable::angle_top, original_current_section, 0)
+                                            + fraction_CPL_P1P2[p] * (segment_table(SegmentTable::angle_top, original_next_section, 0)
+                                                                      - segment_table(SegmentTable::angle_top, original_current_section, 0));
+                    finished[p] = true;
+                    active[p] = false;
+                    continue;
+                  }
+
+                Point<3> normal_to_plane = closest_point_on_line_plus_normal_to_plane - closest_point_on_line;
+                normal_to_plane = normal_to_plane / normal_to_plane.norm();
+
+                Point<3> y_axis = closest_point_on_line - closest_point_on_line_bottom;
+                y_axis = y_axis / y_axis.norm();
+
+                const double vx = y_axis[0];
+                const double vy = y_axis[1];
+                const double vz = y_axis[2];
+                const double ux = normal_to_plane[0];
+                const double uy = normal_to_plane[1];
+                const double uz = normal_to_plane[2];
+
+                Point<3> x_axis(ux*ux*vx + ux*uy*vy - uz*vy + uy*uz*vz + uy*vz,
+                                uy*ux*vx + uz*vx + uy*uy*vy + uy*uz*vz - ux*vz,
+                                uz*ux*vx - uy*vx + uz*uy*vy + ux*vy + uz*uz*vz,
+                                cartesian);
+                x_axis = x_axis *(reference_on_side_of_line / x_axis.norm());
+
+                check_point_2d_x[p] = x_axis * (check_point - closest_point_on_line_bottom);
+                check_point_2d_y[p] = y_axis * (check_point - closest_point_on_line_bottom);
+                search[p].end_segment = Point<2>(x_axis * (closest_point_on_line - closest_point_on_line_bottom),
+                                                 y_axis * (closest_point_on_line - closest_point_on_line_bottom),
+                                                 cartesian);
+                search[p].total_length = 0.0;
+                search[p].average_angle = 0.0;
+                any_active = true;
+              }
+            if (!any_active)
+              continue;
+
+            CenterlineTable::Sample centerline_sample[n];
+            for (size_t p = 0; p < n; ++p)
+              centerline_sample[p] = use_centerline_table && active[p]
+                                     ? centerline_table->sample(original_current_section, fraction_CPL_P1P2[p])
+                                     : CenterlineTable::Sample {nullptr, nullptr, 0};
+
+            for (size_t i_segment = 0; i_segment < n_segments; ++i_segment)
+              {
+                const double angle_top_current = segment_table(SegmentTable::angle_top, original_current_section, i_segment);
+                const double angle_top_next = segment_table(SegmentTable::angle_top, original_next_section, i_segment);
+                const double angle_bottom_current = segment_table(SegmentTable::angle_bottom, original_current_section, i_segment);
+                const double angle_bottom_next = segment_table(SegmentTable::angle_bottom, original_next_section, i_segment);
+                const double length_current = segment_table(SegmentTable::length, original_current_section, i_segment);
+                const double length_next = segment_table(SegmentTable::length, original_next_section, i_segment);
+
+                for (size_t p = 0; p < n; ++p)
+                  {
+                    if (!active[p])
+                      continue;
+
+                    const double fraction = fraction_CPL_P1P2[p];
+                    search_segment(Point<2>(check_point_2d_x[p], check_point_2d_y[p], cartesian),
+                                   angle_top_current + fraction * (angle_top_next - angle_top_current),
+                                   angle_bottom_current + fraction * (angle_bottom_next - angle_bottom_current),
+                                   length_current + fraction * (length_next - length_current),
+                                   0.0, centerline_table, centerline_sample[p], current_section, fraction,
+                                   i_segment, only_positive, search[p]);
+                  }
+              }
+          }
+
+        for (size_t p = 0; p < n_points; ++p)
+          distances[p] = search[p].closest;
+      }
+    }
 
-                  // Now we need to see whether we need to update the information
-                  // based on whether this segment is the closest one to the point
-                  // up to now. To do this we first look whether the point falls
-                  // within the bound of the segment and if it is actually closer.
-                  // TODO: find out whether the fabs() are needed.
-                  if (new_along_plane_distance >= -1e-10 &&
-                      new_along_plane_distance <= std::fabs(interpolated_segment_length) &&
-                      std::fabs(new_distance) < std::fabs(distance))
-                    {
-                      // There are two specific cases we are concerned with. The
-                      // first case is that we want to have both the positive and
-                      // negative distances (above and below the line). The second
-                      // case is that we only want positive distances.
-                      distance = only_positive ? std::fabs(new_distance) : new_distance;
-                      along_plane_distance = new_along_plane_distance + total_length;
-                      section = current_section;
-                      section_fraction = fraction_CPL_P1P2;
-                      segment = i_segment;
-                      segment_fraction = new_along_plane_distance / interpolated_segment_length;
-                      total_average_angle = (average_angle * total_length
-                                             + 0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * new_along_plane_distance);
-                      total_average_angle = (std::fabs(total_average_angle) < std::numeric_limits<double>::epsilon() ? 0 : total_average_angle /
-                                             (total_length + new_along_plane_distance));
-                    }
+    void
+    distance_points_from_curved_planes(const size_t n_points,
+                                       const double *x,
+                                       const double *y,
+                                       const double *z,
+                                       const double *start_radii,
+                                       const Point<2> &reference_point,
+                                       const std::vector<Point<2> > &point_list,
+                                       const SegmentTable &segment_table,
+                                       const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                       const bool only_positive,
+                                       const std::vector<double> &global_x_list,
+                                       const SectionIndex *section_index,
+                                       const CenterlineTable *centerline_table,
+                                       PointDistanceFromCurvedPlanes *distances)
+    {
+      WBAssertThrow(global_x_list.size() == 0 || global_x_list.size() == point_list.size(),
+                    "The given global_x_list doesn't have the same size as the point list. This is required.");
 
-                  // increase average angle
-                  average_angle = (average_angle * total_length +
-                                   0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * interpolated_segment_length);
-                  average_angle = (std::fabs(average_angle) < std::numeric_limits<double>::epsilon() ? 0 : average_angle /
-                                   (total_length + interpolated_segment_length));
-                  // increase the total length for the next segment.
-                  total_length += interpolated_segment_length;
-                }
-            }
+      if (coordinate_system->natural_coordinate_system() != cartesian
+          || coordinate_system->depth_method() != DepthMethod::none)
+        {
+          for (size_t i_point = 0; i_point < n_points; ++i_point)
+            distances[i_point] = distance_point_from_curved_planes(Point<3>(x[i_point], y[i_point], z[i_point], cartesian),
+                                                                   reference_point, point_list, segment_table,
+                                                                   start_radii[i_point], coordinate_system, only_positive,
+                                                                   global_x_list, section_index, centerline_table);
+          return;
         }
-      std::map<std::string, double> return_values;
-      return_values["distanceFromPlane"] = distance;
-      return_values["distanceAlongPlane"] = along_plane_distance;
-      return_values["sectionFraction"] = section_fraction;
-      return_values["segmentFraction"] = segment_fraction;
-      return_values["section"] = static_cast<double>(section);
-      return_values["segment"] = segment;
-      return_values["averageAngle"] = total_average_angle;
-      return return_values;
+
+      for (size_t first_point = 0; first_point < n_points; first_point += distance_block_size)
+        cartesian_distance_block(std::min(distance_block_size, n_points - first_point),
+                                 x + first_point, y + first_point, z + first_point, start_radii + first_point,
+                                 reference_point, point_list, segment_table, only_positive, global_x_list,
+                                 section_index, centerline_table, distances + first_point);
     }
 
     void interpolation::set_points(const std::vector<double> &x,
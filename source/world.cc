@@ -17,6 +17,9 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
 #include <sstream>
 
 #include "rapidjson/pointer.h"
@@ -28,6 +31,7 @@
 #include <world_builder/point.h>
 #include <world_builder/nan.h>
 #include <world_builder/parameters.h>
+#include <world_builder/snapshot.h>
 #include <world_builder/coordinate_systems/interface.h>
 #include <world_builder/types/interface.h>
 
@@ -47,17 +51,56 @@ namespace WorldBuilder
 
   using namespace Utilities;
 
-  World::World(std::string filename, bool has_output_dir, std::string output_dir)
+  World::World(std::string filename, bool has_output_dir, std::string output_dir, std::string trace_file,
+               bool compact)
     :
     parameters(*this),
+    reverse_evaluation(false),
     surface_coord_conversions(invalid),
     dim(NaN::ISNAN)
   {
-    this->declare_entries(parameters);
+    if (trace_file.empty() && std::getenv("WB_TRACE_FILE") != nullptr)
+      trace_file = std::getenv("WB_TRACE_FILE");
 
-    parameters.initialize(filename, has_output_dir, output_dir);
+    if (!trace_file.empty())
+      trace.enable(trace_file);
 
-    this->parse_entries(parameters);
+    if (!compact && std::getenv("WB_COMPACT") != nullptr)
+      compact = std::string(std::getenv("WB_COMPACT")) != "0";
+
+    {
+      Trace::Scope scope(trace, "World::World", "world");
+      scope.add_argument("file", filename);
+
+      if (Snapshot::is_snapshot(filename))
+        {
+          Trace::Scope snapshot_scope(trace, "World::load_snapshot", "world");
+          Snapshot snapshot(this, filename);
+          this->serialize(snapshot);
+          snapshot.finish();
+        }
+      else
+        {
+          {
+            Trace::Scope declare_scope(trace, "World::declare_entries", "world");
+            this->declare_entries(parameters);
+          }
+
+          parameters.initialize(filename, has_output_dir, output_dir);
+
+          this->parse_entries(parameters);
+
+          if (compact)
+            parameters.release_parse_data();
+        }
+    }
+
+    std::vector<std::pair<double,double> > feature_ranges;
+    for (auto &feature : parameters.features)
+      feature_ranges.push_back(feature->depth_range());
+    feature_index.build(feature_ranges);
+
+    trace.write();
   }
 
   World::~World()
@@ -111,6 +154,8 @@ namespace WorldBuilder
   {
     using namespace rapidjson;
 
+    Trace::Scope scope(trace, "World::parse_entries", "world");
+
     /**
      * First load the major version number in the file and check the major
      * version number of the program.
@@ -195,26 +240,21 @@ namespace WorldBuilder
     {
       for (unsigned int i = 0; i < prm.features.size(); ++i)
         {
+          Trace::Scope feature_scope(trace, "Features::Interface::parse_entries", "features");
           prm.enter_subsection(std::to_string(i));
           {
             prm.features[i]->parse_entries(prm);
           }
           prm.leave_subsection();
+          feature_scope.add_argument("name", prm.features[i]->get_name());
         }
     }
     prm.leave_subsection();
   }
 
-  double
-  World::temperature(const std::array<double,2> &point,
-                     const double depth,
-                     const double gravity_norm) const
+  std::array<double,3>
+  World::cross_section_to_cartesian(const std::array<double,2> &point) const
   {
-    // turn it into a 3d coordinate and call the 3d temperature function
-    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
-                  "variable in the world builder file has been set. Dim is "
-                  << dim << ".");
-
     const CoordinateSystem coordinate_system = this->parameters.coordinate_system->natural_coordinate_system();
 
     Point<2> point_natural(point[0], point[1],coordinate_system);
@@ -238,10 +278,20 @@ namespace WorldBuilder
         coord_3d[2] = point_natural[1];
       }
 
+    return this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+  }
 
-    std::array<double, 3> point_3d_cartesian = this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+  double
+  World::temperature(const std::array<double,2> &point,
+                     const double depth,
+                     const double gravity_norm) const
+  {
+    // turn it into a 3d coordinate and call the 3d temperature function
+    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
+                  "variable in the world builder file has been set. Dim is "
+                  << dim << ".");
 
-    return temperature(point_3d_cartesian, depth, gravity_norm);
+    return temperature(cross_section_to_cartesian(point), depth, gravity_norm);
   }
 
   double
@@ -259,9 +309,13 @@ namespace WorldBuilder
                          std::exp(((thermal_expansion_coefficient * gravity_norm) /
                                    specific_heat) * depth);
 
-
-    for (auto &&it : parameters.features)
+    const size_t first_feature = first_temperature_feature(point, depth);
+    for (const unsigned int i_feature : active_features(depth))
       {
+        if (i_feature < first_feature)
+          continue;
+
+        const auto &it = parameters.features[i_feature];
         temperature = it->temperature(point,depth,gravity_norm,temperature);
 
         WBAssert(!std::isnan(temperature), "Temparture is not a number: " << temperature
@@ -286,32 +340,7 @@ namespace WorldBuilder
                   "variable in the world builder file has been set. Dim is "
                   << dim << ".");
 
-    const CoordinateSystem coordinate_system = this->parameters.coordinate_system->natural_coordinate_system();
-
-    Point<2> point_natural(point[0], point[1],coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        point_natural[1] = std::sqrt(point[0]*point[0]+point[1]*point[1]);
-        point_natural[0] = std::atan2(point[1],point[0]);
-      }
-
-    Point<3> coord_3d(coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        coord_3d[0] = point_natural[1];
-        coord_3d[1] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[2] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-      }
-    else
-      {
-        coord_3d[0] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[1] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-        coord_3d[2] = point_natural[1];
-      }
-
-    std::array<double, 3> point_3d_cartesian = this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
-
-    return composition(point_3d_cartesian, depth, composition_number);
+    return composition(cross_section_to_cartesian(point), depth, composition_number);
   }
 
   double
@@ -322,8 +351,13 @@ namespace WorldBuilder
     // We receive the cartesian points from the user.
     Point<3> point(point_,cartesian);
     double composition = 0;
-    for (auto &&it : parameters.features)
+    const size_t first_feature = first_composition_feature(point, depth, composition_number);
+    for (const unsigned int i_feature : active_features(depth))
       {
+        if (i_feature < first_feature)
+          continue;
+
+        const auto &it = parameters.features[i_feature];
         composition = it->composition(point,depth,composition_number, composition);
 
         WBAssert(!std::isnan(composition), "Composition is not a number: " << composition
@@ -339,5 +373,484 @@ namespace WorldBuilder
     return composition;
   }
 
-}
+  const std::vector<unsigned int> &
+  World::active_features(const double depth) const
+  {
+    return profiler.is_enabled() ? feature_index.all() : feature_index.active(depth);
+  }
+
+  size_t
+  World::first_temperature_feature(const Point<3> &point, const double depth) const
+  {
+    if (!reverse_evaluation || profiler.is_enabled())
+      return 0;
+
+    // Whether the first feature replaces the value does not matter, since
+    // it is evaluated anyway.
+    const std::vector<unsigned int> &features = active_features(depth);
+    for (auto i_feature = features.rbegin(); i_feature != features.rend() && *i_feature > 0; ++i_feature)
+      if (parameters.features[*i_feature]->replaces_temperature(point, depth))
+        return *i_feature;
+
+    return 0;
+  }
+
+  size_t
+  World::first_composition_feature(const Point<3> &point, const double depth,
+                                   const unsigned int composition_number) const
+  {
+    if (!reverse_evaluation || profiler.is_enabled())
+      return 0;
+
+    // Whether the first feature replaces the value does not matter, since
+    // it is evaluated anyway.
+    const std::vector<unsigned int> &features = active_features(depth);
+    for (auto i_feature = features.rbegin(); i_feature != features.rend() && *i_feature > 0; ++i_feature)
+      if (parameters.features[*i_feature]->replaces_composition(point, depth, composition_number))
+        return *i_feature;
+
+    return 0;
+  }
+
+  namespace
+  {
+    /**
+     * The number of points of which the batched functions of the world
+     * convert the coordinates or store the values of one composition at the
+     * same time.
+     */
+    const size_t batch_chunk_size = 256;
+
+    /**
+     * Calls evaluate(n, x, y, z, depth, gravity_norm, values) for the points
+     * i for which selected(i) is true, which are gathered in chunks, after
+     * which the values are copied back. When all points are selected, they
+     * are passed directly, and when none are, evaluate is not called. The
+     * gravity norm may be a null pointer.
+     */
+    template<class Selected, class Evaluate>
+    void
+    evaluate_selected(const size_t n_points,
+                      const Selected &selected,
+                      const double *x,
+                      const double *y,
+                      const double *z,
+                      const double *depth,
+                      const double *gravity_norm,
+                      double *values,
+                      const Evaluate &evaluate)
+    {
+      size_t n_selected = 0;
+      for (size_t i = 0; i < n_points; ++i)
+        if (selected(i))
+          ++n_selected;
+
+      if (n_selected == 0)
+        return;
+
+      if (n_selected == n_points)
+        {
+          evaluate(n_points, x, y, z, depth, gravity_norm, values);
+          return;
+        }
+
+      size_t indices[batch_chunk_size];
+      double x_chunk[batch_chunk_size], y_chunk[batch_chunk_size], z_chunk[batch_chunk_size];
+      double depth_chunk[batch_chunk_size], gravity_norm_chunk[batch_chunk_size], values_chunk[batch_chunk_size];
+      size_t n_chunk_points = 0;
+      for (size_t i = 0; i <= n_points; ++i)
+        {
+          if (i < n_points && selected(i))
+            indices[n_chunk_points++] = i;
+
+          if (n_chunk_points == batch_chunk_size || (i == n_points && n_chunk_points > 0))
+            {
+              for (size_t j = 0; j < n_chunk_points; ++j)
+                {
+                  x_chunk[j] = x[indices[j]];
+                  y_chunk[j] = y[indices[j]];
+                  z_chunk[j] = z[indices[j]];
+                  depth_chunk[j] = depth[indices[j]];
+                  gravity_norm_chunk[j] = gravity_norm != nullptr ? gravity_norm[indices[j]] : 0;
+                  values_chunk[j] = values[indices[j]];
+                }
+              evaluate(n_chunk_points, x_chunk, y_chunk, z_chunk, depth_chunk, gravity_norm_chunk, values_chunk);
+              for (size_t j = 0; j < n_chunk_points; ++j)
+                values[indices[j]] = values_chunk[j];
+              n_chunk_points = 0;
+            }
+        }
+    }
+  }
+
+  void
+  World::cross_section_to_cartesian(const size_t n_points,
+                                    const double *x,
+                                    const double *z,
+                                    double *x_3d,
+                                    double *y_3d,
+                                    double *z_3d) const
+  {
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const std::array<double,2> point = {{x[i],z[i]}};
+        const std::array<double,3> point_3d_cartesian = cross_section_to_cartesian(point);
+        x_3d[i] = point_3d_cartesian[0];
+        y_3d[i] = point_3d_cartesian[1];
+        z_3d[i] = point_3d_cartesian[2];
+      }
+  }
+
+  void
+  World::temperatures(const size_t n_points,
+                      const double *x,
+                      const double *z,
+                      const double *depth,
+                      const double *gravity_norm,
+                      double *temperatures) const
+  {
+    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
+                  "variable in the world builder file has been set. Dim is "
+                  << dim << ".");
+
+    if (spatial_order.is_enabled())
+      {
+        // All the points are converted at once, so that they are ordered
+        // together.
+        std::vector<double> x_3d(n_points), y_3d(n_points), z_3d(n_points);
+        cross_section_to_cartesian(n_points, x, z, x_3d.data(), y_3d.data(), z_3d.data());
+        this->temperatures(n_points, x_3d.data(), y_3d.data(), z_3d.data(), depth, gravity_norm, temperatures);
+        return;
+      }
+
+    double x_3d[batch_chunk_size], y_3d[batch_chunk_size], z_3d[batch_chunk_size];
+    for (size_t first = 0; first < n_points; first += batch_chunk_size)
+      {
+        const size_t n_chunk_points = std::min(batch_chunk_size, n_points - first);
+        cross_section_to_cartesian(n_chunk_points, x + first, z + first, x_3d, y_3d, z_3d);
+        this->temperatures(n_chunk_points, x_3d, y_3d, z_3d, depth + first, gravity_norm + first, temperatures + first);
+      }
+  }
+
+  void
+  World::temperatures(const size_t n_points,
+                      const double *x,
+                      const double *y,
+                      const double *z,
+                      const double *depth,
+                      const double *gravity_norm,
+                      double *temperatures) const
+  {
+    if (!spatial_order.is_enabled() || n_points <= batch_chunk_size)
+      {
+        temperatures_in_given_order(n_points, x, y, z, depth, gravity_norm, temperatures);
+        return;
+      }
+
+    std::vector<size_t> permutation;
+    spatial_order.compute_permutation(n_points, x, y, z, *parameters.coordinate_system, permutation);
+
+    std::vector<double> ordered(6 * n_points);
+    double *ordered_x = ordered.data();
+    double *ordered_y = ordered_x + n_points;
+    double *ordered_z = ordered_y + n_points;
+    double *ordered_depth = ordered_z + n_points;
+    double *ordered_gravity_norm = ordered_depth + n_points;
+    double *ordered_temperatures = ordered_gravity_norm + n_points;
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const size_t point = permutation[i];
+        ordered_x[i] = x[point];
+        ordered_y[i] = y[point];
+        ordered_z[i] = z[point];
+        ordered_depth[i] = depth[point];
+        ordered_gravity_norm[i] = gravity_norm[point];
+      }
+
+    temperatures_in_given_order(n_points, ordered_x, ordered_y, ordered_z, ordered_depth, ordered_gravity_norm,
+                                ordered_temperatures);
+
+    for (size_t i = 0; i < n_points; ++i)
+      temperatures[permutation[i]] = ordered_temperatures[i];
+  }
+
+  void
+  World::temperatures_in_given_order(const size_t n_points,
+                                     const double *x,
+                                     const double *y,
+                                     const double *z,
+                                     const double *depth,
+                                     const double *gravity_norm,
+                                     double *temperatures) const
+  {
+    // The features are asked for the temperatures of all the points at
+    // once, so that they can process the points together. This gives the
+    // same results as calling temperature() for every point.
+    for (size_t i = 0; i < n_points; ++i)
+      temperatures[i] = potential_mantle_temperature *
+                        std::exp(((thermal_expansion_coefficient * gravity_norm[i]) /
+                                  specific_heat) * depth[i]);
+
+    if (profiler.is_enabled())
+      {
+        for (auto &&it : parameters.features)
+          it->temperatures(n_points, x, y, z, depth, gravity_norm, temperatures);
+      }
+    else
+      {
+        // Every feature only gets the points in its depth range for which no
+        // later feature replaces the temperature.
+        std::vector<size_t> first_feature;
+        if (reverse_evaluation && parameters.features.size() > 1)
+          {
+            first_feature.resize(n_points);
+            for (size_t i = 0; i < n_points; ++i)
+              first_feature[i] = first_temperature_feature(Point<3>(x[i], y[i], z[i], cartesian), depth[i]);
+          }
+
+        for (size_t i_feature = 0; i_feature < parameters.features.size(); ++i_feature)
+          {
+            const std::pair<double,double> range = parameters.features[i_feature]->depth_range();
+            evaluate_selected(n_points, [&](const size_t i)
+            {
+              return depth[i] >= range.first && depth[i] <= range.second
+                     && (first_feature.empty() || first_feature[i] <= i_feature);
+            },
+            x, y, z, depth, gravity_norm, temperatures,
+            [&](const size_t n, const double *x_, const double *y_, const double *z_,
+                const double *depth_, const double *gravity_norm_, double *temperatures_)
+            {
+              parameters.features[i_feature]->temperatures(n, x_, y_, z_, depth_, gravity_norm_, temperatures_);
+            });
+          }
+      }
+
+    if (force_surface_temperature == true)
+      for (size_t i = 0; i < n_points; ++i)
+        if (std::fabs(depth[i]) < 2.0 * std::numeric_limits<double>::epsilon())
+          temperatures[i] = this->surface_temperature;
+  }
+
+  void
+  World::compositions(const size_t n_points,
+                      const double *x,
+                      const double *z,
+                      const double *depth,
+                      const unsigned int n_compositions,
+                      double *compositions) const
+  {
+    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
+                  "variable in the world builder file has been set. Dim is "
+                  << dim << ".");
+
+    if (spatial_order.is_enabled())
+      {
+        std::vector<double> x_3d(n_points), y_3d(n_points), z_3d(n_points);
+        cross_section_to_cartesian(n_points, x, z, x_3d.data(), y_3d.data(), z_3d.data());
+        this->compositions(n_points, x_3d.data(), y_3d.data(), z_3d.data(), depth, n_compositions, compositions);
+        return;
+      }
+
+    double x_3d[batch_chunk_size], y_3d[batch_chunk_size], z_3d[batch_chunk_size];
+    for (size_t first = 0; first < n_points; first += batch_chunk_size)
+      {
+        const size_t n_chunk_points = std::min(batch_chunk_size, n_points - first);
+        cross_section_to_cartesian(n_chunk_points, x + first, z + first, x_3d, y_3d, z_3d);
+        this->compositions(n_chunk_points, x_3d, y_3d, z_3d, depth + first, n_compositions,
+                           compositions + first * n_compositions);
+      }
+  }
+
+  void
+  World::compositions(const size_t n_points,
+                      const double *x,
+                      const double *y,
+                      const double *z,
+                      const double *depth,
+                      const unsigned int n_compositions,
+                      double *compositions) const
+  {
+    if (!spatial_order.is_enabled() || n_points <= batch_chunk_size)
+      {
+        compositions_in_given_order(n_points, x, y, z, depth, n_compositions, compositions);
+        return;
+      }
+
+    std::vector<size_t> permutation;
+    spatial_order.compute_permutation(n_points, x, y, z, *parameters.coordinate_system, permutation);
+
+    std::vector<double> ordered((4 + n_compositions) * n_points);
+    double *ordered_x = ordered.data();
+    double *ordered_y = ordered_x + n_points;
+    double *ordered_z = ordered_y + n_points;
+    double *ordered_depth = ordered_z + n_points;
+    double *ordered_compositions = ordered_depth + n_points;
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const size_t point = permutation[i];
+        ordered_x[i] = x[point];
+        ordered_y[i] = y[point];
+        ordered_z[i] = z[point];
+        ordered_depth[i] = depth[point];
+      }
+
+    compositions_in_given_order(n_points, ordered_x, ordered_y, ordered_z, ordered_depth, n_compositions,
+                                ordered_compositions);
+
+    for (size_t i = 0; i < n_points; ++i)
+      std::copy(ordered_compositions + i * n_compositions, ordered_compositions + (i + 1) * n_compositions,
+                compositions + permutation[i] * n_compositions);
+  }
+
+  void
+  World::compositions_in_given_order(const size_t n_points,
+                                     const double *x,
+                                     const double *y,
+                                     const double *z,
+                                     const double *depth,
+                                     const unsigned int n_compositions,
+                                     double *compositions) const
+  {
+    // Like for the temperatures, the features are asked for a composition
+    // of a chunk of points at once, which is then copied into the
+    // interleaved output.
+    const bool use_first_feature = reverse_evaluation && parameters.features.size() > 1;
+    double values[batch_chunk_size];
+    size_t first_feature[batch_chunk_size];
+    for (size_t first = 0; first < n_points; first += batch_chunk_size)
+      {
+        const size_t n_chunk_points = std::min(batch_chunk_size, n_points - first);
+        for (unsigned int c = 0; c < n_compositions; ++c)
+          {
+            std::fill(values, values + n_chunk_points, 0.0);
+            if (profiler.is_enabled())
+              {
+                for (auto &&it : parameters.features)
+                  it->compositions(n_chunk_points, x + first, y + first, z + first, depth + first, c, values);
+              }
+            else
+              {
+                if (use_first_feature)
+                  for (size_t i = 0; i < n_chunk_points; ++i)
+                    first_feature[i] = first_composition_feature(Point<3>(x[first + i], y[first + i], z[first + i], cartesian),
+                                                                 depth[first + i], c);
+
+                for (size_t i_feature = 0; i_feature < parameters.features.size(); ++i_feature)
+                  {
+                    const std::pair<double,double> range = parameters.features[i_feature]->depth_range();
+                    evaluate_selected(n_chunk_points, [&](const size_t i)
+                    {
+                      return depth[first + i] >= range.first && depth[first + i] <= range.second
+                             && (!use_first_feature || first_feature[i] <= i_feature);
+                    },
+                    x + first, y + first, z + first, depth + first, nullptr, values,
+                    [&](const size_t n, const double *x_, const double *y_, const double *z_,
+                        const double *depth_, const double *, double *values_)
+                    {
+                      parameters.features[i_feature]->compositions(n, x_, y_, z_, depth_, c, values_);
+                    });
+                  }
+              }
+
+            for (size_t i = 0; i < n_chunk_points; ++i)
+              compositions[(first + i) * n_compositions + c] = values[i];
+          }
+      }
+  }
+
+  std::string
+  World::performance_report() const
+  {
+    return profiler.report();
+  }
+
+  namespace
+  {
+    /**
+     * Returns the memory used by a json document in bytes, which is the
+     * memory reserved by its allocator and its parse stack.
+     */
+    std::size_t
+    document_memory_usage(const rapidjson::Document &document)
+    {
+      // The allocator is not changed, but rapidjson does not provide a
+      // const version of GetAllocator().
+      return const_cast<rapidjson::Document &>(document).GetAllocator().Capacity()
+             + document.GetStackCapacity();
+    }
+  }
+
+  void
+  World::write_snapshot(const std::string &filename) const
+  {
+    // Saving does not change the world, but the same serialize function is
+    // used for saving and loading.
+    World &world = const_cast<World &>(*this);
+    Snapshot snapshot(&world);
+    world.serialize(snapshot);
+    snapshot.write(filename);
+  }
+
+  void
+  World::serialize(Snapshot &snapshot)
+  {
+    snapshot(cross_section, surface_coord_conversions, potential_mantle_temperature, surface_temperature,
+             force_surface_temperature, thermal_expansion_coefficient, specific_heat, thermal_diffusivity,
+             maximum_distance_between_coordinates, interpolation, dim,
+             parameters.coordinate_system, parameters.features);
+  }
+
+  std::vector<std::pair<std::string,std::size_t> >
+  World::memory_usage() const
+  {
+    std::vector<std::pair<std::string,std::size_t> > components;
+    components.emplace_back("world",
+                            sizeof(*this)
+                            + Utilities::memory_usage(cross_section)
+                            + Utilities::memory_usage(interpolation)
+                            + Utilities::memory_usage(parameters.path)
+                            + Utilities::memory_usage(parameters.features)
+                            + feature_index.memory_usage());
+    components.emplace_back("parameters: declarations", document_memory_usage(parameters.declarations));
+    components.emplace_back("parameters: parameters", document_memory_usage(parameters.parameters));
+    components.emplace_back("parameters: lookup caches", parameters.lookup_cache_memory_usage());
+
+    for (auto &feature : parameters.features)
+      feature->memory_usage(components);
+
+    return components;
+  }
+
+  std::string
+  World::memory_report() const
+  {
+    const std::vector<std::pair<std::string,std::size_t> > components = memory_usage();
+
+    std::stringstream report;
+    report << std::left << std::setw(60) << "component" << std::right << std::setw(14) << "bytes" << std::endl;
+    std::size_t total = 0;
+    for (auto &component : components)
+      {
+        report << std::left << std::setw(60) << component.first << std::right << std::setw(14) << component.second << std::endl;
+        total += component.second;
+      }
+    report << std::left << std::setw(60) << "total" << std::right << std::setw(14) << total << std::endl;
+
+    // The memory pool allocators of rapidjson never give memory back before
+    // the document is destroyed, so their capacity is the high-water mark.
+    report << std::endl
+           << std::left << std::setw(60) << "allocator" << std::right << std::setw(14) << "used"
+           << std::setw(14) << "high-water" << std::endl;
+    const rapidjson::Document *documents[] = {&parameters.declarations, &parameters.parameters};
+    const char *document_names[] = {"parameters: declarations", "parameters: parameters"};
+    for (unsigned int i = 0; i < 2; ++i)
+      {
+        rapidjson::Document::AllocatorType &allocator = const_cast<rapidjson::Document *>(documents[i])->GetAllocator();
+        report << std::left << std::setw(60) << document_names[i] << std::right << std::setw(14) << allocator.Size()
+               << std::setw(14) << allocator.Capacity() << std::endl;
+      }
 
+    return report.str();
+  }
+
+}
@@ -95,6 +95,50 @@ extern "C" {
     *composition = a->composition(position,depth,composition_number);
   }
 
+  /**
+   * This function computes the temperature at n points given arrays of x, z, depth
+   * and gravity, and writes the results into the provided temperatures array of
+   * length n.
+   */
+  void temperatures_2d(void *ptr_ptr_world, size_t n, const double *x, const double *z, const double *depth, const double *gravity, double *temperatures)
+  {
+    WorldBuilder::World *a = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    a->temperatures(n,x,z,depth,gravity,temperatures);
+  }
+
+  /**
+   * This function computes the temperature at n points given arrays of x, y, z, depth
+   * and gravity, and writes the results into the provided temperatures array of
+   * length n.
+   */
+  void temperatures_3d(void *ptr_ptr_world, size_t n, const double *x, const double *y, const double *z, const double *depth, const double *gravity, double *temperatures)
+  {
+    WorldBuilder::World *a = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    a->temperatures(n,x,y,z,depth,gravity,temperatures);
+  }
+
+  /**
+   * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+   * x, z and depth. The value of composition c at point i is written to
+   * compositions[i*n_comp+c], so the provided array should have length n*n_comp.
+   */
+  void compositions_2d(void *ptr_ptr_world, size_t n, const double *x, const double *z, const double *depth, unsigned int n_comp, double *compositions)
+  {
+    WorldBuilder::World *a = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    a->compositions(n,x,z,depth,n_comp,compositions);
+  }
+
+  /**
+   * This function computes the compositions 0 to n_comp-1 at n points given arrays of
+   * x, y, z and depth. The value of composition c at point i is written to
+   * compositions[i*n_comp+c], so the provided array should have length n*n_comp.
+   */
+  void compositions_3d(void *ptr_ptr_world, size_t n, const double *x, const double *y, const double *z, const double *depth, unsigned int n_comp, double *compositions)
+  {
+    WorldBuilder::World *a = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    a->compositions(n,x,y,z,depth,n_comp,compositions);
+  }
+
   /**
    * The destructor for the world builder class. Call this function when done with the
    * world builder.
@@ -17,6 +17,10 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <thread>
+
+#include "world_builder/thread_chunks.h"
 #include "world_builder/wrapper_cpp.h"
 #include "world_builder/world.h"
 #include "iostream"
@@ -24,6 +28,21 @@
 using namespace WorldBuilder;
 namespace wrapper_cpp
 {
+  namespace
+  {
+    /**
+     * Returns the number of threads to use for n points, given the number
+     * of threads which was asked for, where zero means one per core.
+     */
+    unsigned int
+    threads_for(const size_t n, unsigned int n_threads)
+    {
+      if (n_threads == 0)
+        n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+      return static_cast<unsigned int>(std::min(static_cast<size_t>(n_threads), std::max(n, static_cast<size_t>(1))));
+    }
+  }
+
   WorldBuilderWrapper::WorldBuilderWrapper(std::string filename, bool has_output_dir, std::string output_dir)
     : ptr_ptr_world(NULL)
   {
@@ -63,4 +82,48 @@ namespace wrapper_cpp
     std::array<double,3> position = {{x,y,z}};
     return reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world)->composition(position,depth,composition_number);
   }
-}
\ No newline at end of file
+
+  void
+  WorldBuilderWrapper::temperatures_2d(size_t n, const double *x, const double *z, const double *depth, const double *gravity,
+                                       double *temperatures, unsigned int n_threads)
+  {
+    const WorldBuilder::World *world = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    Utilities::run_in_chunks(n, threads_for(n, n_threads), [&](const unsigned int, const size_t begin, const size_t end)
+    {
+      world->temperatures(end-begin, x+begin, z+begin, depth+begin, gravity+begin, temperatures+begin);
+    });
+  }
+
+  void
+  WorldBuilderWrapper::temperatures_3d(size_t n, const double *x, const double *y, const double *z, const double *depth, const double *gravity,
+                                       double *temperatures, unsigned int n_threads)
+  {
+    const WorldBuilder::World *world = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    Utilities::run_in_chunks(n, threads_for(n, n_threads), [&](const unsigned int, const size_t begin, const size_t end)
+    {
+      world->temperatures(end-begin, x+begin, y+begin, z+begin, depth+begin, gravity+begin, temperatures+begin);
+    });
+  }
+
+  void
+  WorldBuilderWrapper::compositions_2d(size_t n, const double *x, const double *z, const double *depth, unsigned int n_comp,
+                                       double *compositions, unsigned int n_threads)
+  {
+    const WorldBuilder::World *world = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    Utilities::run_in_chunks(n, threads_for(n, n_threads), [&](const unsigned int, const size_t begin, const size_t end)
+    {
+      world->compositions(end-begin, x+begin, z+begin, depth+begin, n_comp, compositions+begin*n_comp);
+    });
+  }
+
+  void
+  WorldBuilderWrapper::compositions_3d(size_t n, const double *x, const double *y, const double *z, const double *depth, unsigned int n_comp,
+                                       double *compositions, unsigned int n_threads)
+  {
+    const WorldBuilder::World *world = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
+    Utilities::run_in_chunks(n, threads_for(n, n_threads), [&](const unsigned int, const size_t begin, const size_t end)
+    {
+      world->compositions(end-begin, x+begin, y+begin, z+begin, depth+begin, n_comp, compositions+begin*n_comp);
+    });
+  }
+}
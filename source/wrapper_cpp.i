@@ -4,8 +4,126 @@
 #endif
 %}
 %include <stl.i>
+%include <exception.i>
 %module gwb
 %{
 #include "../include/world_builder/wrapper_cpp.h"
+#include <cstring>
+#include <string>
 %}
+
+/*
+ * Typemaps for the batched functions. The arrays are accessed through the
+ * Python buffer protocol, so any C contiguous float64 buffer (like a NumPy
+ * array) is used in place without copying.
+ */
+%define GWB_BUFFER_TYPEMAP(TYPE, FLAGS)
+%typemap(in) TYPE (Py_buffer view, int has_view = 0)
+{
+  if (PyObject_GetBuffer($input, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | FLAGS) != 0)
+    SWIG_fail;
+  has_view = 1;
+  const size_t format_length = view.format == NULL ? 0 : std::strlen(view.format);
+  if (view.itemsize != sizeof(double) || format_length == 0 || view.format[format_length-1] != 'd')
+    {
+      PyBuffer_Release(&view);
+      has_view = 0;
+      SWIG_exception_fail(SWIG_TypeError, "in method '$symname', argument $argnum must be a C contiguous float64 buffer.");
+    }
+  $1 = static_cast<$1_ltype>(view.buf);
+}
+%enddef
+
+GWB_BUFFER_TYPEMAP(const double *BUFFER_IN, 0)
+GWB_BUFFER_TYPEMAP(double *BUFFER_OUT, PyBUF_WRITABLE)
+
+%typemap(freearg) const double *BUFFER_IN, double *BUFFER_OUT
+{
+  if (has_view$argnum)
+    PyBuffer_Release(&view$argnum);
+}
+
+%apply const double *BUFFER_IN { const double *x, const double *y, const double *z, const double *depth, const double *gravity };
+%apply double *BUFFER_OUT { double *temperatures, double *compositions };
+
+/*
+ * Release the GIL while the batched functions run, so other Python threads
+ * can continue. Exceptions are caught before the GIL is reacquired and are
+ * turned into Python exceptions afterwards.
+ */
+%define GWB_RELEASE_GIL(METHOD)
+%exception METHOD
+{
+  std::string error_message;
+  Py_BEGIN_ALLOW_THREADS
+  try
+    {
+      $action
+    }
+  catch (const std::exception &e)
+    {
+      error_message = e.what();
+    }
+  Py_END_ALLOW_THREADS
+  if (!error_message.empty())
+    SWIG_exception(SWIG_RuntimeError, error_message.c_str());
+}
+%enddef
+
+GWB_RELEASE_GIL(wrapper_cpp::WorldBuilderWrapper::temperatures_2d)
+GWB_RELEASE_GIL(wrapper_cpp::WorldBuilderWrapper::temperatures_3d)
+GWB_RELEASE_GIL(wrapper_cpp::WorldBuilderWrapper::compositions_2d)
+GWB_RELEASE_GIL(wrapper_cpp::WorldBuilderWrapper::compositions_3d)
+
+%rename(_temperatures_2d) wrapper_cpp::WorldBuilderWrapper::temperatures_2d;
+%rename(_temperatures_3d) wrapper_cpp::WorldBuilderWrapper::temperatures_3d;
+%rename(_compositions_2d) wrapper_cpp::WorldBuilderWrapper::compositions_2d;
+%rename(_compositions_3d) wrapper_cpp::WorldBuilderWrapper::compositions_3d;
+
 %include "../include/world_builder/wrapper_cpp.h"
+
+/*
+ * NumPy friendly versions of the batched functions. The inputs may be any
+ * array like objects of the same shape (or scalars, which are broadcast).
+ * Arrays which already are C contiguous float64 arrays are not copied. The
+ * returned array has the shape of the inputs, with an extra last axis of
+ * length n_compositions for the compositions.
+ */
+%extend wrapper_cpp::WorldBuilderWrapper
+{
+%pythoncode %{
+  @staticmethod
+  def _prepare_arrays(*arrays):
+    import numpy
+    arrays = numpy.broadcast_arrays(*[numpy.asarray(a, dtype=numpy.float64) for a in arrays])
+    return [numpy.ascontiguousarray(a) for a in arrays]
+
+  def temperatures_2d(self, x, z, depth, gravity, n_threads=1):
+    import numpy
+    x, z, depth, gravity = self._prepare_arrays(x, z, depth, gravity)
+    temperatures = numpy.empty(x.shape, dtype=numpy.float64)
+    self._temperatures_2d(x.size, x, z, depth, gravity, temperatures, int(n_threads))
+    return temperatures
+
+  def temperatures_3d(self, x, y, z, depth, gravity, n_threads=1):
+    import numpy
+    x, y, z, depth, gravity = self._prepare_arrays(x, y, z, depth, gravity)
+    temperatures = numpy.empty(x.shape, dtype=numpy.float64)
+    self._temperatures_3d(x.size, x, y, z, depth, gravity, temperatures, int(n_threads))
+    return temperatures
+
+  def compositions_2d(self, x, z, depth, n_compositions, n_threads=1):
+    import numpy
+    x, z, depth = self._prepare_arrays(x, z, depth)
+    compositions = numpy.empty(x.shape + (int(n_compositions),), dtype=numpy.float64)
+    self._compositions_2d(x.size, x, z, depth, int(n_compositions), compositions, int(n_threads))
+    return compositions
+
+  def compositions_3d(self, x, y, z, depth, n_compositions, n_threads=1):
+    import numpy
+    x, y, z, depth = self._prepare_arrays(x, y, z, depth)
+    compositions = numpy.empty(x.shape + (int(n_compositions),), dtype=numpy.float64)
+    self._compositions_3d(x.size, x, y, z, depth, int(n_compositions), compositions, int(n_threads))
+    return compositions
+%}
+}
@@ -98,6 +98,72 @@ USE, INTRINSIC :: ISO_C_BINDING!, ONLY: C_PTR
       REAL(C_DOUBLE), intent(out) :: composition
     END SUBROUTINE composition_3d
 
+    !> Create an interface with the batched 2d temperature C function of the World builder.
+    !! This function computes the temperature at n points given arrays of x, z, depth and
+    !! gravity. Use the temperatures_2d module procedure, which takes assumed-shape arrays.
+    SUBROUTINE c_temperatures_2d(cworld, n, x, z, depth, gravity, temperatures) BIND(C, NAME='temperatures_2d')
+      USE, INTRINSIC :: ISO_C_BINDING
+      IMPLICIT NONE
+      ! This argument is a pointer passed by value.
+      TYPE(C_PTR), INTENT(IN), VALUE :: cworld
+      INTEGER(C_SIZE_T), intent(in), value :: n
+      REAL(C_DOUBLE), intent(in) :: x(*)
+      REAL(C_DOUBLE), intent(in) :: z(*)
+      REAL(C_DOUBLE), intent(in) :: depth(*)
+      REAL(C_DOUBLE), intent(in) :: gravity(*)
+      REAL(C_DOUBLE), intent(out) :: temperatures(*)
+    END SUBROUTINE c_temperatures_2d
+
+    !> Create an interface with the batched 3d temperature C function of the World builder.
+    !! This function computes the temperature at n points given arrays of x, y, z, depth and
+    !! gravity. Use the temperatures_3d module procedure, which takes assumed-shape arrays.
+    SUBROUTINE c_temperatures_3d(cworld, n, x, y, z, depth, gravity, temperatures) BIND(C, NAME='temperatures_3d')
+      USE, INTRINSIC :: ISO_C_BINDING
+      IMPLICIT NONE
+      ! This argument is a pointer passed by value.
+      TYPE(C_PTR), INTENT(IN), VALUE :: cworld
+      INTEGER(C_SIZE_T), intent(in), value :: n
+      REAL(C_DOUBLE), intent(in) :: x(*)
+      REAL(C_DOUBLE), intent(in) :: y(*)
+      REAL(C_DOUBLE), intent(in) :: z(*)
+      REAL(C_DOUBLE), intent(in) :: depth(*)
+      REAL(C_DOUBLE), intent(in) :: gravity(*)
+      REAL(C_DOUBLE), intent(out) :: temperatures(*)
+    END SUBROUTINE c_temperatures_3d
+
+    !> Create an interface with the batched 2d composition C function of the World builder.
+    !! This function computes the compositions 0 to n_comp-1 at n points given arrays of x, z
+    !! and depth. Use the compositions_2d module procedure, which takes assumed-shape arrays.
+    SUBROUTINE c_compositions_2d(cworld, n, x, z, depth, n_comp, compositions) BIND(C, NAME='compositions_2d')
+      USE, INTRINSIC :: ISO_C_BINDING
+      IMPLICIT NONE
+      ! This argument is a pointer passed by value.
+      TYPE(C_PTR), INTENT(IN), VALUE :: cworld
+      INTEGER(C_SIZE_T), intent(in), value :: n
+      REAL(C_DOUBLE), intent(in) :: x(*)
+      REAL(C_DOUBLE), intent(in) :: z(*)
+      REAL(C_DOUBLE), intent(in) :: depth(*)
+      INTEGER(C_INT), intent(in), value :: n_comp
+      REAL(C_DOUBLE), intent(out) :: compositions(*)
+    END SUBROUTINE c_compositions_2d
+
+    !> Create an interface with the batched 3d composition C function of the World builder.
+    !! This function computes the compositions 0 to n_comp-1 at n points given arrays of x, y,
+    !! z and depth. Use the compositions_3d module procedure, which takes assumed-shape arrays.
+    SUBROUTINE c_compositions_3d(cworld, n, x, y, z, depth, n_comp, compositions) BIND(C, NAME='compositions_3d')
+      USE, INTRINSIC :: ISO_C_BINDING
+      IMPLICIT NONE
+      ! This argument is a pointer passed by value.
+      TYPE(C_PTR), INTENT(IN), VALUE :: cworld
+      INTEGER(C_SIZE_T), intent(in), value :: n
+      REAL(C_DOUBLE), intent(in) :: x(*)
+      REAL(C_DOUBLE), intent(in) :: y(*)
+      REAL(C_DOUBLE), intent(in) :: z(*)
+      REAL(C_DOUBLE), intent(in) :: depth(*)
+      INTEGER(C_INT), intent(in), value :: n_comp
+      REAL(C_DOUBLE), intent(out) :: compositions(*)
+    END SUBROUTINE c_compositions_3d
+
     !> Create an interface with the release world function.
     !! This is the destructor for the world builder class. Call this function when done
     !! with the world builder.
@@ -111,4 +177,68 @@ USE, INTRINSIC :: ISO_C_BINDING!, ONLY: C_PTR
 
   !> The C pointer to the World Builder world. It is generated by the create_world function.
   TYPE(C_PTR) :: cworld
+
+  CONTAINS
+
+  !> Computes the temperature for every point in a block of points in a 2d cross section.
+  !! The coordinate, depth, gravity and temperature arrays should all have the same size.
+  !! This makes a single call into the World Builder for the whole block.
+  SUBROUTINE temperatures_2d(cworld, x, z, depth, gravity, temperatures)
+    IMPLICIT NONE
+    TYPE(C_PTR), INTENT(IN) :: cworld
+    REAL(C_DOUBLE), intent(in) :: x(:)
+    REAL(C_DOUBLE), intent(in) :: z(:)
+    REAL(C_DOUBLE), intent(in) :: depth(:)
+    REAL(C_DOUBLE), intent(in) :: gravity(:)
+    REAL(C_DOUBLE), intent(out) :: temperatures(:)
+
+    CALL c_temperatures_2d(cworld, INT(SIZE(temperatures), C_SIZE_T), x, z, depth, gravity, temperatures)
+  END SUBROUTINE temperatures_2d
+
+  !> Computes the temperature for every point in a block of points in 3d.
+  !! The coordinate, depth, gravity and temperature arrays should all have the same size.
+  !! This makes a single call into the World Builder for the whole block.
+  SUBROUTINE temperatures_3d(cworld, x, y, z, depth, gravity, temperatures)
+    IMPLICIT NONE
+    TYPE(C_PTR), INTENT(IN) :: cworld
+    REAL(C_DOUBLE), intent(in) :: x(:)
+    REAL(C_DOUBLE), intent(in) :: y(:)
+    REAL(C_DOUBLE), intent(in) :: z(:)
+    REAL(C_DOUBLE), intent(in) :: depth(:)
+    REAL(C_DOUBLE), intent(in) :: gravity(:)
+    REAL(C_DOUBLE), intent(out) :: temperatures(:)
+
+    CALL c_temperatures_3d(cworld, INT(SIZE(temperatures), C_SIZE_T), x, y, z, depth, gravity, temperatures)
+  END SUBROUTINE temperatures_3d
+
+  !> Computes all compositions for every point in a block of points in a 2d cross section.
+  !! The compositions array has the shape (number of compositions, number of points), so
+  !! compositions(c,i) is composition number c-1 at point i.
+  SUBROUTINE compositions_2d(cworld, x, z, depth, compositions)
+    IMPLICIT NONE
+    TYPE(C_PTR), INTENT(IN) :: cworld
+    REAL(C_DOUBLE), intent(in) :: x(:)
+    REAL(C_DOUBLE), intent(in) :: z(:)
+    REAL(C_DOUBLE), intent(in) :: depth(:)
+    REAL(C_DOUBLE), intent(out) :: compositions(:,:)
+
+    CALL c_compositions_2d(cworld, INT(SIZE(compositions,2), C_SIZE_T), x, z, depth, &
+                           INT(SIZE(compositions,1), C_INT), compositions)
+  END SUBROUTINE compositions_2d
+
+  !> Computes all compositions for every point in a block of points in 3d.
+  !! The compositions array has the shape (number of compositions, number of points), so
+  !! compositions(c,i) is composition number c-1 at point i.
+  SUBROUTINE compositions_3d(cworld, x, y, z, depth, compositions)
+    IMPLICIT NONE
+    TYPE(C_PTR), INTENT(IN) :: cworld
+    REAL(C_DOUBLE), intent(in) :: x(:)
+    REAL(C_DOUBLE), intent(in) :: y(:)
+    REAL(C_DOUBLE), intent(in) :: z(:)
+    REAL(C_DOUBLE), intent(in) :: depth(:)
+    REAL(C_DOUBLE), intent(out) :: compositions(:,:)
+
+    CALL c_compositions_3d(cworld, INT(SIZE(compositions,2), C_SIZE_T), x, y, z, depth, &
+                           INT(SIZE(compositions,1), C_INT), compositions)
+  END SUBROUTINE compositions_3d
   END MODULE WorldBuilder
@@ -7,6 +7,9 @@ IMPLICIT NONE
   REAL*8 :: temperature,x=120e3,y=500e3,z=0,depth=0,gravity = 10
   INTEGER :: composition_number = 3
   REAL*8 :: composition
+  REAL*8 :: xs(2) = (/ 1.0d0, 120.0d3 /), ys(2) = (/ 2.0d0, 500.0d3 /), zs(2) = (/ 3.0d0, 0.0d0 /)
+  REAL*8 :: depths(2) = (/ 0.0d0, 0.0d0 /), gravities(2) = (/ 10.0d0, 10.0d0 /)
+  REAL*8 :: temperatures(2), compositions(4,2)
   !character(len=256) :: path
   INTEGER*4 :: k = 1
   character(len=256) :: file_name != MY_FLAG//"/data/continental_plate.wb"//C_NULL_CHAR
@@ -34,5 +37,21 @@ IMPLICIT NONE
   CALL composition_3d(cworld,x,y,z,depth,composition_number,composition)
   write(*, *) 'composition in fortran = ', composition
 
+  write(*, *) '2d temperatures:'
+  CALL temperatures_2d(cworld,xs,zs,depths,gravities,temperatures)
+  write(*, *) 'temperatures in fortran = ', temperatures
+
+  write(*, *) '3d temperatures:'
+  CALL temperatures_3d(cworld,xs,ys,zs,depths,gravities,temperatures)
+  write(*, *) 'temperatures in fortran = ', temperatures
+
+  write(*, *) '2d compositions:'
+  CALL compositions_2d(cworld,xs,zs,depths,compositions)
+  write(*, *) 'compositions in fortran = ', compositions
+
+  write(*, *) '3d compositions:'
+  CALL compositions_3d(cworld,xs,ys,zs,depths,compositions)
+  write(*, *) 'compositions in fortran = ', compositions
+
   CALL release_world(cworld)
 END program
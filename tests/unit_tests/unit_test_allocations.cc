@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// The allocation tests are in their own program, since they replace the
+// global operator new and delete to count the allocations.
+
+#define CATCH_CONFIG_MAIN
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <catch2.h>
+
+#include <world_builder/config.h>
+#include <world_builder/world.h>
+
+using namespace WorldBuilder;
+
+namespace
+{
+  /**
+   * Whether allocations are counted. Only the thread running the tests
+   * queries the world, so this does not need to be atomic.
+   */
+  bool count_allocations = false;
+  std::size_t n_allocations = 0;
+
+  void *
+  counted_malloc(const std::size_t size)
+  {
+    if (count_allocations)
+      ++n_allocations;
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+      throw std::bad_alloc();
+    return pointer;
+  }
+
+  /**
+   * Evaluate the temperature and all compositions at a grid of points, and
+   * return the number of allocations this took. The results are summed into
+   * @p checksum, so that the queries can not be optimized away.
+   */
+  std::size_t
+  count_query_allocations(const World &world,
+                          const unsigned int n_compositions,
+                          double &checksum)
+  {
+    std::vector<std::array<double,4> > points;
+    for (unsigned int i = 0; i < 500; ++i)
+      points.push_back({{i * 4e3, (i % 25) * 80e3, 1000e3 - (i % 7) * 50e3, (i % 13) * 25e3}});
+
+    n_allocations = 0;
+    count_allocations = true;
+    for (auto &point : points)
+      {
+        const std::array<double,3> position = {{point[0], point[1], point[2]}};
+        checksum += world.temperature(position, point[3], 10);
+        for (unsigned int composition = 0; composition < n_compositions; ++composition)
+          checksum += world.composition(position, point[3], composition);
+      }
+    count_allocations = false;
+    return n_allocations;
+  }
+}
+
+void *operator new(std::size_t size)
+{
+  return counted_malloc(size);
+}
+
+void *operator new[](std::size_t size)
+{
+  return counted_malloc(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+  std::free(pointer);
+}
+
+TEST_CASE("WorldBuilder World: queries do not allocate")
+{
+  const std::vector<std::string> file_names = {"/tests/performance/slab_heavy.wb",
+                                               "/tests/performance/spherical.wb",
+                                               "/tests/data/subducting_plate_different_angles_cartesian.wb",
+                                               "/tests/data/fault_different_angles_cartesian.wb"
+                                              };
+  for (auto &file_name : file_names)
+    {
+      World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + file_name);
+
+      // The first queries may allocate memory which is reused afterwards.
+      double checksum = 0;
+      count_query_allocations(world, 7, checksum);
+
+      const std::size_t allocations = count_query_allocations(world, 7, checksum);
+      INFO("world builder file: " << file_name << ", checksum: " << checksum);
+      CHECK(allocations == 0);
+    }
+}
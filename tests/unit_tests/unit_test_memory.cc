@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 2018 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// The memory tests are in their own program, since the resident set size
+// of the process is measured, which is disturbed by memory which earlier
+// tests have freed but not given back to the operating system.
+
+#define CATCH_CONFIG_MAIN
+
+#include <array>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <catch2.h>
+
+#include <world_builder/config.h>
+#include <world_builder/world.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace WorldBuilder;
+
+using Catch::Matchers::Contains;
+
+namespace
+{
+  std::size_t
+  total_memory_usage(const World &world)
+  {
+    std::size_t total = 0;
+    for (auto &component : world.memory_usage())
+      total += component.second;
+    return total;
+  }
+
+#ifdef __linux__
+  /**
+   * Returns the resident set size of this process in bytes.
+   */
+  std::size_t
+  resident_set_size()
+  {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total_pages = 0;
+    std::size_t resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+    return resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+}
+
+TEST_CASE("WorldBuilder World: memory usage against resident set size")
+{
+#ifdef __linux__
+  const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/performance/slab_heavy.wb";
+
+  // Load the world once before measuring, so that memory which is only
+  // allocated once per process is not measured.
+  std::size_t reported = 0;
+  {
+    World world(file_name);
+    reported = total_memory_usage(world);
+  }
+
+  // Keep many copies of the world alive, so that the memory which is only
+  // used during the creation of a world is reused between the copies and
+  // averages out.
+  const unsigned int n_worlds = 20;
+  std::vector<std::unique_ptr<World> > worlds;
+  const std::size_t resident_before = resident_set_size();
+  for (unsigned int i = 0; i < n_worlds; ++i)
+    worlds.emplace_back(new World(file_name));
+  const std::size_t resident_after = resident_set_size();
+
+  const double measured = static_cast<double>(resident_after - resident_before) / n_worlds;
+  INFO("reported bytes per world: " << reported << ", measured bytes per world: " << measured);
+
+  // The report does not include the overhead of the heap and of some small
+  // objects, so the measured size should be somewhat larger.
+  CHECK(reported > 0.5 * measured);
+  CHECK(reported < 1.5 * measured);
+  CHECK(total_memory_usage(*worlds.back()) == reported);
+#endif
+}
+
+TEST_CASE("WorldBuilder World: memory report")
+{
+  const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb";
+  World world(file_name);
+
+  const std::vector<std::pair<std::string,std::size_t> > components = world.memory_usage();
+  std::size_t total = 0;
+  for (auto &component : components)
+    {
+      CHECK(component.second > 0);
+      total += component.second;
+    }
+  CHECK(components[0].first == "world");
+  CHECK(components[1].first == "parameters: declarations");
+  CHECK(components[2].first == "parameters: parameters");
+
+  // The declarations are much larger than the parameters of this small world.
+  CHECK(components[1].second > components[2].second);
+
+  const std::string report = world.memory_report();
+  CHECK_THAT(report, Contains("First subducting plate: coordinates"));
+  CHECK_THAT(report, Contains("First subducting plate: slab segment tables"));
+  CHECK_THAT(report, Contains("First subducting plate: models"));
+  CHECK_THAT(report, Contains(std::to_string(total)));
+  CHECK_THAT(report, Contains("high-water"));
+}
+
+TEST_CASE("WorldBuilder World: compact mode")
+{
+  const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/performance/slab_heavy.wb";
+  World world(file_name);
+  World compact_world(file_name, false, "", "", true);
+
+  // The json documents are released.
+  const std::vector<std::pair<std::string,std::size_t> > components = world.memory_usage();
+  const std::vector<std::pair<std::string,std::size_t> > compact_components = compact_world.memory_usage();
+  REQUIRE(components.size() == compact_components.size());
+  CHECK(compact_components[1].first == "parameters: declarations");
+  CHECK(compact_components[1].second == 0);
+  CHECK(compact_components[2].first == "parameters: parameters");
+  CHECK(compact_components[2].second == 0);
+  CHECK(compact_components[3].first == "parameters: lookup caches");
+  CHECK(compact_components[3].second == 0);
+  CHECK(total_memory_usage(compact_world) < total_memory_usage(world) - components[1].second - components[2].second);
+
+  // The world still gives the same answers.
+  for (unsigned int i = 0; i < 200; ++i)
+    {
+      const std::array<double,3> point = {{i * 10e3, (i % 20) * 100e3, 1000e3 - (i % 7) * 50e3}};
+      const double depth = (i % 13) * 20e3;
+      CHECK(compact_world.temperature(point, depth, 10) == world.temperature(point, depth, 10));
+      for (unsigned int composition = 0; composition < 7; ++composition)
+        CHECK(compact_world.composition(point, depth, composition) == world.composition(point, depth, composition));
+    }
+}
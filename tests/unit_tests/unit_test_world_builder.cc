@@ -19,13 +19,23 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <thread>
 
 #include <catch2.h>
 
 #include <world_builder/config.h>
 #include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/depth_interval_index.h>
+#include <world_builder/distance_field.h>
 
 #include <world_builder/features/interface.h>
 #include <world_builder/features/continental_plate.h>
@@ -33,6 +43,12 @@
 #include <world_builder/features/fault_models/composition/uniform.h>
 
 #include <world_builder/point.h>
+#include <world_builder/section_index.h>
+#include <world_builder/segment_table.h>
+#include <world_builder/slab_envelope.h>
+#include <world_builder/snapshot.h>
+#include <world_builder/spatial_order.h>
+#include <world_builder/thread_slots.h>
 
 #include <world_builder/types/array.h>
 #include <world_builder/types/bool.h>
@@ -64,6 +80,21 @@ std::array<double,3> normalize(std::array<double,3> array)
   return {array[0]/norm,array[1]/norm,array[2]/norm};
 }
 
+/**
+ * Returns a path for a file with the given name in the temporary directory,
+ * so that the tests do not write into the directory they are run from.
+ */
+inline
+std::string temporary_file_name(const std::string &name)
+{
+  const char *directory = std::getenv("TMPDIR");
+  if (directory == nullptr)
+    directory = std::getenv("TEMP");
+  if (directory == nullptr)
+    directory = std::getenv("TMP");
+  return std::string(directory != nullptr ? directory : "/tmp") + "/" + name;
+}
+
 /**
  * Compare the given two std::vector<double> entries with an epsilon (using Catch::Approx)
  */
@@ -692,6 +723,40 @@ TEST_CASE("WorldBuilder C wrapper")
   composition_3d(*ptr_ptr_world, 120e3, 500e3, 0, 0, 3, &composition);
   CHECK(composition == Approx(1.0));
 
+  // Test the batched versions, which should give the same results
+  const double x[2] = {1, 120e3};
+  const double y[2] = {2, 500e3};
+  const double z[2] = {3, 0};
+  const double depth[2] = {0, 0};
+  const double gravity[2] = {10, 10};
+  double temperatures[2] = {0, 0};
+  double compositions[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+
+  temperatures_3d(*ptr_ptr_world, 2, x, y, z, depth, gravity, temperatures);
+  CHECK(temperatures[0] == Approx(1600));
+  CHECK(temperatures[1] == Approx(150));
+
+  const double x_2d[2] = {1, 550e3};
+  const double z_2d[2] = {2, 0};
+  temperatures_2d(*ptr_ptr_world, 2, x_2d, z_2d, depth, gravity, temperatures);
+  CHECK(temperatures[0] == Approx(1600));
+  CHECK(temperatures[1] == Approx(150));
+
+  compositions_3d(*ptr_ptr_world, 2, x, y, z, depth, 4, compositions);
+  for (unsigned int c = 0; c < 4; ++c)
+    {
+      composition_3d(*ptr_ptr_world, x[0], y[0], z[0], depth[0], c, &composition);
+      CHECK(compositions[c] == Approx(composition));
+      composition_3d(*ptr_ptr_world, x[1], y[1], z[1], depth[1], c, &composition);
+      CHECK(compositions[4 + c] == Approx(composition));
+    }
+  CHECK(compositions[3] == Approx(0.0));
+  CHECK(compositions[7] == Approx(1.0));
+
+  compositions_2d(*ptr_ptr_world, 2, x_2d, z_2d, depth, 4, compositions);
+  CHECK(compositions[3] == Approx(0.0));
+  CHECK(compositions[7] == Approx(1.0));
+
   release_world(*ptr_ptr_world);
 
   // Now test a world builder file without a cross section defined
@@ -721,6 +786,16 @@ TEST_CASE("WorldBuilder C wrapper")
   composition_3d(*ptr_ptr_world, 120e3, 500e3, 0, 0, 3, &composition);
   CHECK(composition == Approx(1.0));
 
+  CHECK_THROWS_WITH(temperatures_2d(*ptr_ptr_world, 2, x_2d, z_2d, depth, gravity, temperatures),
+                    Contains("This function can only be called when the cross section "
+                             "variable in the world builder file has been set. Dim is 3."));
+  CHECK_THROWS_WITH(compositions_2d(*ptr_ptr_world, 2, x_2d, z_2d, depth, 4, compositions),
+                    Contains("This function can only be called when the cross section "
+                             "variable in the world builder file has been set. Dim is 3."));
+  temperatures_3d(*ptr_ptr_world, 2, x, y, z, depth, gravity, temperatures);
+  CHECK(temperatures[0] == Approx(1600));
+  CHECK(temperatures[1] == Approx(150));
+
   release_world(*ptr_ptr_world);
 }
 
@@ -754,6 +829,34 @@ TEST_CASE("WorldBuilder CPP wrapper")
   composition = world.composition_3d(120e3, 500e3, 0, 0, 3);
   CHECK(composition == Approx(1.0));
 
+  // Test the batched versions, with and without threads.
+  const size_t n_points = 101;
+  std::vector<double> x(n_points), y(n_points, 500e3), z(n_points, 0), depth(n_points, 0), gravity(n_points, 10);
+  for (size_t i = 0; i < n_points; ++i)
+    x[i] = 2e3 * static_cast<double>(i);
+
+  for (unsigned int n_threads = 0; n_threads < 4; ++n_threads)
+    {
+      std::vector<double> temperatures(n_points), compositions(4*n_points);
+      world.temperatures_3d(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &temperatures[0], n_threads);
+      world.compositions_3d(n_points, &x[0], &y[0], &z[0], &depth[0], 4, &compositions[0], n_threads);
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          CHECK(temperatures[i] == Approx(world.temperature_3d(x[i], y[i], z[i], depth[i], gravity[i])));
+          for (unsigned int c = 0; c < 4; ++c)
+            CHECK(compositions[i*4+c] == Approx(world.composition_3d(x[i], y[i], z[i], depth[i], c)));
+        }
+
+      world.temperatures_2d(n_points, &x[0], &y[0], &depth[0], &gravity[0], &temperatures[0], n_threads);
+      world.compositions_2d(n_points, &x[0], &y[0], &depth[0], 4, &compositions[0], n_threads);
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          CHECK(temperatures[i] == Approx(world.temperature_2d(x[i], y[i], depth[i], gravity[i])));
+          for (unsigned int c = 0; c < 4; ++c)
+            CHECK(compositions[i*4+c] == Approx(world.composition_2d(x[i], y[i], depth[i], c)));
+        }
+    }
+
 
   // Now test a world builder file without a cross section defined
   file = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb2.json";
@@ -773,6 +876,10 @@ TEST_CASE("WorldBuilder CPP wrapper")
   CHECK_THROWS_WITH(world2.composition_2d(1, 2, 0, 2),
                     Contains("This function can only be called when the cross section "
                              "variable in the world builder file has been set. Dim is 3."));
+  std::vector<double> temperatures(n_points);
+  CHECK_THROWS_WITH(world2.temperatures_2d(n_points, &x[0], &y[0], &depth[0], &gravity[0], &temperatures[0], 2),
+                    Contains("This function can only be called when the cross section "
+                             "variable in the world builder file has been set. Dim is 3."));
 
   composition = world2.composition_3d(1, 2, 3, 0, 2);
   CHECK(composition == Approx(0.0));
@@ -4021,7 +4128,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
 
   double starting_radius = 10;
 
-  std::map<std::string,double> distance_from_planes =
+  Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -4031,12 +4138,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // center square test 2
@@ -4052,12 +4159,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14); // practically zero
 
   // center square test 3
   position[1] = 20;
@@ -4072,12 +4179,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // center square test 4
   reference_point[1] = 0;
@@ -4092,12 +4199,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14); // practically zero
 
   // center square test 5
   position[1] = -10;
@@ -4113,12 +4220,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0707106781)); // practically zero
 
   // begin section square test 6
   position[0] = 0;
@@ -4133,12 +4240,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(std::fabs(distance_from_planes["sectionFraction"]) < 1e-14);
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(std::fabs(distance_from_planes.section_fraction) < 1e-14);
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0707106781)); // practically zero
 
 
   // end section square test 7
@@ -4154,12 +4261,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0707106781)); // practically zero
 
   // before begin section square test 8
   position[0] = -10;
@@ -4174,12 +4281,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14); // practically zero
 
   // beyond end section square test 9
   position[0] = 25;
@@ -4194,12 +4301,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14); // practically zero
 
 
   // beyond end section square test 10
@@ -4217,12 +4324,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.6066017178));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.75));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.6066017178));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.75));
 
   // beyond end section square test 10 (only positive version)
   position[0] = 10;
@@ -4239,12 +4346,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  true);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.6066017178));
-  CHECK(distance_from_planes["sectionFraction"] ==  Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.75));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.6066017178));
+  CHECK(distance_from_planes.section_fraction ==  Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.75));
 
 
   // beyond end section square test 11
@@ -4262,12 +4369,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(17.6776695297));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0176776695));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(17.6776695297));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0176776695));
 
 
   // beyond end section square test 11 (only positve version)
@@ -4285,12 +4392,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  true);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(17.6776695297));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0176776695));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(17.6776695297));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0176776695));
 
   // add coordinate
   position[0] = 25;
@@ -4317,12 +4424,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // different angle
   slab_segment_angles[0][0][0] = 22.5 * dtr;
@@ -4348,12 +4455,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.8239219938));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.7653668647));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.8239219938));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.7653668647));
 
   // check interpolation 1 (in the middle of a segment with 22.5 degree and a segement with 45)
   position[0] = 25;
@@ -4370,12 +4477,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(12.0268977387)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.8504300948));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(12.0268977387)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.8504300948));
 
   // check interpolation 2 (at the end of the segment at 45 degree)
   position[0] = 30;
@@ -4392,12 +4499,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(14.1421356237)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(14.1421356237)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // check length interpolation with 90 degree angles for simplicity
   // check length interpolation first segment center 1
@@ -4435,12 +4542,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(100.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(100.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // check length interpolation first segment center 2
   position[0] = 10;
@@ -4457,12 +4564,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(101.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.01));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(101.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.01));
 
   // check length interpolation first segment center 3
   position[0] = 10;
@@ -4479,12 +4586,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(200.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(200.0));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
 
@@ -4503,12 +4610,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
 
   // Now check the center of the second segment, each segment should have a length of 75.
@@ -4527,12 +4634,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(75.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(75.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // check length interpolation second segment center 2
   position[0] = 25;
@@ -4549,12 +4656,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(76.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.01333333333333));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(76.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.01333333333333));
 
   // check length interpolation second segment center 3
   position[0] = 25;
@@ -4571,12 +4678,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(150.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(150.0));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
 
@@ -4595,12 +4702,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // Now check the end of the second segment, each segment should have a length of 50.
   // check length interpolation second segment center 1
@@ -4618,12 +4725,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(50.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(50.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // check length interpolation second segment center 2
   position[0] = 30;
@@ -4640,12 +4747,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(51.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.02));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(51.0)); // practically zero
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.02));
 
   // check length interpolation second segment center 3
   position[0] = 30;
@@ -4662,12 +4769,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(100.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(100.0));
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
 
@@ -4686,12 +4793,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 }
 
 TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes cartesian part 2")
@@ -4755,7 +4862,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
   position[1] = 0;
   position[2] = 0;
 
-  std::map<std::string,double> distance_from_planes =
+  Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -4765,12 +4872,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 2
   position[0] = 10;
@@ -4787,12 +4894,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(5.0)); // checked that it should be about 5 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(5.0)); // checked that it should be about 5 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 3
   position[0] = 10;
@@ -4809,12 +4916,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-5.0)); // checked that it should be about -5 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-5.0)); // checked that it should be about -5 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // curve test 4
@@ -4832,12 +4939,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 5
   position[0] = 10;
@@ -4854,12 +4961,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-10.0)); // checked that it should be about -10 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-10.0)); // checked that it should be about -10 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 6
   position[0] = 10;
@@ -4876,16 +4983,16 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10.0)); // checked that it should be about 10 this with a drawing
+  CHECK(distance_from_planes.distance_from_plane == Approx(10.0)); // checked that it should be about 10 this with a drawing
   // This is a special case where the point coincides with the center of the circle.
   // Because all the points on the circle are equally close, we have chosen in the
   // code to define this case as that this point belongs to the top of the top segment
   // where the check point has angle 0. This means that the distanceAlongPlate is zero.
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(0.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_along_plane == Approx(0.0));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
 
   // curve test 7
@@ -4903,12 +5010,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // curve test 8
   slab_segment_lengths[0][0] = 5 * 45 * dtr;
@@ -4930,12 +5037,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 5));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 5));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 9
   position[0] = 10;
@@ -4952,12 +5059,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 5));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 5));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // curve test 10
@@ -4989,12 +5096,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 11
   position[0] = 10;
@@ -5011,12 +5118,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
   // curve test 12
   position[0] = 10;
@@ -5033,12 +5140,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(135.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(135.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
 
   // curve test 13
@@ -5056,12 +5163,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 14
   slab_segment_angles[0][0][0] = 0.0 * dtr;
@@ -5092,12 +5199,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
   // curve test 15
   position[0] = 10;
@@ -5114,12 +5221,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 16
   position[0] = 10;
@@ -5136,12 +5243,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-1.0)); // checked that it should be about -1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-1.0)); // checked that it should be about -1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 16
   position[0] = 10;
@@ -5158,12 +5265,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(1.0)); // checked that it should be about -1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(1.0)); // checked that it should be about -1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 17
   position[0] = 10;
@@ -5180,12 +5287,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // curve test 18
@@ -5203,12 +5310,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-1.0)); // checked that it should be about 1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-1.0)); // checked that it should be about 1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 19
   position[0] = 10;
@@ -5225,12 +5332,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(1.0)); // checked that it should be about 1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(1.0)); // checked that it should be about 1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // curve test 20
@@ -5262,12 +5369,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0/3.0));
 
   // curve test 21
   position[0] = 10;
@@ -5284,12 +5391,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(2.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(2.0/3.0));
 
   // curve test 21
   position[0] = 10;
@@ -5306,12 +5413,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test 22
   position[0] = 10;
@@ -5328,12 +5435,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(315.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(315.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test start 45 degree 1
   slab_segment_angles[0][0][0] = 45.0 * dtr;
@@ -5367,12 +5474,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-7.3205080757)); // checked that it should be about -7.3 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(9.5531661812));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.2163468959));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-7.3205080757)); // checked that it should be about -7.3 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(9.5531661812));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.2163468959));
 
   // curve test change reference point 1
   reference_point[0] = 50;
@@ -5393,12 +5500,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false);
 
   // checked that distanceFromPlane should be infinity (it is on the other side of the circle this with a drawing
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.section_fraction == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // curve test change reference point 2
   position[0] = 10;
@@ -5415,12 +5522,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(2.3463313527)); // checked that it should be about 2.3 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(11.780972451));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(distance_from_planes.distance_from_plane == Approx(2.3463313527)); // checked that it should be about 2.3 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(11.780972451));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
   // curve test angle interpolation 1
   reference_point[0] = 0;
@@ -5455,12 +5562,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(2.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(2.0/3.0));
 
   // curve test reverse angle 1
   reference_point[0] = 0;
@@ -5494,12 +5601,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test reverse angle 2
   position[0] = 10;
@@ -5516,12 +5623,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test reverse angle 3
   position[0] = 10;
@@ -5538,12 +5645,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(135.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(135.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
   // curve test reverse angle 4
   position[0] = 10;
@@ -5562,12 +5669,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.1 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0011111111));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.1 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0011111111));
 
 
   // curve test reverse angle 5
@@ -5585,12 +5692,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.001 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.000011111111));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.001 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.000011111111));
 
   // curve test reverse angle 6
   slab_segment_angles[0][0][0] = 0.0 * dtr;
@@ -5621,12 +5728,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test reverse angle 6
   position[0] = 10;
@@ -5644,12 +5751,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
   // curve test reverse angle 6
   position[0] = 10;
@@ -5667,12 +5774,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // curve test reverse angle 7
@@ -5691,12 +5798,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(46 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0222222222));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(46 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0222222222));
 
 
 
@@ -5716,12 +5823,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(0.0697227738)); // checked that it should be small positive this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx((90 - 44.4093) * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0131266424));
+  CHECK(distance_from_planes.distance_from_plane == Approx(0.0697227738)); // checked that it should be small positive this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx((90 - 44.4093) * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0131266424));
 
   // curve test reverse angle 9
   position[0] = 10;
@@ -5739,12 +5846,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-0.0692053058)); // checked that it should be small negative this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx((90 - 43.585) * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.031445048));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-0.0692053058)); // checked that it should be small negative this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx((90 - 43.585) * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.031445048));
 
   // curve test reverse angle 10
   position[0] = 10;
@@ -5762,12 +5869,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(1.0));
 
 
   // global_x_list test 1
@@ -5787,12 +5894,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,1,2});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // global_x_list test 2
   position[0] = 10;
@@ -5810,12 +5917,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.25));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(0.25));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // global_x_list test 3
   position[0] = 15;
@@ -5833,12 +5940,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.375));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(0.375));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // global_x_list test 4
   position[0] = 20;
@@ -5856,12 +5963,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
   // global_x_list test 5
   position[0] = 25;
@@ -5878,12 +5985,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-12);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.75));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-12);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-12);
+  CHECK(distance_from_planes.section_fraction == Approx(0.75));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-12);
 
 
 
@@ -5903,12 +6010,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.0));
 
 }
 
@@ -5948,7 +6055,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
 
   double starting_radius = 10;
 
-  std::map<std::string,double> distance_from_planes =
+  Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -5958,12 +6065,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(std::fabs(distance_from_planes["sectionFraction"]) < 1e-14);
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.section_fraction) < 1e-14);
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14);
 
 
   // spherical test 2
@@ -5980,12 +6087,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14);
 
 
   // spherical test 2
@@ -6006,12 +6113,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14);
 
 
 // spherical test 3
@@ -6028,12 +6135,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.25));
+  CHECK(distance_from_planes.distance_from_plane == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.25));
 
 
 // spherical test 4
@@ -6050,12 +6157,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(distance_from_planes.distance_from_plane == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // checked it with a geometric drawing
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.segment_fraction) < 1e-14);
 
 
 // spherical test 5
@@ -6072,12 +6179,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);  // checked it with a geometric drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);  // checked it with a geometric drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.5));
 
 // spherical curve test 1
 // This test has not been checked analytically or with a drawing, but
@@ -6105,12 +6212,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(4.072033215));  // see comment at the top of the test
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(6.6085171895)); // see comment at the top of the test
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.4672927318));
+  CHECK(distance_from_planes.distance_from_plane == Approx(4.072033215));  // see comment at the top of the test
+  CHECK(distance_from_planes.distance_along_plane == Approx(6.6085171895)); // see comment at the top of the test
+  CHECK(distance_from_planes.section_fraction == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.segment_fraction == Approx(0.4672927318));
 }
 
 TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes spherical depth methods")
@@ -6207,6 +6314,945 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
 
 }
 
+TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes segment table")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);
+
+  std::vector<Point<2> > coordinates;
+  coordinates.push_back(Point<2>(0,10,cartesian));
+  coordinates.push_back(Point<2>(20,10,cartesian));
+  coordinates.push_back(Point<2>(40,20,cartesian));
+
+  // Sections with different lengths and curved segments.
+  const double dtr = Utilities::const_pi/180;
+  std::vector<std::vector<double> > slab_segment_lengths(3);
+  std::vector<std::vector<Point<2> > > slab_segment_angles(3);
+  SegmentTable segment_table;
+  segment_table.reinit(3, 3);
+  for (unsigned int section = 0; section < 3; ++section)
+    for (unsigned int segment = 0; segment < 3; ++segment)
+      {
+        const double length = 10 + 5 * section + 20 * segment;
+        const Point<2> angles((20 + 10 * segment) * dtr, (30 + 10 * segment + 5 * section) * dtr, cartesian);
+        slab_segment_lengths[section].push_back(length);
+        slab_segment_angles[section].push_back(angles);
+        segment_table(SegmentTable::length, section, segment) = length;
+        segment_table(SegmentTable::angle_top, section, segment) = angles[0];
+        segment_table(SegmentTable::angle_bottom, section, segment) = angles[1];
+      }
+
+  // Every row of the table starts at a cache line.
+  CHECK(reinterpret_cast<std::uintptr_t>(&segment_table(SegmentTable::length, 1, 0)) % 64 == 0);
+  CHECK(reinterpret_cast<std::uintptr_t>(&segment_table(SegmentTable::angle_bottom, 2, 0)) % 64 == 0);
+  CHECK(segment_table(SegmentTable::length, 2, 1) == Approx(40.0));
+  CHECK(segment_table.memory_usage() > 0);
+
+  const Point<2> reference_point(0,0,cartesian);
+  unsigned int n_on_plane = 0;
+  for (unsigned int i = 0; i < 50; ++i)
+    {
+      const Point<3> position(i * 0.8, 10 + (i % 7) * 3.0, 10 - (i % 11) * 4.0, cartesian);
+      const Utilities::PointDistanceFromCurvedPlanes nested =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     slab_segment_lengths, slab_segment_angles,
+                                                     10, cartesian_system, false);
+      const Utilities::PointDistanceFromCurvedPlanes flat =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     10, cartesian_system, false);
+
+      CHECK(flat.distance_from_plane == nested.distance_from_plane);
+      CHECK(flat.distance_along_plane == nested.distance_along_plane);
+      CHECK(flat.section_fraction == nested.section_fraction);
+      CHECK(flat.segment_fraction == nested.segment_fraction);
+      CHECK(flat.section == nested.section);
+      CHECK(flat.segment == nested.segment);
+      CHECK(flat.average_angle == nested.average_angle);
+      if (std::isfinite(nested.distance_from_plane))
+        ++n_on_plane;
+    }
+  CHECK(n_on_plane > 10);
+}
+
+TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes section index")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);
+
+  // A long, curved trench with many short sections.
+  const unsigned int n_points = 201;
+  std::vector<Point<2> > coordinates;
+  for (unsigned int i = 0; i < n_points; ++i)
+    coordinates.push_back(Point<2>(i * 10.0, 200 + 50 * std::sin(i * 0.05), cartesian));
+
+  const double dtr = Utilities::const_pi/180;
+  const double thickness = 20;
+  SegmentTable segment_table;
+  segment_table.reinit(n_points, 2);
+  for (unsigned int section = 0; section < n_points; ++section)
+    for (unsigned int segment = 0; segment < 2; ++segment)
+      {
+        segment_table(SegmentTable::length, section, segment) = 60 + 10 * segment;
+        segment_table(SegmentTable::angle_top, section, segment) = (30 + 20 * segment) * dtr;
+        segment_table(SegmentTable::angle_bottom, section, segment) = (50 + 20 * segment + (section % 3) * 5) * dtr;
+      }
+
+  SectionIndex section_index;
+  CHECK(!section_index.is_initialized());
+  section_index.reinit(coordinates, 130 + thickness);
+  CHECK(section_index.is_initialized());
+  CHECK(section_index.memory_usage() > 0);
+
+  // Points far away from the trench have no sections.
+  CHECK(section_index.sections(Point<2>(-1000, 200, cartesian)).size() == 0);
+  CHECK(section_index.sections(Point<2>(1000, 5000, cartesian)).size() == 0);
+
+  const Point<2> reference_point(1000,1000,cartesian);
+  unsigned int n_in_slab = 0;
+  for (unsigned int i = 0; i < 400; ++i)
+    {
+      const Point<3> position(i * 5.1 - 10, 50 + (i % 13) * 25.0, 100 - (i % 7) * 15.0, cartesian);
+
+      // The sections are returned in increasing order, and only a few of
+      // them are returned.
+      const SectionIndex::Range sections = section_index.sections(Point<2>(position[0], position[1], cartesian));
+      CHECK(std::is_sorted(sections.begin(), sections.end()));
+      CHECK(sections.size() < n_points / 4);
+
+      const Utilities::PointDistanceFromCurvedPlanes all =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     100, cartesian_system, false);
+      const Utilities::PointDistanceFromCurvedPlanes indexed =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     100, cartesian_system, false,
+                                                     std::vector<double>(), &section_index);
+
+      // Within the reach of the index the result is exact.
+      if (std::fabs(all.distance_from_plane) <= thickness)
+        {
+          CHECK(indexed.distance_from_plane == all.distance_from_plane);
+          CHECK(indexed.distance_along_plane == all.distance_along_plane);
+          CHECK(indexed.section_fraction == all.section_fraction);
+          CHECK(indexed.segment_fraction == all.segment_fraction);
+          CHECK(indexed.section == all.section);
+          CHECK(indexed.segment == all.segment);
+          CHECK(indexed.average_angle == all.average_angle);
+          ++n_in_slab;
+        }
+      else
+        {
+          CHECK(std::fabs(indexed.distance_from_plane) > thickness);
+        }
+    }
+  CHECK(n_in_slab > 20);
+
+  section_index.clear();
+  CHECK(!section_index.is_initialized());
+}
+
+TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes centerline table")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);
+
+  std::vector<Point<2> > coordinates;
+  coordinates.push_back(Point<2>(0,0,cartesian));
+  coordinates.push_back(Point<2>(100,0,cartesian));
+  coordinates.push_back(Point<2>(200,0,cartesian));
+  coordinates.push_back(Point<2>(300,0,cartesian));
+
+  // The angles are the same at the first two coordinates, and change
+  // between the others, where the lengths change as well.
+  const double dtr = Utilities::const_pi/180;
+  SegmentTable segment_table;
+  segment_table.reinit(4, 3);
+  for (unsigned int section = 0; section < 4; ++section)
+    for (unsigned int segment = 0; segment < 3; ++segment)
+      {
+        const double extra_angle = section < 2 ? 0 : 10. * section;
+        segment_table(SegmentTable::length, section, segment) = 50 + 5 * section;
+        segment_table(SegmentTable::angle_top, section, segment) = (20 + 20 * segment) * dtr;
+        segment_table(SegmentTable::angle_bottom, section, segment) = (20 + 20 * segment + (segment == 1 ? 0 : 20 + extra_angle)) * dtr;
+      }
+
+  // Without fractions the table is not built, so that the default results
+  // do not change.
+  CenterlineTable empty_centerline_table;
+  empty_centerline_table.reinit(segment_table, 0);
+  CHECK(!empty_centerline_table.is_initialized());
+
+  // The constant first section has a single sample, and the others have one
+  // sample more than the number of fractions.
+  CenterlineTable centerline_table;
+  CHECK(!centerline_table.is_initialized());
+  centerline_table.reinit(segment_table, 1);
+  CHECK(centerline_table.is_initialized());
+  CHECK(centerline_table.sample(0, 0.3).lower == centerline_table.sample(0, 0.3).upper);
+  CHECK(centerline_table.sample(1, 0.3).lower != centerline_table.sample(1, 0.3).upper);
+
+  CenterlineTable fine_centerline_table;
+  fine_centerline_table.reinit(segment_table, 64);
+  CHECK(fine_centerline_table.sample(1, 0.3).lower != nullptr);
+  CHECK(fine_centerline_table.memory_usage() > centerline_table.memory_usage());
+
+  const Point<2> reference_point(0,-100,cartesian);
+  unsigned int n_in_slab = 0;
+  for (unsigned int i = 0; i < 600; ++i)
+    {
+      const Point<3> position(i * 0.5, -5 - (i % 11) * 9.0, 190 - (i % 17) * 7.0, cartesian);
+      const Utilities::PointDistanceFromCurvedPlanes exact =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     200, cartesian_system, false);
+      const Utilities::PointDistanceFromCurvedPlanes untabulated =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     200, cartesian_system, false,
+                                                     std::vector<double>(), nullptr, &empty_centerline_table);
+      const Utilities::PointDistanceFromCurvedPlanes tabulated =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     200, cartesian_system, false,
+                                                     std::vector<double>(), nullptr, &centerline_table);
+      const Utilities::PointDistanceFromCurvedPlanes interpolated =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     200, cartesian_system, false,
+                                                     std::vector<double>(), nullptr, &fine_centerline_table);
+      // An empty table gives exactly the same results.
+      CHECK(untabulated.distance_from_plane == exact.distance_from_plane);
+      CHECK(untabulated.distance_along_plane == exact.distance_along_plane);
+      CHECK(untabulated.section_fraction == exact.section_fraction);
+      CHECK(untabulated.segment_fraction == exact.segment_fraction);
+
+      if (std::fabs(exact.distance_from_plane) > 20)
+        continue;
+      ++n_in_slab;
+
+      // The single sample of the constant section only differs in the last
+      // digits.
+      if (exact.section == 0 && exact.section_fraction < 0.99)
+        {
+          CHECK(tabulated.distance_from_plane == Approx(exact.distance_from_plane).margin(1e-10));
+          CHECK(tabulated.distance_along_plane == Approx(exact.distance_along_plane).margin(1e-10));
+          CHECK(tabulated.segment == exact.segment);
+        }
+
+      // The interpolated directions are close.
+      CHECK(interpolated.distance_from_plane == Approx(exact.distance_from_plane).margin(1e-3));
+      CHECK(interpolated.distance_along_plane == Approx(exact.distance_along_plane).margin(1e-3));
+      CHECK(interpolated.section_fraction == Approx(exact.section_fraction).margin(1e-8));
+    }
+  CHECK(n_in_slab > 100);
+
+  centerline_table.clear();
+  CHECK(!centerline_table.is_initialized());
+}
+
+TEST_CASE("WorldBuilder Utilities function: distance_points_from_curved_planes")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);
+
+  // A curved trench with straight and curved segments, where the angles
+  // change along the trench.
+  const unsigned int n_coordinates = 21;
+  std::vector<Point<2> > coordinates;
+  for (unsigned int i = 0; i < n_coordinates; ++i)
+    coordinates.push_back(Point<2>(i * 20.0, 100 + 30 * std::sin(i * 0.2), cartesian));
+
+  const double dtr = Utilities::const_pi/180;
+  SegmentTable segment_table;
+  segment_table.reinit(n_coordinates, 3);
+  for (unsigned int section = 0; section < n_coordinates; ++section)
+    for (unsigned int segment = 0; segment < 3; ++segment)
+      {
+        segment_table(SegmentTable::length, section, segment) = 40 + 5 * segment;
+        segment_table(SegmentTable::angle_top, section, segment) = (20 + 20 * segment) * dtr;
+        segment_table(SegmentTable::angle_bottom, section, segment) = (20 + 20 * segment + (segment == 1 ? 0 : 20 + (section % 4) * 5)) * dtr;
+      }
+
+  SectionIndex section_index;
+  section_index.reinit(coordinates, 200);
+  CenterlineTable centerline_table;
+  centerline_table.reinit(segment_table, 16);
+
+  // A number of points which is not a multiple of the block size, with
+  // one point on the trench.
+  const size_t n_points = 301;
+  std::vector<double> x(n_points), y(n_points), z(n_points), start_radii(n_points, 150);
+  for (size_t i = 0; i < n_points; ++i)
+    {
+      x[i] = static_cast<double>(i) * 1.37 - 5;
+      y[i] = 60 + static_cast<double>(i % 23) * 7.0;
+      z[i] = 150 - static_cast<double>(i % 19) * 6.0;
+    }
+  x[100] = coordinates[5][0];
+  y[100] = coordinates[5][1];
+  z[100] = 150;
+
+  const Point<2> reference_point(200,-200,cartesian);
+  for (unsigned int variant = 0; variant < 4; ++variant)
+    {
+      const bool only_positive = variant % 2 == 1;
+      const SectionIndex *index = variant >= 2 ? &section_index : nullptr;
+      const CenterlineTable *table = variant >= 2 ? &centerline_table : nullptr;
+
+      std::vector<Utilities::PointDistanceFromCurvedPlanes> distances(n_points);
+      Utilities::distance_points_from_curved_planes(n_points, &x[0], &y[0], &z[0], &start_radii[0],
+                                                    reference_point, coordinates, segment_table,
+                                                    cartesian_system, only_positive, std::vector<double>(),
+                                                    index, table, &distances[0]);
+
+      unsigned int n_in_slab = 0;
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          const Utilities::PointDistanceFromCurvedPlanes single =
+            Utilities::distance_point_from_curved_planes(Point<3>(x[i], y[i], z[i], cartesian), reference_point, coordinates,
+                                                         segment_table,
+                                                         start_radii[i], cartesian_system, only_positive,
+                                                         std::vector<double>(), index, table);
+
+          // The points are processed in the same way as one by one.
+          CHECK(distances[i].distance_from_plane == single.distance_from_plane);
+          CHECK(distances[i].distance_along_plane == single.distance_along_plane);
+          CHECK(distances[i].section_fraction == single.section_fraction);
+          CHECK(distances[i].segment_fraction == single.segment_fraction);
+          CHECK(distances[i].section == single.section);
+          CHECK(distances[i].segment == single.segment);
+          CHECK(distances[i].average_angle == single.average_angle);
+          if (std::fabs(single.distance_from_plane) < 20)
+            ++n_in_slab;
+        }
+      CHECK(distances[100].distance_from_plane == 0.0);
+      CHECK(n_in_slab > 20);
+    }
+}
+
+TEST_CASE("WorldBuilder Utilities function: slab envelope spherical")
+{
+  std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_spherical.wb";
+  WorldBuilder::World world(file_name);
+
+  const double dtr = Utilities::const_pi/180.0;
+  const double radius = 6371000;
+  std::vector<Point<2> > coordinates;
+  coordinates.push_back(Point<2>(0 * dtr,10 * dtr,spherical));
+  coordinates.push_back(Point<2>(10 * dtr,10 * dtr,spherical));
+  coordinates.push_back(Point<2>(20 * dtr,25 * dtr,spherical));
+
+  const double thickness = 100e3;
+  SegmentTable segment_table;
+  segment_table.reinit(3, 2);
+  for (unsigned int section = 0; section < 3; ++section)
+    for (unsigned int segment = 0; segment < 2; ++segment)
+      {
+        segment_table(SegmentTable::length, section, segment) = 200e3 + 100e3 * segment;
+        segment_table(SegmentTable::angle_top, section, segment) = (20 + 40 * segment) * dtr;
+        segment_table(SegmentTable::angle_bottom, section, segment) = (60 + 30 * segment) * dtr;
+      }
+
+  SlabEnvelope slab_envelope;
+  CHECK(!slab_envelope.is_initialized());
+  CHECK(slab_envelope.may_contain(Point<3>(radius,0,0,cartesian), radius));
+  slab_envelope.reinit(coordinates, 500e3 + thickness);
+  CHECK(slab_envelope.is_initialized());
+  CHECK(slab_envelope.memory_usage() > 0);
+
+  // Every point in the slab is in the envelope, and points far away from
+  // the slab are not.
+  const Point<2> reference_point(0,-30 * dtr,spherical);
+  unsigned int n_in_slab = 0;
+  unsigned int n_rejected = 0;
+  for (unsigned int i = 0; i < 8000; ++i)
+    {
+      const double depth = (i % 13) * 50e3;
+      const std::array<double,3> natural_position = {{radius - depth, (-30 + (i % 101) * 0.6) * dtr, (-20 + (i % 79) * 0.6) * dtr}};
+      const Point<3> position(world.parameters.coordinate_system->natural_to_cartesian_coordinates(natural_position),cartesian);
+
+      const Utilities::PointDistanceFromCurvedPlanes distance =
+        Utilities::distance_point_from_curved_planes(position, reference_point, coordinates,
+                                                     segment_table,
+                                                     radius, world.parameters.coordinate_system, false);
+
+      const bool may_contain = slab_envelope.may_contain(position, radius);
+      if (std::fabs(distance.distance_from_plane) <= thickness)
+        {
+          CHECK(may_contain);
+          ++n_in_slab;
+        }
+      if (!may_contain)
+        ++n_rejected;
+    }
+  CHECK(n_in_slab > 20);
+  CHECK(n_rejected > 1000);
+  CHECK(!slab_envelope.may_contain(Point<3>(world.parameters.coordinate_system->natural_to_cartesian_coordinates({{radius, 180 * dtr, 0}}),cartesian), radius));
+
+  slab_envelope.clear();
+  CHECK(!slab_envelope.is_initialized());
+}
+
+TEST_CASE("WorldBuilder Utilities function: distance field")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);
+
+  std::vector<Point<2> > coordinates;
+  coordinates.push_back(Point<2>(0,0,cartesian));
+  coordinates.push_back(Point<2>(100,0,cartesian));
+  coordinates.push_back(Point<2>(200,0,cartesian));
+
+  // Two straight segments, so that the distances are linear within every
+  // segment, and the interpolation is exact.
+  const double dtr = Utilities::const_pi/180;
+  const double thickness = 20;
+  SegmentTable segment_table;
+  segment_table.reinit(3, 2);
+  for (unsigned int section = 0; section < 3; ++section)
+    for (unsigned int segment = 0; segment < 2; ++segment)
+      {
+        segment_table(SegmentTable::length, section, segment) = 50;
+        segment_table(SegmentTable::angle_top, section, segment) = (30 + 30 * segment) * dtr;
+        segment_table(SegmentTable::angle_bottom, section, segment) = (30 + 30 * segment) * dtr;
+      }
+
+  const Point<2> reference_point(0,-100,cartesian);
+  const double surface = 200;
+  const DistanceField::Function exact = [&](const std::array<double,3> &point)
+  {
+    return Utilities::distance_point_from_curved_planes(Point<3>(point[0], point[1], surface - point[2], cartesian),
+                                                        reference_point, coordinates, segment_table, surface,
+                                                        cartesian_system, false);
+  };
+
+  DistanceField distance_field;
+  Utilities::PointDistanceFromCurvedPlanes distance;
+  CHECK(!distance_field.is_initialized());
+  CHECK(!distance_field.interpolate({{50, 10, 10}}, distance));
+
+  distance_field.reinit({{-20, -20, 0}}, {{220, 120, 120}}, 2, 1e-3, thickness + std::sqrt(3.) * 2, 100, exact);
+  CHECK(distance_field.is_initialized());
+  CHECK(distance_field.n_interpolated_cells() > 0);
+  CHECK(distance_field.n_interpolated_cells() < distance_field.n_cells());
+  CHECK(distance_field.memory_usage() > 0);
+
+  // Points outside the grid are not interpolated.
+  CHECK(!distance_field.interpolate({{-30, 10, 10}}, distance));
+  CHECK(!distance_field.interpolate({{50, 10, -1}}, distance));
+
+  unsigned int n_interpolated = 0;
+  unsigned int n_outside = 0;
+  for (unsigned int i = 0; i < 2000; ++i)
+    {
+      const std::array<double,3> point = {{(i % 199) * 1.01, -10 + (i % 53) * 2.03, (i % 37) * 2.71}};
+      if (!distance_field.interpolate(point, distance))
+        continue;
+
+      const Utilities::PointDistanceFromCurvedPlanes exact_distance = exact(point);
+      if (std::isinf(distance.distance_from_plane))
+        {
+          // The point is outside the band.
+          CHECK(!(std::fabs(exact_distance.distance_from_plane) <= thickness));
+          ++n_outside;
+          continue;
+        }
+
+      CHECK(distance.distance_from_plane == Approx(exact_distance.distance_from_plane).margin(1e-6));
+      CHECK(distance.distance_along_plane == Approx(exact_distance.distance_along_plane).margin(1e-6));
+      CHECK(distance.section_fraction == Approx(exact_distance.section_fraction).margin(1e-8));
+      CHECK(distance.segment_fraction == Approx(exact_distance.segment_fraction).margin(1e-8));
+      CHECK(distance.segment == exact_distance.segment);
+      ++n_interpolated;
+    }
+  CHECK(n_interpolated > 50);
+  CHECK(n_outside > 100);
+
+  distance_field.clear();
+  CHECK(!distance_field.is_initialized());
+  CHECK(!distance_field.interpolate({{50, 10, 10}}, distance));
+
+  // A small part of a plane inside a cell, of which the nodes and the center
+  // are not next to any section. Such a cell can not be outside the band.
+  const DistanceField::Function small_plane = [](const std::array<double,3> &point)
+  {
+    Utilities::PointDistanceFromCurvedPlanes small_plane_distance;
+    const double dx = point[0] - 3;
+    const double dy = point[1] - 3;
+    const double dz = point[2] - 3;
+    if (dx * dx + dy * dy + dz * dz < 1)
+      {
+        small_plane_distance.distance_from_plane = dz;
+        small_plane_distance.distance_along_plane = dx;
+      }
+    else if (point[0] >= 10)
+      {
+        small_plane_distance.distance_from_plane = 100;
+        small_plane_distance.distance_along_plane = 0;
+      }
+    return small_plane_distance;
+  };
+  distance_field.reinit({{0, 0, 0}}, {{20, 10, 10}}, 10, 1e-3, 5, 100, small_plane);
+  CHECK(!distance_field.interpolate({{3, 3, 3}}, distance));
+
+  // The cells of which the nodes and the center are far from the plane are
+  // outside the band.
+  CHECK(distance_field.interpolate({{15, 5, 5}}, distance));
+  CHECK(std::isinf(distance.distance_from_plane));
+}
+
+TEST_CASE("WorldBuilder Features: Subducting plate distance field")
+{
+  // The file contains the same slab twice, 3000 km apart, where the
+  // distances of the second one are interpolated from a distance field.
+  std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_distance_field_cartesian.wb";
+  WorldBuilder::World world(file_name);
+
+  const std::vector<std::pair<std::string,std::size_t> > components = world.memory_usage();
+  bool has_distance_field = false;
+  for (auto &component : components)
+    if (component.first == "Interpolated subducting plate: distance field")
+      has_distance_field = true;
+  CHECK(has_distance_field);
+
+  unsigned int n_in_slab = 0;
+  unsigned int n_different = 0;
+  for (unsigned int i = 0; i < 2000; ++i)
+    {
+      const double depth = (i % 41) * 10e3;
+      const std::array<double,3> position = {{(i % 97) * 10.3e3, 400e3 + (i % 59) * 7.1e3, 1000e3 - depth}};
+      const std::array<double,3> translated_position = {{position[0], position[1] + 3000e3, position[2]}};
+
+      const double exact_composition = world.composition(position, depth, 0);
+      const double interpolated_composition = world.composition(translated_position, depth, 1);
+      if (exact_composition > 0.5)
+        {
+          ++n_in_slab;
+          const double exact_temperature = world.temperature(position, depth, 10);
+          const double interpolated_temperature = world.temperature(translated_position, depth, 10);
+          if (interpolated_composition > 0.5)
+            CHECK(interpolated_temperature == Approx(exact_temperature).epsilon(1e-3));
+        }
+      if ((exact_composition > 0.5) != (interpolated_composition > 0.5))
+        ++n_different;
+    }
+
+  // Only points within the tolerance of the boundary of the slab may be
+  // in only one of the slabs.
+  CHECK(n_in_slab > 100);
+  CHECK(n_different < n_in_slab / 100 + 1);
+}
+
+TEST_CASE("WorldBuilder World: batched slab and fault queries")
+{
+  // The batched functions of the world process the points of the slabs
+  // and faults together, which gives the same results as one by one.
+  const std::vector<std::string> files = {"subducting_plate_different_angles_cartesian.wb",
+                                          "fault_different_angles_cartesian.wb",
+                                          "subducting_plate_distance_field_cartesian.wb"
+                                         };
+  for (auto &file : files)
+    {
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file);
+
+      const size_t n_points = 1003;
+      std::vector<double> x(n_points), y(n_points), z(n_points), depth(n_points), gravity(n_points, 10);
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          depth[i] = static_cast<double>(i % 41) * 10e3;
+          x[i] = static_cast<double>(i % 97) * 20.3e3;
+          y[i] = static_cast<double>(i % 59) * 30.1e3;
+          z[i] = 1000e3 - depth[i];
+        }
+
+      const unsigned int n_compositions = 4;
+      std::vector<double> temperatures(n_points), compositions(n_compositions * n_points);
+      world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &temperatures[0]);
+      world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &compositions[0]);
+
+      unsigned int n_changed = 0;
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          const std::array<double,3> position = {{x[i], y[i], z[i]}};
+          const double temperature = world.temperature(position, depth[i], gravity[i]);
+          CHECK(temperatures[i] == temperature);
+          for (unsigned int c = 0; c < n_compositions; ++c)
+            {
+              CHECK(compositions[i * n_compositions + c] == world.composition(position, depth[i], c));
+              if (compositions[i * n_compositions + c] > 0)
+                ++n_changed;
+            }
+        }
+      CHECK(n_changed > 0);
+    }
+}
+
+TEST_CASE("WorldBuilder World: query hints")
+{
+  // The query hints reuse what was found for the previous point, which
+  // gives the same results as searching every point in full.
+  const std::vector<std::string> files = {"subducting_plate_different_angles_cartesian.wb",
+                                          "fault_different_angles_cartesian.wb",
+                                          "oceanic_plate_cartesian.wb",
+                                          "continental_plate.wb",
+                                          "mantle_layer_cartesian.wb",
+                                          "subducting_plate_different_angles_spherical.wb",
+                                          "oceanic_plate_spherical.wb"
+                                         };
+  for (auto &file : files)
+    {
+      const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file;
+      WorldBuilder::World world(file_name);
+      WorldBuilder::World world_with_hints(file_name);
+      world_with_hints.query_hints.set_enabled(true);
+      const bool spherical = world.parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical;
+
+      // The points are queried in the order of a mesh.
+      const unsigned int n_compositions = 4;
+      for (unsigned int i_depth = 0; i_depth < 3; ++i_depth)
+        for (unsigned int i_y = 0; i_y < 20; ++i_y)
+          for (unsigned int i_x = 0; i_x < 80; ++i_x)
+            {
+              const double depth = 10e3 + i_depth * 75e3;
+              std::array<double,3> position;
+              if (spherical)
+                {
+                  const double radius = 6371e3 - depth;
+                  const double longitude = (-20. + i_x * 0.5) * Utilities::const_pi / 180.;
+                  const double latitude = (-20. + i_y * 2.1) * Utilities::const_pi / 180.;
+                  position = {{radius * std::cos(latitude) * std::cos(longitude),
+                               radius * std::cos(latitude) * std::sin(longitude),
+                               radius * std::sin(latitude)
+                              }
+                             };
+                }
+              else
+                position = {{i_x * 25.3e3, i_y * 101.3e3, 1000e3 - depth}};
+
+              CHECK(world_with_hints.temperature(position, depth, 10) == world.temperature(position, depth, 10));
+              for (unsigned int c = 0; c < n_compositions; ++c)
+                CHECK(world_with_hints.composition(position, depth, c) == world.composition(position, depth, c));
+            }
+
+      unsigned long long lookups = 0;
+      unsigned long long hits = 0;
+      for (unsigned int entry = 0; entry < world.parameters.features.size(); ++entry)
+        {
+          CHECK(world.query_hints.get_counters(entry).first == 0);
+          const std::pair<unsigned long long,unsigned long long> counters = world_with_hints.query_hints.get_counters(entry);
+          lookups += counters.first;
+          hits += counters.second;
+        }
+      CHECK(hits > 0);
+      CHECK(hits <= lookups);
+      CHECK(world_with_hints.query_hints.report().find("hit rate") != std::string::npos);
+    }
+}
+
+TEST_CASE("WorldBuilder ThreadSlots")
+{
+  // A thread which exits returns its slot, so starting a new thread for
+  // every call does not create a new slot for every call, and the values
+  // of the returned slots are kept.
+  WorldBuilder::ThreadSlots<unsigned int> slots;
+  for (unsigned int call = 0; call < 10; ++call)
+    {
+      std::vector<std::thread> threads;
+      for (unsigned int i = 0; i < 3; ++i)
+        threads.push_back(std::thread([&slots]()
+      {
+        ++slots.get(2)[1];
+      }));
+      for (auto &thread : threads)
+        thread.join();
+    }
+  CHECK(slots.n_slots() <= 3);
+
+  unsigned int total = 0;
+  slots.for_each([&total](const std::vector<unsigned int> &values)
+  {
+    CHECK(values.size() == 2);
+    total += values[1];
+  });
+  CHECK(total == 30);
+
+  // A thread which exits after the slots have been destroyed does not
+  // return its slot.
+  std::unique_ptr<WorldBuilder::ThreadSlots<unsigned int> > destroyed_slots(new WorldBuilder::ThreadSlots<unsigned int>());
+  std::thread thread([&destroyed_slots]()
+  {
+    destroyed_slots->get(1);
+    destroyed_slots.reset();
+  });
+  thread.join();
+}
+
+TEST_CASE("WorldBuilder DepthIntervalIndex")
+{
+  DepthIntervalIndex index;
+  CHECK(index.active(10).size() == 0);
+
+  index.build({{0, 100}, {50, 200}, {-INFINITY, 50}, {100, INFINITY}, {0, 100}});
+  CHECK(index.all() == std::vector<unsigned int>({0, 1, 2, 3, 4}));
+  CHECK(index.active(-10) == std::vector<unsigned int>({2}));
+  CHECK(index.active(0) == std::vector<unsigned int>({0, 2, 4}));
+  CHECK(index.active(25) == std::vector<unsigned int>({0, 2, 4}));
+  CHECK(index.active(50) == std::vector<unsigned int>({0, 1, 2, 4}));
+  CHECK(index.active(75) == std::vector<unsigned int>({0, 1, 4}));
+  CHECK(index.active(100) == std::vector<unsigned int>({0, 1, 3, 4}));
+  CHECK(index.active(150) == std::vector<unsigned int>({1, 3}));
+  CHECK(index.active(200) == std::vector<unsigned int>({1, 3}));
+  CHECK(index.active(1e300) == std::vector<unsigned int>({3}));
+  CHECK(index.memory_usage() > 0);
+
+  // The result is the same as checking every range.
+  const std::vector<std::pair<double,double> > ranges = {{0, 300e3}, {100e3, 660e3}, {0, 100e3}, {410e3, 660e3}, {660e3, 2890e3}};
+  index.build(ranges);
+  for (double depth = -10e3; depth < 3000e3; depth += 5e3)
+    {
+      std::vector<unsigned int> expected;
+      for (unsigned int entry = 0; entry < ranges.size(); ++entry)
+        if (depth >= ranges[entry].first && depth <= ranges[entry].second)
+          expected.push_back(entry);
+      CHECK(index.active(depth) == expected);
+    }
+
+  CHECK_THROWS_WITH(index.build({{0, NAN}}),
+                    Contains("The depth range of entry 0 of a depth interval index is not a number."));
+}
+
+TEST_CASE("WorldBuilder World: depth interval index")
+{
+  // Only the features and models which can change the values at a depth are
+  // called. While the profiler is enabled, all of them are called, so that
+  // gives the reference values.
+  const std::vector<std::string> files = {WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_replace.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/oceanic_plate_cartesian.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/mantle_layer_cartesian.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb"
+                                         };
+  for (auto &file : files)
+    {
+      WorldBuilder::World world(file);
+      WorldBuilder::World reference_world(file);
+      reference_world.profiler.set_enabled(true);
+
+      const size_t n_points = 1003;
+      std::vector<double> x(n_points), y(n_points), z(n_points), depth(n_points), gravity(n_points, 10);
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          depth[i] = static_cast<double>(i % 41) * 10e3;
+          x[i] = static_cast<double>(i % 97) * 20.3e3;
+          y[i] = static_cast<double>(i % 59) * 30.1e3;
+          z[i] = 1000e3 - depth[i];
+        }
+
+      const unsigned int n_compositions = 7;
+      std::vector<double> temperatures(n_points), reference_temperatures(n_points);
+      std::vector<double> compositions(n_compositions * n_points), reference_compositions(n_compositions * n_points);
+      world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &temperatures[0]);
+      reference_world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &reference_temperatures[0]);
+      world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &compositions[0]);
+      reference_world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &reference_compositions[0]);
+      CHECK(temperatures == reference_temperatures);
+      CHECK(compositions == reference_compositions);
+
+      for (size_t i = 0; i < n_points; i += 7)
+        {
+          const std::array<double,3> position = {{x[i], y[i], z[i]}};
+          CHECK(world.temperature(position, depth[i], gravity[i]) == reference_temperatures[i]);
+          for (unsigned int c = 0; c < n_compositions; ++c)
+            CHECK(world.composition(position, depth[i], c) == reference_compositions[i * n_compositions + c]);
+        }
+    }
+
+  // A slab can not reach deeper than its segments.
+  WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb");
+  const std::pair<double,double> range = world.parameters.features[0]->depth_range();
+  CHECK(range.first <= 0);
+  CHECK(std::isfinite(range.second));
+}
+
+TEST_CASE("WorldBuilder SpatialOrder")
+{
+  CHECK(SpatialOrder::morton_key(1,0,0) == 1);
+  CHECK(SpatialOrder::morton_key(0,1,0) == 2);
+  CHECK(SpatialOrder::morton_key(0,0,1) == 4);
+  CHECK(SpatialOrder::morton_key(3,3,3) == 63);
+  CHECK(SpatialOrder::morton_key(0x1fffff,0x1fffff,0x1fffff) == 0x7fffffffffffffffULL);
+  CHECK(SpatialOrder::morton_key(0x200000,0,0) == 0);
+
+  // The radix sort is stable, so it gives the same order as std::stable_sort
+  // for any number of threads. The keys have many duplicates.
+  const size_t n_keys = 200000;
+  std::vector<std::uint64_t> keys(n_keys);
+  std::uint64_t state = 1;
+  for (auto &key : keys)
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      key = (state >> 11) % 50000 * 0x100000001ULL;
+    }
+  std::vector<size_t> expected(n_keys);
+  for (size_t i = 0; i < n_keys; ++i)
+    expected[i] = i;
+  std::stable_sort(expected.begin(), expected.end(), [&](const size_t a, const size_t b)
+  {
+    return keys[a] < keys[b];
+  });
+
+  for (unsigned int n_threads : {1u, 4u, 0u})
+    {
+      std::vector<size_t> permutation;
+      SpatialOrder::radix_sort(keys, permutation, n_threads);
+      CHECK(permutation == expected);
+    }
+
+  // Points on a line are ordered along the line, in any coordinate system.
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", nullptr);
+  const std::vector<double> x = {3, 0, 2, 1}, y = {0, 0, 0, 0}, z = {5, 5, 5, 5};
+  SpatialOrder order;
+  std::vector<size_t> permutation;
+  order.compute_permutation(4, &x[0], &y[0], &z[0], *cartesian_system, permutation);
+  CHECK(permutation == std::vector<size_t>({1, 3, 2, 0}));
+}
+
+TEST_CASE("WorldBuilder World: spatial order")
+{
+  // Evaluating the points of the batched functions in spatial order gives
+  // the same results in the same order as evaluating them as given.
+  const std::vector<std::string> files = {"subducting_plate_different_angles_cartesian.wb",
+                                          "fault_different_angles_cartesian.wb",
+                                          "oceanic_plate_cartesian.wb",
+                                          "continental_plate.wb",
+                                          "subducting_plate_different_angles_spherical.wb"
+                                         };
+  for (auto &file : files)
+    {
+      const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file;
+      WorldBuilder::World world(file_name);
+      WorldBuilder::World ordered_world(file_name);
+      ordered_world.spatial_order.set_enabled(true);
+      ordered_world.spatial_order.set_n_threads(2);
+      const bool spherical = world.parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical;
+
+      const size_t n_points = 1003;
+      std::vector<double> x(n_points), y(n_points), z(n_points), depth(n_points), gravity(n_points, 10);
+      std::uint64_t state = 3;
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          const double u = static_cast<double>(state >> 11) / 9007199254740992.0;
+          state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+          const double v = static_cast<double>(state >> 11) / 9007199254740992.0;
+          depth[i] = static_cast<double>(i % 41) * 10e3;
+          if (spherical)
+            {
+              const double radius = 6371e3 - depth[i];
+              const double longitude = (-20. + 40. * u) * Utilities::const_pi / 180.;
+              const double latitude = (-20. + 40. * v) * Utilities::const_pi / 180.;
+              x[i] = radius * std::cos(latitude) * std::cos(longitude);
+              y[i] = radius * std::cos(latitude) * std::sin(longitude);
+              z[i] = radius * std::sin(latitude);
+            }
+          else
+            {
+              x[i] = 2000e3 * u;
+              y[i] = 2000e3 * v;
+              z[i] = 1000e3 - depth[i];
+            }
+        }
+
+      const unsigned int n_compositions = 3;
+      std::vector<double> temperatures(n_points), ordered_temperatures(n_points);
+      std::vector<double> compositions(n_compositions * n_points), ordered_compositions(n_compositions * n_points);
+      world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &temperatures[0]);
+      ordered_world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &ordered_temperatures[0]);
+      world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &compositions[0]);
+      ordered_world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &ordered_compositions[0]);
+      CHECK(ordered_temperatures == temperatures);
+      CHECK(ordered_compositions == compositions);
+
+      if (!spherical)
+        {
+          // The 2d functions use the x and z coordinates.
+          world.temperatures(n_points, &x[0], &z[0], &depth[0], &gravity[0], &temperatures[0]);
+          ordered_world.temperatures(n_points, &x[0], &z[0], &depth[0], &gravity[0], &ordered_temperatures[0]);
+          world.compositions(n_points, &x[0], &z[0], &depth[0], n_compositions, &compositions[0]);
+          ordered_world.compositions(n_points, &x[0], &z[0], &depth[0], n_compositions, &ordered_compositions[0]);
+          CHECK(ordered_temperatures == temperatures);
+          CHECK(ordered_compositions == compositions);
+        }
+    }
+}
+
+TEST_CASE("WorldBuilder World: reverse evaluation")
+{
+  // A feature only tells that it replaces a value when it is certain.
+  {
+    WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_replace.wb");
+    const Point<3> inside_both(250e3, 750e3, 800e3, cartesian);
+    const Point<3> outside(250e3, 1250e3, 800e3, cartesian);
+    CHECK(world.parameters.features[0]->replaces_temperature(inside_both, 100e3) == true);
+    CHECK(world.parameters.features[2]->replaces_temperature(inside_both, 100e3) == true);
+    CHECK(world.parameters.features[2]->replaces_temperature(inside_both, 260e3) == false);
+    CHECK(world.parameters.features[2]->replaces_temperature(outside, 100e3) == false);
+    CHECK(world.parameters.features[0]->replaces_composition(inside_both, 100e3, 3) == false);
+    CHECK(world.parameters.features[2]->replaces_composition(inside_both, 100e3, 3) == true);
+    CHECK(world.parameters.features[2]->replaces_composition(inside_both, 100e3, 0) == true);
+  }
+  {
+    WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_add.wb");
+    CHECK(world.parameters.features[2]->replaces_temperature(Point<3>(250e3, 750e3, 800e3, cartesian), 100e3) == false);
+  }
+  {
+    WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb");
+    CHECK(world.parameters.features[0]->replaces_temperature(Point<3>(250e3, 500e3, 800e3, cartesian), 100e3) == false);
+  }
+
+  // Evaluating only the features from the last one which replaces the
+  // value gives the same results as evaluating all of them.
+  const std::vector<std::string> files = {WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_replace.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_add.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/app/app_operations_subtract.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/oceanic_plate_cartesian.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/mantle_layer_cartesian.wb",
+                                          WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb"
+                                         };
+  for (auto &file : files)
+    {
+      WorldBuilder::World world(file);
+      WorldBuilder::World reverse_world(file);
+      reverse_world.reverse_evaluation = true;
+
+      const size_t n_points = 1003;
+      std::vector<double> x(n_points), y(n_points), z(n_points), depth(n_points), gravity(n_points, 10);
+      for (size_t i = 0; i < n_points; ++i)
+        {
+          depth[i] = static_cast<double>(i % 41) * 10e3;
+          x[i] = static_cast<double>(i % 97) * 20.3e3;
+          y[i] = static_cast<double>(i % 59) * 30.1e3;
+          z[i] = 1000e3 - depth[i];
+        }
+
+      const unsigned int n_compositions = 7;
+      std::vector<double> temperatures(n_points), reverse_temperatures(n_points);
+      std::vector<double> compositions(n_compositions * n_points), reverse_compositions(n_compositions * n_points);
+      world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &temperatures[0]);
+      reverse_world.temperatures(n_points, &x[0], &y[0], &z[0], &depth[0], &gravity[0], &reverse_temperatures[0]);
+      world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &compositions[0]);
+      reverse_world.compositions(n_points, &x[0], &y[0], &z[0], &depth[0], n_compositions, &reverse_compositions[0]);
+      CHECK(reverse_temperatures == temperatures);
+      CHECK(reverse_compositions == compositions);
+
+      for (size_t i = 0; i < n_points; i += 7)
+        {
+          const std::array<double,3> position = {{x[i], y[i], z[i]}};
+          CHECK(reverse_world.temperature(position, depth[i], gravity[i]) == temperatures[i]);
+          for (unsigned int c = 0; c < n_compositions; ++c)
+            CHECK(reverse_world.composition(position, depth[i], c) == compositions[i * n_compositions + c]);
+        }
+    }
+}
+
 TEST_CASE("WorldBuilder parameters: invalid 1")
 {
 
@@ -6215,3 +7261,224 @@ TEST_CASE("WorldBuilder parameters: invalid 1")
 
 }
 
+TEST_CASE("WorldBuilder World: performance report")
+{
+  std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb";
+  WorldBuilder::World world(file_name);
+
+  const std::array<double,3> inside_first_plate = {{250e3,750e3,800e3}};
+  const std::array<double,3> outside_first_plate = {{1500e3,1500e3,800e3}};
+
+  // Nothing is collected while the profiler is disabled.
+  world.temperature(inside_first_plate, 10e3, 10);
+  CHECK(world.profiler.get_counters(0, Profiler::temperature).calls == 0);
+
+  world.profiler.set_enabled(true);
+  world.temperature(inside_first_plate, 10e3, 10);
+  world.temperature(outside_first_plate, 10e3, 10);
+  world.temperature(inside_first_plate, 300e3, 10);
+
+  Profiler::Counters counters = world.profiler.get_counters(0, Profiler::temperature);
+  CHECK(counters.calls == 3);
+  CHECK(counters.hits == 1);
+  CHECK(counters.early_rejects == 2);
+  CHECK(counters.time >= 0);
+  CHECK(world.profiler.get_counters(0, Profiler::composition).calls == 0);
+
+  // The counters of all the threads are merged.
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < 4; ++i)
+    threads.emplace_back([&]()
+    {
+      for (unsigned int j = 0; j < 10; ++j)
+        world.composition(inside_first_plate, 10e3, 0);
+    });
+  for (auto &thread : threads)
+    thread.join();
+
+  counters = world.profiler.get_counters(0, Profiler::composition);
+  CHECK(counters.calls == 40);
+  CHECK(counters.hits == 40);
+
+  CHECK_THAT(world.performance_report(), Contains("First continental plate"));
+  CHECK_THAT(world.performance_report(), Contains("early rejects"));
+
+  world.profiler.reset();
+  CHECK(world.profiler.get_counters(0, Profiler::composition).calls == 0);
+  CHECK_THROWS_WITH(world.profiler.get_counters(1000, Profiler::temperature), Contains("does not exist"));
+  CHECK_THROWS_WITH(world.profiler.get_model_entry(&world), Contains("not registered"));
+}
+
+TEST_CASE("WorldBuilder Parameters: validation cache")
+{
+  // A file which has been validated before is not validated again, but a
+  // file with a different content always is, even when the difference
+  // cancels out in a hash, like two identical extra members.
+  const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb";
+  std::string content;
+  {
+    std::ifstream file(file_name.c_str());
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+  }
+  WorldBuilder::World world(file_name);
+
+  const std::string changed_file_name = temporary_file_name("world_builder_unit_test_validation_cache.wb");
+  {
+    std::ofstream file(changed_file_name.c_str());
+    file << "{\"x\":[],\"x\":[]," << content.substr(content.find('{') + 1);
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World(changed_file_name), Contains("Invalid"));
+
+  // The same content in another file is found in the cache.
+  {
+    std::ofstream file(changed_file_name.c_str());
+    file << content;
+  }
+  std::string trace_file_name = temporary_file_name("world_builder_unit_test_validation_cache_trace.json");
+  WorldBuilder::World cached_world(changed_file_name, false, "", trace_file_name);
+  CHECK_THAT(cached_world.trace.to_json(), Contains("\"cached\":\"true\""));
+
+  std::remove(changed_file_name.c_str());
+  std::remove(trace_file_name.c_str());
+}
+
+TEST_CASE("WorldBuilder World: startup trace")
+{
+  std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb";
+  std::string trace_file_name = temporary_file_name("world_builder_unit_test_startup_trace.json");
+  WorldBuilder::World world(file_name, false, "", trace_file_name);
+
+  std::ifstream trace_file(trace_file_name.c_str());
+  REQUIRE(trace_file.good());
+  std::stringstream buffer;
+  buffer << trace_file.rdbuf();
+
+  rapidjson::Document trace;
+  trace.Parse(buffer.str().c_str());
+  REQUIRE(!trace.HasParseError());
+  REQUIRE(trace.HasMember("traceEvents"));
+
+  std::vector<std::string> names;
+  std::vector<std::string> features;
+  for (auto &event : trace["traceEvents"].GetArray())
+    {
+      CHECK(std::string(event["ph"].GetString()) == "X");
+      CHECK(event["dur"].GetDouble() >= 0);
+      names.push_back(event["name"].GetString());
+      if (names.back() == "Features::Interface::parse_entries")
+        features.push_back(event["args"]["name"].GetString());
+    }
+
+  CHECK(std::count(names.begin(), names.end(), "World::World") == 1);
+  CHECK(std::count(names.begin(), names.end(), "Parameters::initialize") == 1);
+  CHECK(std::count(names.begin(), names.end(), "validate world builder file") == 1);
+  CHECK(std::count(names.begin(), names.end(), "World::parse_entries") == 1);
+  CHECK(std::count(names.begin(), names.end(), "Features::Interface::get_coordinates") == 6);
+  REQUIRE(features.size() == 6);
+  CHECK(features[0] == "First continental plate");
+  trace_file.close();
+  std::remove(trace_file_name.c_str());
+
+  // Without a trace file, nothing is recorded.
+  WorldBuilder::World world_without_trace(file_name);
+  CHECK(!world_without_trace.trace.is_enabled());
+  CHECK_THAT(world_without_trace.trace.to_json(), Contains("\"traceEvents\":[]"));
+}
+
+TEST_CASE("WorldBuilder World: snapshot")
+{
+  const std::vector<std::string> file_names = {"/tests/performance/slab_heavy.wb",
+                                               "/tests/data/subducting_plate_different_angles_spherical.wb",
+                                               "/tests/data/fault_constant_angles_cartesian_2.wb",
+                                               "/tests/data/interpolation_monotone_spline_cartesian.wb"
+                                              };
+  const std::string snapshot_file_name = temporary_file_name("world_builder_unit_test_snapshot.wbsnap");
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + file_name);
+      world.write_snapshot(snapshot_file_name);
+
+      WorldBuilder::World loaded_world(snapshot_file_name);
+      CHECK(loaded_world.parameters.features.size() == world.parameters.features.size());
+      CHECK(loaded_world.parameters.coordinate_system->get_plugin_name()
+            == world.parameters.coordinate_system->get_plugin_name());
+      CHECK(loaded_world.potential_mantle_temperature == world.potential_mantle_temperature);
+      CHECK(loaded_world.interpolation == world.interpolation);
+
+      const bool is_spherical = world.parameters.coordinate_system->natural_coordinate_system() == WorldBuilder::spherical;
+      for (unsigned int i = 0; i < 500; ++i)
+        {
+          std::array<double,3> point = {{i * 10e3, (i % 20) * 100e3, 1000e3 - (i % 7) * 50e3}};
+          if (is_spherical)
+            point = WorldBuilder::Utilities::spherical_to_cartesian_coordinates({{6371e3 - (i % 7) * 50e3, i * 0.0005, (i % 20) * 0.02}}).get_array();
+          const double depth = (i % 13) * 20e3;
+          CHECK(loaded_world.temperature(point, depth, 10) == world.temperature(point, depth, 10));
+          for (unsigned int composition = 0; composition < 7; ++composition)
+            CHECK(loaded_world.composition(point, depth, composition) == world.composition(point, depth, composition));
+        }
+    }
+
+  // The cross section is stored as well.
+  const std::array<double,2> point_2d = {{250e3, 500e3}};
+  WorldBuilder::World world_2d(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/oceanic_plate_cartesian.wb");
+  world_2d.write_snapshot(snapshot_file_name);
+  WorldBuilder::World loaded_world_2d(snapshot_file_name);
+  CHECK(loaded_world_2d.temperature(point_2d, 10e3, 10) == world_2d.temperature(point_2d, 10e3, 10));
+  CHECK(loaded_world_2d.composition(point_2d, 10e3, 0) == world_2d.composition(point_2d, 10e3, 0));
+
+  // A file which is not a snapshot is parsed as a world builder file.
+  CHECK(!WorldBuilder::Snapshot::is_snapshot(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb"));
+  CHECK(WorldBuilder::Snapshot::is_snapshot(snapshot_file_name));
+
+  // A snapshot which ends early or contains extra data is corrupt.
+  std::string snapshot;
+  {
+    std::ifstream snapshot_file(snapshot_file_name.c_str(), std::ios::binary);
+    std::stringstream buffer;
+    buffer << snapshot_file.rdbuf();
+    snapshot = buffer.str();
+  }
+  {
+    std::ofstream snapshot_file(snapshot_file_name.c_str(), std::ios::binary);
+    snapshot_file << snapshot.substr(0, snapshot.size() / 2);
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World(snapshot_file_name), Contains("The snapshot is corrupt"));
+  {
+    std::ofstream snapshot_file(snapshot_file_name.c_str(), std::ios::binary);
+    snapshot_file << snapshot << "extra";
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World(snapshot_file_name), Contains("5 bytes were not read"));
+
+  // A snapshot of another format version is rejected.
+  {
+    std::ofstream snapshot_file(snapshot_file_name.c_str(), std::ios::binary);
+    std::string other_version = snapshot;
+    other_version[12] = 99;
+    snapshot_file << other_version;
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World(snapshot_file_name), Contains("has format version 99"));
+
+  // A corrupt size of a container is reported before the container is
+  // allocated. The first container is the version string after the magic
+  // bytes, the byte order mark and the format version, and the second one
+  // is the cross section after it.
+  const size_t version_size_offset = 16;
+  std::uint64_t version_size = 0;
+  std::memcpy(&version_size, &snapshot[version_size_offset], sizeof(version_size));
+  for (const size_t offset : {version_size_offset, version_size_offset + 8 + static_cast<size_t>(version_size)})
+    for (const std::uint64_t size : {std::numeric_limits<std::uint64_t>::max(), static_cast<std::uint64_t>(1) << 40})
+      {
+        std::string corrupt = snapshot;
+        std::memcpy(&corrupt[offset], &size, sizeof(size));
+        {
+          std::ofstream snapshot_file(snapshot_file_name.c_str(), std::ios::binary);
+          snapshot_file << corrupt;
+        }
+        CHECK_THROWS_WITH(WorldBuilder::World(snapshot_file_name), Contains("The snapshot is corrupt: a container has"));
+      }
+
+  std::remove(snapshot_file_name.c_str());
+}
@@ -216,6 +216,8 @@ int main(int argc, char **argv)
   double z_max = NaN::DSNAN; // z or outer_radius
 
   size_t number_of_threads = 1;
+  const bool profile = find_command_line_option(argv, argv+argc, "--profile");
+  const bool query_hints = find_command_line_option(argv, argv+argc, "--query-hints");
 
   try
     {
@@ -226,11 +228,15 @@ int main(int argc, char **argv)
                     "The data file will be filled with intitial conditions from the world as set by the world builder file." << std::endl
                     << "Besides providing two files, where the first is the world builder file and the second is the grid file, the available options are: " << std::endl
                     << "-h or --help to get this help screen," << std::endl
-                    << "-j the number of threads the visualizer is allowed to use." << std::endl;
+                    << "-j the number of threads the visualizer is allowed to use," << std::endl
+                    << "--profile to print a table with the number of calls and time spent per feature and model," << std::endl
+                    << "--query-hints to reuse the results of the previous point for the next one and print the hit rate per feature." << std::endl;
           return 0;
         }
 
       std::vector<std::string> options_vector = get_command_line_options_vector(argc, argv);
+      options_vector.erase(std::remove(options_vector.begin(), options_vector.end(), "--profile"), options_vector.end());
+      options_vector.erase(std::remove(options_vector.begin(), options_vector.end(), "--query-hints"), options_vector.end());
 
       for (size_t i = 0; i < options_vector.size(); ++i)
         {
@@ -291,6 +297,8 @@ int main(int argc, char **argv)
   try
     {
       world = std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file));
+      world->profiler.set_enabled(profile);
+      world->query_hints.set_enabled(query_hints);
     }
   catch (std::exception &e)
     {
@@ -1393,23 +1401,28 @@ int main(int argc, char **argv)
   std::cout.flush();
 
   myfile << "    <DataArray type=\"Float32\" Name=\"Temperature\" format=\"ascii\">" << std::endl;
+  // The grid points are evaluated in chunks with the batched queries, so
+  // that the features can process the points together. The chunks are
+  // limited in size, because the batched queries copy the points of a chunk
+  // when they order them.
+  const size_t chunk_size = 65536;
+  const size_t n_chunks = (n_p + chunk_size - 1) / chunk_size;
+
   std::vector<double> temp_vector(n_p);
-  if (dim == 2)
+  {
+    const std::vector<double> gravity_vector(n_p, gravity);
+    pool.parallel_for(0, n_chunks, [&] (size_t chunk)
     {
-      pool.parallel_for(0, n_p, [&] (size_t i)
-      {
-        std::array<double,2> coords = {{grid_x[i], grid_z[i]}};
-        temp_vector[i] = world->temperature(coords, grid_depth[i], gravity);
-      });
-    }
-  else
-    {
-      pool.parallel_for(0, n_p, [&] (size_t i)
-      {
-        std::array<double,3> coords = {{grid_x[i], grid_y[i], grid_z[i]}};
-        temp_vector[i] = world->temperature(coords, grid_depth[i], gravity);
-      });
-    }
+      const size_t first = std::min(chunk * chunk_size, n_p);
+      const size_t n_chunk_points = std::min(chunk_size, n_p - first);
+      if (dim == 2)
+        world->temperatures(n_chunk_points, &grid_x[0] + first, &grid_z[0] + first,
+                            &grid_depth[0] + first, &gravity_vector[0] + first, &temp_vector[0] + first);
+      else
+        world->temperatures(n_chunk_points, &grid_x[0] + first, &grid_y[0] + first, &grid_z[0] + first,
+                            &grid_depth[0] + first, &gravity_vector[0] + first, &temp_vector[0] + first);
+    });
+  }
 
   std::cout << "[5/5] Writing the paraview file: stage 2 of 3, writing temperatures                    \r";
   std::cout.flush();
@@ -1422,38 +1435,38 @@ int main(int argc, char **argv)
   std::cout << "[5/5] Writing the paraview file: stage 3 of 3, writing compositions                     \r";
   std::cout.flush();
 
+  std::cout << "[5/5] Writing the paraview file: stage 3 of 3, computing compositions                   \r";
+  std::cout.flush();
+
+  // The value of composition c at grid point i is stored at
+  // composition_vector[i*compositions+c].
+  std::vector<double> composition_vector(n_p * compositions);
+  if (compositions > 0)
+    {
+      pool.parallel_for(0, n_chunks, [&] (size_t chunk)
+      {
+        const size_t first = std::min(chunk * chunk_size, n_p);
+        const size_t n_chunk_points = std::min(chunk_size, n_p - first);
+        if (dim == 2)
+          world->compositions(n_chunk_points, &grid_x[0] + first, &grid_z[0] + first, &grid_depth[0] + first,
+                              static_cast<unsigned int>(compositions), &composition_vector[0] + first * compositions);
+        else
+          world->compositions(n_chunk_points, &grid_x[0] + first, &grid_y[0] + first, &grid_z[0] + first,
+                              &grid_depth[0] + first, static_cast<unsigned int>(compositions),
+                              &composition_vector[0] + first * compositions);
+      });
+    }
+
   for (size_t c = 0; c < compositions; ++c)
     {
-      std::cout << "[5/5] Writing the paraview file: stage 2 of 3, computing composition "
+      std::cout << "[5/5] Writing the paraview file: stage 3 of 3, writing composition "
                 << c << " of " << compositions-1 << "            \r";
       std::cout.flush();
 
       myfile << "<DataArray type=\"Float32\" Name=\"Composition " << c << "\" Format=\"ascii\">" << std::endl;
 
-      if (dim == 2)
-        {
-          pool.parallel_for(0, n_p, [&] (size_t i)
-          {
-            std::array<double,2> coords = {{grid_x[i], grid_z[i]}};
-            temp_vector[i] =  world->composition(coords, grid_depth[i], static_cast<unsigned int>(c));
-          });
-        }
-      else
-        {
-          pool.parallel_for(0, n_p, [&] (size_t i)
-          {
-            std::array<double,3> coords = {{grid_x[i], grid_y[i], grid_z[i]}};
-            temp_vector[i] =  world->composition(coords, grid_depth[i], static_cast<unsigned int>(c));
-          });
-        }
-
-
-      std::cout << "[5/5] Writing the paraview file: stage 2 of 3, writing composition "
-                << c << " of " << compositions-1 << "            \r";
-      std::cout.flush();
-
       for (size_t i = 0; i < n_p; ++i)
-        myfile << temp_vector[i]  << std::endl;
+        myfile << composition_vector[i * compositions + c]  << std::endl;
 
       myfile << "</DataArray>" << std::endl;
     }
@@ -1468,5 +1481,11 @@ int main(int argc, char **argv)
   std::cout << "                                                                                \r";
   std::cout.flush();
 
+  if (profile)
+    std::cout << world->performance_report();
+
+  if (query_hints)
+    std::cout << world->query_hints.report();
+
   return 0;
 }